@@ -46,6 +46,7 @@
 
 #include "pawlib/flex_queue.hpp"
 #include "pawlib/iochannel.hpp"
+#include "pawlib/pool_allocator.hpp"
 #include "pawlib/singly_linked_list.hpp"
 
 template<class Type>
@@ -66,53 +67,29 @@ class AVL_Tree
             {
                 left = nullptr;
                 right = nullptr;
-                height = nullptr;
+                height = 0;
             }
         };
 
-        //a pointer to the list of nodes not currently in the tree
-        Node* notUsed;
-        //the number of nodes to make next time the list runs out
-        int nodesToMake;
+        //the pool of memory for nodes, which keeps track of nodes not currently in the tree
+        BlockPool nodePool;
         //returns a new node with the data of what is passed in
         Node* newNode(Type element)
         {
-            //temporary node used for creation/removal of a node from the list of nodes not in use
-            Node* temp;
-            //if all of the nodes are currently in use
-            if(notUsed == nullptr)
-            {
-                //loop through the number of nodes to make
-                for(int i = 0; i < nodesToMake; i++)
-                {
-                    //instantiate new nodes
-                    temp = new Node();
-                    //place them on the list of nodes not in use
-                    temp->right = notUsed;
-                    notUsed = temp;
-                }
-                //next time make twice as many nodes
-                nodesToMake *= 2;
-            }
-            //get the node on the front of the list
-            temp = notUsed;
-            //remove the node form the list
-            notUsed = notUsed->right;
-            temp->right = nullptr;
+            //construct a node in a block from the pool (the pool grows as needed)
+            Node* temp = new (nodePool.allocate()) Node();
             //set the data of the node to the correct value
             temp->data = element;
             //return the new node
             return temp;
         }
 
-        //adds the current node onto the list of nodes not in use
+        //returns the current node to the pool of nodes not in use
         void removeNode(Node* element)
         {
-            //remove the left child
-            element->left = nullptr;
-            //add the node onto the front of the list
-            element->right = notUsed;
-            notUsed = element;
+            //destroy the node and give its memory back to the pool
+            element->~Node();
+            nodePool.deallocate(element);
         }
 
         Node* root;
@@ -293,6 +270,8 @@ class AVL_Tree
                     Node* parent;
                     //get the current nodes successor
                     Node* successor = getSuccessor(curr, &parent);
+                    //the successor's own right subtree, which must stay in the tree
+                    Node* successorRight = successor->right;
                     //replace the current node with it's successor
                     successor->left = curr->left;
                     //the right child of the current node is not the current nodes successor
@@ -302,8 +281,8 @@ class AVL_Tree
 
                     //if the left child of the parent is the successor
                     if(parent->left == successor)
-                        //set the left child of the parent to be null
-                        parent->left = nullptr;
+                        //hand the successor's right subtree (if any) to the parent
+                        parent->left = successorRight;
                     //if the right child of the parent is the successor
                     else if(parent->right == successor)
                         //set the right child of the parent to be null
@@ -394,6 +373,18 @@ class AVL_Tree
             }
         }
 
+        //removes every node in the subtree, children first
+        void removeAll(Node* element)
+        {
+            if(element == nullptr)
+            {
+                return;
+            }
+            removeAll(element->left);
+            removeAll(element->right);
+            removeNode(element);
+        }
+
         //pre-order print
         void printNode(Node* temp)
         {
@@ -411,10 +402,20 @@ class AVL_Tree
 
     public :
         AVL_Tree()
+        :nodePool(sizeof(Node), 8)
         {
             root = nullptr;
-            notUsed = nullptr;
-            nodesToMake = 8;
+        }
+
+        //copying would share nodes between the trees, so use clone() instead
+        AVL_Tree(const AVL_Tree&) = delete;
+        AVL_Tree& operator=(const AVL_Tree&) = delete;
+
+        //destroys the data in every node still in the tree
+        //(the pool then releases the nodes' memory)
+        ~AVL_Tree()
+        {
+            removeAll(root);
         }
 
         //inserts the element into the tree
@@ -44,10 +44,14 @@
 #ifndef PAWLIB_CONSTANTS_HPP
 #define PAWLIB_CONSTANTS_HPP
 
+#include <cstddef>
 #include <cstdint>
 
 /** Indicates an invalid index. We actually use the largest
      * unsigned int32 for this. */
 static const uint32_t INVALID_INDEX = UINT32_MAX;
 
+/** The size of a cache line in bytes, on all the platforms we target. */
+static const size_t CACHE_LINE_SIZE = 64;
+
 #endif // PAWLIB_CONSTANTS_HPP
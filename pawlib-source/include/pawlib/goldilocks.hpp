@@ -93,6 +93,30 @@ enum class GolidlocksItemType
     suite
 };
 
+/** A small, deterministic source of pseudo-random numbers for tests, so
+ * that a failing run can be repeated exactly. Not for anything else. */
+class TestRandom
+{
+public:
+    /** Start the sequence from the given seed.
+     * \param the seed */
+    explicit TestRandom(uint32_t seed = 12345)
+    : state(seed)
+    {}
+
+    /** Get the next number in the sequence.
+     * \param the exclusive upper bound, which must be greater than zero
+     * \return a number in [0, range) */
+    size_t next(size_t range)
+    {
+        state = state * 1103515245u + 12345u;
+        return (state >> 8) % range;
+    }
+
+private:
+    uint32_t state;
+};
+
 /** All tests are derived from this base
  * class.*/
 class Test
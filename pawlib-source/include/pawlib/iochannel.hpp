@@ -125,6 +125,7 @@ These need to be swapped out for pawlib alternatives ASAP.*/
 
 #include "pawlib/onechar.hpp"
 #include "pawlib/onestring.hpp"
+#include "pawlib/onestring_view.hpp"
 
 class pure_tril;
 class tril;
@@ -598,6 +599,7 @@ class iochannel
         iochannel& operator<<(const std::string&);
         iochannel& operator<<(const onechar&);
         iochannel& operator<<(const onestring&);
+        iochannel& operator<<(const onestring_view&);
 
         inline iochannel& operator<<(const unsigned char& rhs){return resolve_integer(rhs);}
         inline iochannel& operator<<(const int& rhs){return resolve_integer(rhs);}
@@ -634,6 +636,7 @@ class iochannel
         inline iochannel& operator<<(const std::string* rhs){return resolve_pointer(rhs);}
         inline iochannel& operator<<(const onechar* rhs){return resolve_pointer(rhs);}
         inline iochannel& operator<<(const onestring* rhs){return resolve_pointer(rhs);}
+        inline iochannel& operator<<(const onestring_view* rhs){return resolve_pointer(rhs);}
 
         iochannel& operator<<(const std::exception& rhs);
 
@@ -63,11 +63,57 @@ class onechar
             * is ignored by virtually all Onechar functions. */
         static const size_t MAX_SIZE = 4;
 
-        /// The number of bytes stored.
-        size_t size;
+        /* The number of bytes in a character, by the top four bits of its
+         * first byte. A stray continuation byte counts as one. */
+        inline static constexpr unsigned char LENGTHS[16] = {
+            1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 3, 4
+        };
+
+        /* The character's bytes, followed by zeros. The size is never
+         * stored, since the first byte gives it. Every byte after the
+         * character is zero, so the whole array can be compared at once as
+         * a single 64-bit word, and the first zero is also the terminator
+         * for c_str(). */
+        alignas(uint64_t) char internal[8];
+
+        /** Get the number of bytes in the character.
+             * \return the number of bytes */
+        size_t size() const
+        {
+            return LENGTHS[static_cast<unsigned char>(this->internal[0]) >> 4];
+        }
+
+        /** Get all of the bytes as one word, for comparison.
+             * \return the bytes, as they are laid out in memory */
+        uint64_t word() const
+        {
+            uint64_t w;
+            memcpy(&w, this->internal, sizeof(w));
+            return w;
+        }
+
+        /** Get a key which orders characters first by size, and then by
+             * their bytes, as memcmp() would.
+             * \return the sort key */
+        uint64_t key() const
+        {
+            uint32_t bytes;
+            memcpy(&bytes, this->internal, sizeof(bytes));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+            bytes = __builtin_bswap32(bytes);
+#endif
+            return (static_cast<uint64_t>(size()) << 32) | bytes;
+        }
 
-        /// The character array as a c-string.
-        char internal[MAX_SIZE + 1];
+        /** Store a character from bytes, and clear the rest.
+             * \param the bytes of the character
+             * \param the number of bytes */
+        void store(const char* bytes, size_t n)
+        {
+            uint64_t w = 0;
+            memcpy(&w, bytes, n);
+            memcpy(this->internal, &w, sizeof(w));
+        }
 
         /** Store an ASCII character in this onechar
              * \param the char to copy */
@@ -120,13 +166,13 @@ class onechar
         onechar(const std::string&);
 
         /** Initialize a onechar as a copy of another. */
-        onechar(const onechar&);
+        onechar(const onechar&) = default;
 
         /** Initialize a onechar by moving another. */
-        onechar(onechar&&);
+        onechar(onechar&&) = default;
 
         /** Destructor */
-        ~onechar(){};
+        ~onechar() = default;
 
         /** Test for equality against a character
              * \param the char to test against
@@ -154,7 +200,11 @@ class onechar
         /** Test for equality against another onechar
              * \param the onechar to test against
              * \return true if equal, else false */
-        bool equals(const onechar&) const;
+        bool equals(const onechar& cmp) const
+        {
+            // Both are zero-padded, so this compares the sizes too.
+            return (word() == cmp.word());
+        }
 
         /** Returns the c-string representation of the onechar.
              * Appends a null terminator.
@@ -181,7 +231,12 @@ class onechar
         /** Compare against another onechar
              * \param the onechar to test against
              * \return 0 if equal to argument, negative if less, positive if greater */
-        int compare(const onechar&) const;
+        int compare(const onechar& cmp) const
+        {
+            uint64_t lhs = key();
+            uint64_t rhs = cmp.key();
+            return (lhs > rhs) - (lhs < rhs);
+        }
 
         /** Evaluate the number of bytes in a Unicode character.
              * Ignores all subsequent characters.
@@ -189,32 +244,7 @@ class onechar
              * \return the number of bytes in the Unicode character */
         static size_t evaluateLength(const char* cstr)
         {
-            switch (cstr[0] & 0xF0)
-            {
-                case 0xF0:
-                {
-                    // Unicode code points U+10000 to U+10FFFF
-                    return 4;
-                }
-                case 0xE0:
-                {
-                    // Unicode code points U+0800 to U+FFFF
-                    return 3;
-                }
-                case 0xD0:
-                case 0xC0:
-                {
-                    // Unicode code points U+0080 to U+07FF
-                    return 2;
-                }
-                default:
-                {
-                    // Unicode code points U+0000 to U+007F
-                    return 1;
-                }
-            }
-            // Can't happen
-            return 0;
+            return LENGTHS[static_cast<unsigned char>(cstr[0]) >> 4];
         }
 
         // Assignment Operators
@@ -237,9 +267,9 @@ class onechar
             return *this;
         }
 
-        onechar& operator=(const onechar&);
+        onechar& operator=(const onechar&) = default;
 
-        onechar& operator=(onechar&&);
+        onechar& operator=(onechar&&) = default;
 
         // Comparison Operators
 
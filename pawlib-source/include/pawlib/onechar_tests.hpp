@@ -42,6 +42,11 @@
 #ifndef PAWLIB_ONECHAR_TESTS_HPP
 #define PAWLIB_ONECHAR_TESTS_HPP
 
+#include <algorithm>
+#include <string>
+#include <type_traits>
+#include <vector>
+
 #include "pawlib/goldilocks.hpp"
 #include "pawlib/onestring.hpp"
 #include "pawlib/iochannel.hpp"
@@ -937,6 +942,138 @@ class TestOnechar_OpGreaterEqual : public TestOnechar
         }
 };
 
+// P-tB4112
+class TestOnechar_Packed : public Test
+{
+    public:
+        TestOnechar_Packed(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onechar: Packed";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test that onechars are small, trivially copyable, and ordered by size, then by bytes.";
+        }
+
+        bool run() override
+        {
+            PL_ASSERT_EQUAL(sizeof(onechar), 8u);
+            PL_ASSERT_TRUE(std::is_trivially_copyable<onechar>::value);
+
+            // Each character is smaller than the next.
+            const char* ordered[8] = {"\0", "A", "z", "©", "ߺ", "‽", "￿", "🐭"};
+            for (size_t i = 0; i < 8; ++i)
+            {
+                onechar lhs(ordered[i]);
+                PL_ASSERT_EQUAL(lhs.compare(lhs), 0);
+                for (size_t j = i + 1; j < 8; ++j)
+                {
+                    onechar rhs(ordered[j]);
+                    PL_ASSERT_TRUE(lhs < rhs);
+                    PL_ASSERT_TRUE(rhs > lhs);
+                    PL_ASSERT_TRUE(lhs != rhs);
+                    PL_ASSERT_TRUE(lhs.compare(ordered[j]) < 0);
+                }
+            }
+
+            // Parsing only takes the first character, and copies are equal.
+            onechar mouse("🐭🐉");
+            onechar copy = mouse;
+            PL_ASSERT_EQUAL(copy, "🐭");
+            PL_ASSERT_TRUE(copy == mouse);
+
+            // Reassigning a shorter character clears the old bytes.
+            copy = 'M';
+            PL_ASSERT_EQUAL(copy, 'M');
+            PL_ASSERT_EQUAL(copy, "M");
+            PL_ASSERT_TRUE(copy == onechar("M"));
+
+            // A lone byte above 0x7F isn't a character; it becomes U+FFFD.
+            onechar stray('\xE2');
+            PL_ASSERT_EQUAL(stray, "\xEF\xBF\xBD");
+            return true;
+        }
+};
+
+// P-tB4113*
+class TestStdString_SortChars : public Test
+{
+    protected:
+        std::vector<std::string> chars;
+
+    public:
+        TestStdString_SortChars(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onechar: Sort (std::string)";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Sort ten thousand characters, each stored as a std::string.";
+        }
+
+        bool pre() override
+        {
+            const char* pattern[4] = {"a", "é", "⛰", "🐉"};
+            TestRandom random;
+            for (int i = 0; i < 10000; ++i)
+            {
+                chars.push_back(pattern[random.next(4)]);
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            std::vector<std::string> sorted = chars;
+            std::sort(sorted.begin(), sorted.end());
+            return true;
+        }
+};
+
+// P-tB4113
+class TestOnechar_Sort : public Test
+{
+    protected:
+        std::vector<onechar> chars;
+
+    public:
+        TestOnechar_Sort(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onechar: Sort";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Sort ten thousand characters, each stored as a onechar.";
+        }
+
+        bool pre() override
+        {
+            const char* pattern[4] = {"a", "é", "⛰", "🐉"};
+            TestRandom random;
+            for (int i = 0; i < 10000; ++i)
+            {
+                chars.push_back(onechar(pattern[random.next(4)]));
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            std::vector<onechar> sorted = chars;
+            std::sort(sorted.begin(), sorted.end());
+            return true;
+        }
+};
+
 class TestSuite_Onechar : public TestSuite
 {
     public:
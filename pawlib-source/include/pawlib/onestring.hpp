@@ -4,8 +4,9 @@
   * Onestring is a multi-sized, Unicode-compatible (UTF-8) replacement for
   * std::string. Onestring contains all the functionality found in std::string,
   * and then some! It is fully compatible with c-strings, std::string, and the
-  * atomic char data type. To handle Unicode, each Onestring is composed of
-  * Onechars, an enhanced UTF-8 character class.
+  * atomic char data type. Onestring stores its text as contiguous UTF-8, and
+  * provides access to individual characters as Onechars, an enhanced UTF-8
+  * character class.
   *
   * Author(s): Jason C. McDonald, Scott Taylor, Jarek Thomas, Bowen Volwiler
   */
@@ -50,18 +51,56 @@
 
 #include <algorithm>
 #include <cctype> // isspace()
+#include <charconv> // std::to_chars()
+#include <cstdint>
 #include <cstring>
+#include <functional> // std::hash
 #include <iomanip>
 #include <iostream>
 #include <istream>
+#include <memory_resource>
+#include <string>
+#include <type_traits>
+#include <utility>
 
 #include "pawlib/onechar.hpp"
+#include "pawlib/onestring_view.hpp"
+
+/* Format strings are always checked at compile time. Where consteval is
+ * supported (C++20), a string literal can be passed to format() as is.
+ * Otherwise, it must be wrapped in PAWLIB_FORMAT(), or be a constexpr
+ * onestring::format_string. */
+#if defined(__cpp_consteval)
+#define PAWLIB_FORMAT_CHECK consteval
+#else
+#define PAWLIB_FORMAT_CHECK constexpr
+#endif
+
+/** Check a format string literal for onestring::format() at compile time.
+ * Its fields are counted while compiling, and format() refuses to compile
+ * if the count doesn't match the number of values given.
+ * \param the format string literal */
+#define PAWLIB_FORMAT(fmt)                                                   \
+    ([]() {                                                                  \
+        static_assert(onestring::count_fields(fmt, sizeof(fmt) - 1) !=       \
+                      onestring::npos,                                       \
+                      "Onestring::format(): format string has an unmatched brace"); \
+        constexpr onestring::format_string<                                  \
+            onestring::count_fields(fmt, sizeof(fmt) - 1)> checked(fmt);     \
+        return checked;                                                      \
+    }())
 
 class onestring
 {
+    friend onestring_view;
+    friend onestring_reader;
+    friend onestring_rope;
+    friend onestring_tokenizer;
+
     public:
-        /// The default size the onestring is initialized at
-        inline static const size_t BASE_SIZE = 4;
+        /** The default capacity of a onestring in bytes. Text up to this
+         * size is stored inline, with no heap allocation. */
+        inline static const size_t BASE_SIZE = 22;
 
         /// The greatest possible value for an element.
         inline static const size_t npos = -1;
@@ -69,20 +108,107 @@ class onestring
         /// The factor the capacity is multiplied by to resize
         inline static const float RESIZE_FACTOR = 1.5;
 
+        /** A reference to a single character in a onestring.
+         * Characters in a onestring are stored as UTF-8, not as onechars,
+         * so this stands in for a onechar&. It converts to a onechar, and
+         * assigning to it replaces the character in the onestring. */
+        class reference
+        {
+            friend onestring;
+            private:
+                /// The onestring the character belongs to.
+                onestring* ostr;
+                /// The index of the character in the onestring.
+                size_t pos;
+
+                reference(onestring* owner, size_t index)
+                :ostr(owner), pos(index)
+                {}
+
+            public:
+                reference(const reference&) = default;
+
+                /** Get a copy of the referenced character.
+                 * \return the character as a onechar */
+                // cppcheck-suppress noExplicitConstructor
+                operator onechar() const
+                {
+                    return static_cast<const onestring*>(ostr)->at(pos);
+                }
+
+                reference& operator=(char ch) { ostr->replace(pos, 1, ch); return *this; }
+                reference& operator=(const char* cstr) { ostr->replace(pos, 1, onechar(cstr)); return *this; }
+                reference& operator=(const std::string& str) { ostr->replace(pos, 1, onechar(str)); return *this; }
+                reference& operator=(const onechar& ochr) { ostr->replace(pos, 1, ochr); return *this; }
+                reference& operator=(const reference& ref) { ostr->replace(pos, 1, onechar(ref)); return *this; }
+
+                template<typename T>
+                bool operator==(const T& cmp) const { return (onechar(*this) == cmp); }
+                template<typename T>
+                bool operator!=(const T& cmp) const { return (onechar(*this) != cmp); }
+                template<typename T>
+                bool operator<(const T& cmp) const { return (onechar(*this) < cmp); }
+                template<typename T>
+                bool operator<=(const T& cmp) const { return (onechar(*this) <= cmp); }
+                template<typename T>
+                bool operator>(const T& cmp) const { return (onechar(*this) > cmp); }
+                template<typename T>
+                bool operator>=(const T& cmp) const { return (onechar(*this) >= cmp); }
+
+                friend std::ostream& operator<<(std::ostream& os, const reference& ref)
+                {
+                    os << onechar(ref);
+                    return os;
+                }
+        };
+
     private:
         inline static const float RESIZE_LIMIT = npos / RESIZE_FACTOR;
 
-        /// The maximum number of elements that can be stored without resize
+        /// The number of characters between entries in the character index.
+        inline static const size_t INDEX_STRIDE = 32;
+
+        /** The UTF-8 text, which is always followed by a null terminator.
+         * Points to _local until the text outgrows it. */
+        char* _bytes;
+
+        /// The inline storage for short strings.
+        char _local[BASE_SIZE + 1];
+
+        /// The number of bytes currently stored, not counting the terminator.
+        size_t _size;
+
+        /** The maximum number of bytes that can be stored without resize,
+         * not counting the terminator. */
         size_t _capacity;
 
-        /// The number of elements currently stored
+        /// The number of Unicode characters currently stored
         size_t _elements;
 
-        /// The array of onechars
-        onechar* internal;
+        /** The sparse character index, which is built as needed.
+         * Entry n is the byte offset of character (n * INDEX_STRIDE).
+         * It is never needed for ASCII-only strings. */
+        mutable size_t* _index;
 
-        /// The cached c-string. We store this pointer to ensure it is cleaned up properly.
-        mutable char* _c_str;
+        /// The number of entries allocated in the character index.
+        mutable size_t _index_capacity;
+
+        /// The number of entries at the start of the index that are valid.
+        mutable size_t _indexed;
+
+        /// The index of the most recently located character.
+        mutable size_t _cursor_pos;
+
+        /// The byte offset of the most recently located character.
+        mutable size_t _cursor_off;
+
+        /** The hash of the text with the default seed, or 0 if it hasn't
+         * been calculated since the text last changed. */
+        mutable size_t _hash;
+
+        /** Where the text and index are allocated from, or nullptr for
+         * the heap. */
+        std::pmr::memory_resource* _resource;
 
     public:
         /*******************************************
@@ -106,6 +232,28 @@ class onestring
         * \param the onestring to be copied */
         onestring(const onestring& str);
 
+        /**Create a onestring by taking the contents of another onestring,
+        * which is left empty.
+        * \param the onestring to be moved */
+        onestring(onestring&& str) noexcept
+        :_bytes(_local), _size(0), _capacity(BASE_SIZE), _elements(0), _index(nullptr),
+         _index_capacity(0), _indexed(0), _cursor_pos(0), _cursor_off(0), _hash(0),
+         _resource(str._resource)
+        {
+            steal(str);
+        }
+
+        /**Create a onestring by copying the text in a onestring_view
+        * \param the view to be copied */
+        explicit onestring(const onestring_view& view);
+
+        /**Create an empty onestring which allocates from a memory resource,
+        * such as a std::pmr::monotonic_buffer_resource, instead of the heap.
+        * The resource must outlive the onestring. Copies of the onestring
+        * use the heap; moves keep the resource.
+        * \param the memory resource, or nullptr for the heap */
+        explicit onestring(std::pmr::memory_resource* resource);
+
         /**Create a onestring from a char
          *  \param the char to be added */
         // cppcheck-suppress noExplicitConstructor
@@ -124,52 +272,592 @@ class onestring
         ********************************************/
 
     private:
-        /** Allocates the requested space exactly.
+        /** Check whether the text is stored inline.
+             * \return true if using the inline storage, else false */
+        bool is_local() const { return this->_bytes == this->_local; }
+
+        /** Get memory for text or the index, from the memory resource if
+             * there is one, or else from the heap.
+             * \param the number of elements
+             * \return the memory */
+        template<typename T>
+        T* obtain(size_t count) const
+        {
+            if (this->_resource == nullptr) { return new T[count]; }
+            return static_cast<T*>(this->_resource->allocate(sizeof(T) * count, alignof(T)));
+        }
+
+        /** Give back memory from obtain().
+             * \param the memory
+             * \param the number of elements it was obtained with */
+        template<typename T>
+        void release(T* ptr, size_t count) const
+        {
+            if (this->_resource == nullptr)
+            {
+                delete[] ptr;
+            }
+            else
+            {
+                this->_resource->deallocate(ptr, sizeof(T) * count, alignof(T));
+            }
+        }
+
+        /** Allocates the requested space exactly, or switches to the
+             * inline storage if the space fits within BASE_SIZE.
              * This is the primary function responsible for allocation.
-             * \param the number of elements to allocate space for */
+             * WARNING: Does not truncate the contents. The caller must
+             * ensure the capacity is at least the current size.
+             * \param the number of bytes to allocate space for, not
+             * counting the null terminator */
         void allocate(size_t capacity);
 
-        /** Shifts the contents of the onestring efficiently.
-             * WARNING: Does not check for validity of shift, nor perform
-             * expansions or shrinks. That is the responsibility of the caller.
-             * \param the first index to shift
-             * \param how much to shift by, and in what direction.
-             * Negative values shift back, positive shift forward. */
-        void shift(size_t fromIndex, int offset);
+        /** Find the byte offset of a character.
+             * WARNING: Does not check that the index is in range.
+             * \param the index of the character, or the length of the
+             * string to find the end
+             * \return the offset of the character's first byte */
+        size_t offset_of(size_t pos) const;
+
+        /** Extend the character index so it includes the given entry.
+             * \param the index entry needed */
+        void build_index(size_t entry) const;
+
+        /** Find a set bit in a mask.
+             * WARNING: The mask must have more than k bits set.
+             * \param the mask
+             * \param the number of set bits to skip
+             * \return the position of the set bit */
+        static unsigned int select_bit(uint32_t mask, unsigned int k);
+
+        /** Discard the parts of the character index that may be affected
+             * by a change to the string at the given character.
+             * \param the index of the first character changed */
+        void invalidate_index(size_t pos);
+
+        /** Correct the character index after characters were replaced by
+             * the same number of characters, of a different size in bytes.
+             * \param the index of the first character replaced
+             * \param the number of characters replaced
+             * \param the byte offset of the first character replaced
+             * \param the number of bytes in the new characters
+             * \param the number of bytes in the old characters */
+        void shift_index(size_t pos, size_t len, size_t start, size_t n, size_t was);
+
+        /** Replace a range of characters with UTF-8 text, in one pass.
+             * This is the basis of all insertion, erasure, and replacement.
+             * WARNING: Does not validate pos or len! That MUST be done
+             * by the caller.
+             * \param the index of the first character to replace
+             * \param the number of characters to replace
+             * \param the UTF-8 text to replace them with
+             * \param the number of bytes in the text
+             * \param the number of characters in the text */
+        void splice(size_t pos, size_t len, const char* bytes, size_t n, size_t chars);
+
+        /** Find the character index of a byte offset.
+             * WARNING: Does not check that the offset is in range, or that it
+             * is at the start of a character.
+             * \param the byte offset
+             * \return the index of the character starting at that offset */
+        size_t index_of(size_t offset) const;
+
+        /** The bytewise implementation of find().
+             * \param the UTF-8 text to search for
+             * \param the number of bytes in the text
+             * \param the index of the first character to search from
+             * \return the index of the match, or npos */
+        size_t find_bytes(const char* needle, size_t n, size_t pos) const;
+
+        /** The bytewise implementation of rfind().
+             * \param the UTF-8 text to search for
+             * \param the number of bytes in the text
+             * \param the index of the last character a match may start at
+             * \return the index of the match, or npos */
+        size_t rfind_bytes(const char* needle, size_t n, size_t pos) const;
+
+        /** The implementation of find_first_of() and find_first_not_of().
+             * \param the UTF-8 set of characters
+             * \param the number of bytes in the set
+             * \param the index of the first character to search from
+             * \param true to find a character in the set, false to find
+             * one not in the set
+             * \return the index of the character found, or npos */
+        size_t find_of(const char* set, size_t n, size_t pos, bool match) const;
+
+        /** The implementation of find_last_of() and find_last_not_of().
+             * \param the UTF-8 set of characters
+             * \param the number of bytes in the set
+             * \param the index of the last character to search from
+             * \param true to find a character in the set, false to find
+             * one not in the set
+             * \return the index of the character found, or npos */
+        size_t rfind_of(const char* set, size_t n, size_t pos, bool match) const;
+
+        /** The bytewise implementation of count().
+             * \param the UTF-8 text to search for
+             * \param the number of bytes in the text
+             * \return the number of non-overlapping occurrences */
+        size_t count_bytes(const char* needle, size_t n) const;
+
+        /** Count the characters in a run of valid UTF-8 text by counting
+             * the bytes that start a character. Vectorized where SSE2 is
+             * available.
+             * \param the UTF-8 text
+             * \param the number of bytes in the text
+             * \return the character count */
+        static size_t count_leads(const char* bytes, size_t n);
+
+        /** Find the byte offset of a character in a run of valid UTF-8
+             * text, by counting the bytes that start a character. Vectorized
+             * where SSE2 is available.
+             * \param the UTF-8 text
+             * \param the number of bytes in the text
+             * \param the index of the character to find
+             * \return the offset of the character, or n if there are not
+             * that many characters */
+        static size_t advance(const char* bytes, size_t n, size_t pos);
+
+        /** Find the first occurrence of a run of bytes in another.
+             * Vectorized where SSE2 is available.
+             * \param the bytes to search
+             * \param the number of bytes to search
+             * \param the bytes to search for
+             * \param the number of bytes to search for; must not be 0
+             * \return a pointer to the match, or nullptr */
+        static const char* search(const char* hay, size_t hay_n, const char* needle, size_t n);
+
+        /** Find the last occurrence of a run of bytes in another.
+             * Vectorized where SSE2 is available.
+             * \param the bytes to search
+             * \param the number of bytes to search
+             * \param the bytes to search for
+             * \param the number of bytes to search for; must not be 0
+             * \return a pointer to the match, or nullptr */
+        static const char* rsearch(const char* hay, size_t hay_n, const char* needle, size_t n);
+
+        /** Check whether a character is one of a set of characters.
+             * \param the UTF-8 set of characters
+             * \param the number of bytes in the set
+             * \param the character to look for
+             * \param the number of bytes in the character
+             * \return true if the character is in the set, else false */
+        static bool in_set(const char* set, size_t n, const char* ch, size_t len);
+
+        /** Multiply two 64-bit values, and fold the 128-bit product back
+             * into 64 bits. This is the core mixing step of the hash.
+             * \param the first value
+             * \param the second value
+             * \return the folded product */
+        static uint64_t fold(uint64_t a, uint64_t b)
+        {
+#ifdef __SIZEOF_INT128__
+            __uint128_t product = static_cast<__uint128_t>(a) * b;
+            return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#else
+            // Without 128-bit integers, add up the products of the 32-bit halves.
+            const uint64_t lo_lo = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+            const uint64_t hi_lo = (a >> 32) * (b & 0xFFFFFFFF);
+            const uint64_t lo_hi = (a & 0xFFFFFFFF) * (b >> 32);
+            const uint64_t hi_hi = (a >> 32) * (b >> 32);
+            // The sum can't overflow, since lo_hi is at most (2^32 - 1)^2.
+            const uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+            const uint64_t upper = hi_hi + (hi_lo >> 32) + (cross >> 32);
+            const uint64_t lower = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+            return lower ^ upper;
+#endif
+        }
+
+        /** Hash a run of bytes. Each 32-byte stripe is mixed into four
+             * 64-bit lanes, two at a time with SSE2 where available; the
+             * result is the same either way.
+             * \param the bytes to hash
+             * \param the number of bytes
+             * \param the seed
+             * \return the hash */
+        static size_t hash_bytes(const char* bytes, size_t n, size_t seed);
+
+        /** Copy the text of another onestring, then empty it, for when
+             * the two use different memory resources.
+             * \param the onestring to take from; must not be this one */
+        void take_copy(onestring& ostr);
+
+        /** Take the contents of another onestring, leaving it empty.
+             * Anything this onestring held is released first. If the two
+             * use different memory resources, the text is copied instead.
+             * \param the onestring to take from; must not be this one
+             * Inline, since sorting and other moves spend most of their time
+             * here. */
+        void steal(onestring& ostr)
+        {
+            // Memory can't change hands between resources.
+            if (this->_resource != ostr._resource)
+            {
+                take_copy(ostr);
+                return;
+            }
+
+            // Release anything we're already holding.
+            if (!is_local())
+            {
+                release(this->_bytes, this->_capacity + 1);
+            }
+            if (this->_index != nullptr)
+            {
+                release(this->_index, this->_index_capacity);
+            }
+
+            /* Inline text has to be copied, but heap text can just be taken.
+             * Copying all of the inline storage is cheaper than measuring
+             * how much of it is in use. */
+            memcpy(this->_local, ostr._local, sizeof(this->_local));
+            this->_bytes = ostr.is_local() ? this->_local : ostr._bytes;
+
+            this->_size = ostr._size;
+            this->_capacity = ostr._capacity;
+            this->_elements = ostr._elements;
+            this->_index = ostr._index;
+            this->_index_capacity = ostr._index_capacity;
+            this->_indexed = ostr._indexed;
+            this->_cursor_pos = ostr._cursor_pos;
+            this->_cursor_off = ostr._cursor_off;
+            this->_hash = ostr._hash;
+
+            // Leave the other string empty, but still usable.
+            ostr._bytes = ostr._local;
+            ostr._local[0] = '\0';
+            ostr._size = 0;
+            ostr._capacity = BASE_SIZE;
+            ostr._elements = 0;
+            ostr._index = nullptr;
+            ostr._index_capacity = 0;
+            ostr._indexed = 0;
+            ostr._cursor_pos = 0;
+            ostr._cursor_off = 0;
+            ostr._hash = 0;
+        }
+
+        /** Check the UTF-8 sequence at the start of some text.
+             * \param the UTF-8 text
+             * \param the number of bytes left in the text
+             * \return the number of bytes in the sequence, or 0 if it is
+             * invalid, overlong, a surrogate, or cut off */
+        static size_t sequence_length(const char* bytes, size_t n);
+
+        /** Validate UTF-8 text and count its characters in one pass.
+             * Runs of ASCII are checked 16 bytes at once with SSE2, or 32
+             * with AVX2, where available.
+             * \param the UTF-8 text
+             * \param the number of bytes in the text
+             * \param [out] the number of characters, counting each invalid
+             * byte as one character
+             * \return the offset of the first invalid byte, or npos */
+        static size_t scan(const char* bytes, size_t n, size_t& chars);
+
+        /** Validate UTF-8 text from outside the onestring. If it isn't
+             * valid, it is copied with each invalid byte replaced by U+FFFD,
+             * and the text pointer and size are updated to the copy.
+             * \param [in,out] the UTF-8 text
+             * \param [in,out] the number of bytes in the text
+             * \param storage for the repaired copy, if it is needed
+             * \return the number of characters */
+        static size_t validated(const char*& bytes, size_t& n, std::string& repaired);
+
+        /** Replace a range of characters with UTF-8 text from outside the
+             * onestring, validating it first. See splice() and validated().
+             * \param the index of the first character to replace
+             * \param the number of characters to replace
+             * \param the UTF-8 text to replace them with
+             * \param the number of bytes in the text */
+        void splice_text(size_t pos, size_t len, const char* bytes, size_t n);
+
+        /** Check whether UTF-8 text starts with the given bytes, which
+             * must end on a character boundary in the text.
+             * \param the text, which must be valid UTF-8
+             * \param the number of bytes in the text
+             * \param the bytes to look for
+             * \param the number of bytes to look for
+             * \return true if the text starts with the bytes */
+        static bool has_prefix(const char* bytes, size_t n, const char* prefix, size_t len)
+        {
+            return (len <= n && memcmp(bytes, prefix, len) == 0 &&
+                    (len == n || (bytes[len] & 0xC0) != 0x80));
+        }
+
+        /** Check whether UTF-8 text ends with the given bytes, which must
+             * start on a character boundary in the text.
+             * \param the text, which must be valid UTF-8
+             * \param the number of bytes in the text
+             * \param the bytes to look for
+             * \param the number of bytes to look for
+             * \return true if the text ends with the bytes */
+        static bool has_suffix(const char* bytes, size_t n, const char* suffix, size_t len)
+        {
+            return (len <= n && memcmp(bytes + n - len, suffix, len) == 0 &&
+                    (len == n || (bytes[n - len] & 0xC0) != 0x80));
+        }
+
+        /** One piece of text to be written by concat() or append_all(),
+         * with its size and length worked out ahead of time. Numbers are
+         * formatted into the piece itself, so pieces are never copied. */
+        struct piece
+        {
+            // Storage for repaired text, and for formatted numbers.
+            std::string repaired;
+            char buffer[48];
+
+            const char* bytes;
+            size_t n;
+            size_t chars;
+
+            explicit piece(char ch)
+            :bytes(buffer), n(1), chars(1)
+            {
+                buffer[0] = ch;
+                // A lone byte above 0x7F becomes U+FFFD, as in append().
+                if (static_cast<unsigned char>(ch) >= 0x80)
+                {
+                    chars = validated(bytes, n, repaired);
+                }
+            }
+
+            explicit piece(const onechar& ochr)
+            :bytes(ochr.internal), n(ochr.size()), chars(1)
+            {}
+
+            explicit piece(const char* cstr)
+            :bytes(cstr), n(strlen(cstr)), chars(validated(bytes, n, repaired))
+            {}
+
+            explicit piece(const std::string& str)
+            :bytes(str.data()), n(str.size()), chars(validated(bytes, n, repaired))
+            {}
+
+            explicit piece(const onestring& ostr)
+            :bytes(ostr._bytes), n(ostr._size), chars(ostr._elements)
+            {}
+
+            explicit piece(const onestring_view& view)
+            :bytes(view.data()), n(view.size()), chars(view.length())
+            {}
+
+            explicit piece(bool value)
+            :bytes(value ? "true" : "false"), n(value ? 4 : 5), chars(n)
+            {}
+
+            /* Integers are written in decimal, and floating point numbers in
+             * the shortest form that reads back as the same value. */
+            template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+            explicit piece(T value)
+            :bytes(buffer), n(0), chars(0)
+            {
+                n = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr - buffer;
+                chars = n;
+            }
+
+            piece(const piece&) = delete;
+            piece& operator=(const piece&) = delete;
+        };
+
+        /** Decode one valid UTF-8 character.
+             * \param the first byte of the character
+             * \param the number of bytes in the character
+             * \return the code point */
+        static char32_t decode(const char* bytes, size_t len);
+
+        /** Encode a code point as UTF-8.
+             * \param the code point, which must be valid
+             * \param [out] where to write the bytes; room for 4 is needed
+             * \return the number of bytes written */
+        static size_t encode(char32_t cp, char* out);
+
+        /** Read one code point from UTF-16, replacing a lone surrogate
+             * with U+FFFD.
+             * \param the UTF-16 code units
+             * \param the number of code units
+             * \param [in,out] the index of the next unit, moved past it
+             * \return the code point */
+        static char32_t read_unit(const char16_t* units, size_t n, size_t& i);
+
+        /** Read one code point from UTF-32, replacing a surrogate or
+             * anything past U+10FFFF with U+FFFD.
+             * \param the UTF-32 code units
+             * \param the number of code units
+             * \param [in,out] the index of the next unit, moved past it
+             * \return the code point */
+        static char32_t read_unit(const char32_t* units, size_t n, size_t& i);
+
+        /** Check whether the next 16 code units are all ASCII, and if so,
+             * narrow them into bytes. Vectorized where SSE2 is available.
+             * \param the first of 16 code units
+             * \param [out] where to write 16 bytes
+             * \return true if all 16 were ASCII and were written */
+        static bool narrow_ascii(const char16_t* units, char* out);
+        static bool narrow_ascii(const char32_t* units, char* out);
+
+        /** The ways text can be mapped between cases. Folding maps to
+         * lowercase by way of uppercase, so that characters like "ς" and
+         * "σ", which share an uppercase, fold to the same thing. */
+        enum class casing
+        {
+            lower,
+            upper,
+            fold
+        };
+
+        /** Get the table of case mappings for U+0080 to U+07FF, as the
+             * difference between each code point and the one it maps to.
+             * \param the mapping to get
+             * \return the table, built on first use */
+        static const int16_t* case_deltas(casing mode);
+
+        /** Map one code point to another case. Only mappings which keep
+             * the same length in UTF-8 are made, so mapping never moves a
+             * character.
+             * \param the code point
+             * \param the mapping to apply
+             * \return the mapped code point, or the same one if it has none */
+        static char32_t map_point(char32_t cp, casing mode);
+
+        /** Map one UTF-8 character to another case. The output is always
+             * the same length as the input, and may be the same buffer.
+             * \param the character
+             * \param the number of bytes left in the text
+             * \param [out] where to write the mapped character
+             * \param the mapping to apply
+             * \return the length of the character, in bytes */
+        static size_t map_char(const char* in, size_t n, char* out, casing mode);
+
+        /** Map the next 16 bytes to another case, if they are all ASCII.
+             * Vectorized where SSE2 is available.
+             * \param the first of 16 bytes
+             * \param [out] where to write 16 bytes
+             * \param the mapping to apply
+             * \return true if all 16 were ASCII and were written */
+        static bool map_ascii(const char* in, char* out, casing mode);
+
+        /** Map UTF-8 text to another case. The output is always the same
+             * length as the input, and may be the same buffer.
+             * \param the bytes to map
+             * \param the number of bytes
+             * \param [out] where to write the mapped bytes
+             * \param the mapping to apply */
+        static void map_case(const char* in, size_t n, char* out, casing mode);
+
+        /** Compare two UTF-8 sequences bytewise, as if both were folded.
+             * \param the first sequence
+             * \param the number of bytes in the first sequence
+             * \param the second sequence
+             * \param the number of bytes in the second sequence
+             * \return negative, zero, or positive, as with memcmp() */
+        static int fold_compare(const char* a, size_t an, const char* b, size_t bn);
+
+        /** Copy text into a new onestring, mapped to another case.
+             * \param the text to map
+             * \param the mapping to apply
+             * \return the new onestring */
+        static onestring mapped(const onestring_view& view, casing mode);
+
+        /** Create a onestring from UTF-16 or UTF-32, measuring the result
+             * first so it is allocated exactly once.
+             * \param the code units
+             * \param the number of code units
+             * \return the new onestring */
+        template<typename Unit>
+        static onestring from_units(const Unit* units, size_t n);
+
+        /** Write a format string to the empty onestring, with each field
+             * replaced by the next value, allocating once for the result.
+             * \param the format string, which has already been checked
+             * \param the number of bytes in the format string
+             * \param the values for the fields
+             * \param the number of values */
+        void format_pieces(const char* fmt, size_t n, const piece* values, size_t count);
+
+        /** Write pieces of text to the end of the onestring, reserving
+             * space for all of them at once.
+             * \param the pieces
+             * \param the number of pieces */
+        void append_pieces(const piece* parts, size_t count);
 
     public:
 
         /** Requests that the string capacity be expanded to accomidate
-         * the given number of additional characters.
-         * `s.expand(n)` is equivalent to `s.reserve(s.length() + n)`
-         * \param the number of additional elements to reserve space for */
+         * the given number of additional bytes.
+         * `s.expand(n)` is equivalent to `s.reserve(s.size() - 1 + n)`
+         * \param the number of additional bytes to reserve space for */
         void expand(size_t expansion);
 
         /** Requests that the string capacity be expanded to accomidate
-         * the given number of characters.
-         * \param the number of elements to reserve space for */
+         * the given number of bytes. For ASCII text, this is the same as
+         * the number of characters.
+         * \param the number of bytes to reserve space for */
         void reserve(size_t elements);
 
+        /** Truncates the string to the given number of characters, and
+             * reallocates to exactly that capacity (or to the size of the
+             * remaining text, if it contains multi-byte characters).
+             * The capacity is never less than BASE_SIZE.
+             * \param the number of characters */
         void resize(size_t elements);
+
+        /** Truncates or pads the string to the given number of characters,
+             * reallocating to exactly fit.
+             * \param the number of characters
+             * \param the character to pad with */
         void resize(size_t elements, const onechar& ch);
 
+        /** Reallocates to exactly fit the current text, or moves it back
+             * into the inline storage if it fits within BASE_SIZE. */
         void shrink_to_fit();
 
-        /** Evaluate the number of Unicode characters in a c-string
+        /** Get the memory resource the onestring allocates from.
+             * \return the memory resource, or nullptr for the heap */
+        std::pmr::memory_resource* resource() const { return this->_resource; }
+
+        /** Evaluate the number of Unicode characters in a c-string.
+             * Each invalid byte counts as one character, as it would be
+             * replaced by U+FFFD in a onestring.
              * \param the c-string to evaluate
              * \return the character count */
-        static size_t characterCount(const char* cstr)
+        static size_t characterCount(const char* cstr);
+
+        /** Check whether text is valid UTF-8. Overlong forms, surrogates,
+             * code points past U+10FFFF, and cut-off sequences are invalid.
+             * Text given to a onestring is always checked, and any invalid
+             * bytes are replaced with U+FFFD.
+             * \param the text to check
+             * \param the number of bytes in the text
+             * \return the offset of the first invalid byte, or npos if the
+             * text is valid */
+        static size_t validate(const char* bytes, size_t n);
+
+        /** Gets the hash of the onestring. This is calculated the first
+             * time it is needed, and kept until the onestring is changed.
+             * \return the hash */
+        size_t hash() const
         {
-            size_t index = 0;
-            size_t count = 0;
-            while (cstr[index] != '\0')
-            {
-                index += onechar::evaluateLength(cstr + index);
-                ++count;
-            }
-            return count;
+            if (this->_hash == 0) { this->_hash = hash_bytes(this->_bytes, this->_size, 0); }
+            return this->_hash;
         }
 
+        /** Gets the hash of the onestring with a particular seed.
+             * Hashes with a seed other than 0 are never kept.
+             * \param the seed; a onestring with the same text and seed always
+             * has the same hash, but different seeds give unrelated hashes
+             * \return the hash */
+        size_t hash(size_t seed) const
+        {
+            return (seed == 0) ? hash() : hash_bytes(this->_bytes, this->_size, seed);
+        }
+
+        /** Check whether a std::string is valid UTF-8.
+             * See validate(const char*, size_t).
+             * \param the string to check
+             * \return the offset of the first invalid byte, or npos if the
+             * string is valid */
+        static size_t validate(const std::string& str) { return validate(str.data(), str.size()); }
+
         /*******************************************
         * Accessors
         *******************************************/
@@ -177,20 +865,20 @@ class onestring
         /** Gets the onechar at a given position
              * \param the index of the onechar to return
              * \return a reference to the corresponding onechar */
-        onechar& at(size_t pos);
-        const onechar& at(size_t pos) const;
+        reference at(size_t pos);
+        onechar at(size_t pos) const;
 
         /** Gets the last onechar in the string.
-             * If the string is empty, this has undefined behavior
-             * (although it is guaranteed memory safe.)
+             * If the string is empty, this has undefined behavior.
              * \return a reference to the last onechar in the string.
              */
-        onechar& back();
-        const onechar& back() const;
+        reference back();
+        onechar back() const;
 
-        /** Gets the current capacity of the onestring.
+        /** Gets the current capacity of the onestring in bytes,
+             * not counting the null terminator.
              * Used primarily internally for resizing purposes.
-             * \return the size of the onestring */
+             * \return the capacity of the onestring */
         size_t capacity() const;
 
         /** Copies a substring from the onestring to the given c-string.
@@ -206,13 +894,16 @@ class onestring
              * \return the number of char elements copied to the array*/
         size_t copy(char* arr, size_t max, size_t len = 0, size_t pos = 0) const;
 
-        /** Returns a c-string equivalent of a onestring
-             * \return the c-string (remember to free[]) */
-        const char* c_str() const;
+        /** Returns a c-string equivalent of a onestring.
+             * This is the onestring's own buffer, so it is never rebuilt
+             * or reallocated by this call. It is only valid until the
+             * onestring is next modified.
+             * \return the c-string */
+        const char* c_str() const { return this->_bytes; }
 
         /** Returns a c-string equivalent of a onestring
              * Alias for onestring::c_str()
-             * \return the c-string (remember to free[]) */
+             * \return the c-string */
         const char* data() const { return c_str(); }
 
         /**Checks to see if a onestring contains any data
@@ -220,12 +911,11 @@ class onestring
         bool empty() const;
 
         /** Gets the first onechar in the string.
-             * If the string is empty, this has undefined behavior
-             * (although it is guaranteed memory safe.)
+             * If the string is empty, this has undefined behavior.
              * \return a reference to the first onechar in the string.
              */
-        onechar& front();
-        const onechar& front() const;
+        reference front();
+        onechar front() const;
 
         /**Gets the current number of elements in the onestring
          * \return the number of elements */
@@ -299,13 +989,36 @@ class onestring
         int compare(const std::string&) const;
 
         /** Compares the onestring against a onestring.
+             * \return an integer representing the result.
+             * Returns a negative integer IF this onestring is shorter
+             * OR the same length and lower in value
+             * Returns zero if the values are the same
+             * Returns a positive integer IF this onestring is longer
+             * OR the same length and higher in value
+             * Inline, since sorting spends most of its time here. */
+        int compare(const onestring& ostr) const
+        {
+            // Shorter strings sort first. (The lengths may not fit in an int.)
+            if (this->_elements != ostr._elements)
+            {
+                return (this->_elements < ostr._elements) ? -1 : 1;
+            }
+
+            /* If the strings are the same length, the first differing byte
+             * belongs to the first differing character, and UTF-8 orders
+             * the same bytewise as it does by code point. */
+            return memcmp(this->_bytes, ostr._bytes,
+                          (ostr._size < this->_size) ? ostr._size : this->_size);
+        }
+
+        /** Compares the onestring against a onestring_view.
              * \return an integer representing the result.
              * Returns a negative integer IF this onestring is shorter
              * OR the same length and lower in value
              * Returns zero if the values are the same
              * Returns a positive integer IF this onestring is longer
              * OR the same length and higher in value */
-        int compare(const onestring&) const;
+        int compare(const onestring_view&) const;
 
         /** Tests if the onestring value is equivalent to a single char.
              * \param the char to compare against
@@ -330,13 +1043,563 @@ class onestring
         /** Tests if the onestring value is equivalent to a std::string.
              * \param the std::string to compare against
              * \return true if equal, else false */
-        bool equals(const onestring&) const;
+        bool equals(const onestring& ostr) const
+        {
+            // If both hashes are already known, and differ, so do the strings.
+            if (this->_hash != 0 && ostr._hash != 0 && this->_hash != ostr._hash)
+            {
+                return false;
+            }
+            return (ostr._size == this->_size &&
+                    memcmp(this->_bytes, ostr._bytes, this->_size) == 0);
+        }
+
+        /** Tests if the onestring value is equivalent to a onestring_view.
+             * \param the onestring_view to compare against
+             * \return true if equal, else false */
+        bool equals(const onestring_view&) const;
+
+        /* Case-insensitive comparisons fold both sides first: simple,
+         * one-to-one case mappings for ASCII, Latin, Greek, Cyrillic, and
+         * Armenian, with no normalization. */
+
+        /** Compares the onestring against a char, ignoring case.
+             * \param the char to compare against
+             * \return an integer representing the result, as with
+             * compare(), as if both sides were folded */
+        int icompare(const char) const;
+
+        /** Compares the onestring against a onechar, ignoring case.
+             * \param the onechar to compare against
+             * \return an integer representing the result, as with
+             * compare(), as if both sides were folded */
+        int icompare(const onechar&) const;
+
+        /** Compares the onestring against a c-string, ignoring case.
+             * \param the c-string to compare against
+             * \return an integer representing the result, as with
+             * compare(), as if both sides were folded */
+        int icompare(const char*) const;
+
+        /** Compares the onestring against a std::string, ignoring case.
+             * \param the std::string to compare against
+             * \return an integer representing the result, as with
+             * compare(), as if both sides were folded */
+        int icompare(const std::string&) const;
+
+        /** Compares the onestring against a onestring, ignoring case.
+             * \param the onestring to compare against
+             * \return an integer representing the result, as with
+             * compare(), as if both sides were folded */
+        int icompare(const onestring&) const;
+
+        /** Compares the onestring against a onestring_view, ignoring case.
+             * \param the onestring_view to compare against
+             * \return an integer representing the result, as with
+             * compare(), as if both sides were folded */
+        int icompare(const onestring_view&) const;
+
+        /** Tests if the onestring is equivalent to a char, ignoring case.
+             * \param the char to compare against
+             * \return true if equal, else false */
+        bool iequals(const char) const;
+
+        /** Tests if the onestring is equivalent to a onechar, ignoring case.
+             * \param the onechar to compare against
+             * \return true if equal, else false */
+        bool iequals(const onechar&) const;
+
+        /** Tests if the onestring is equivalent to a c-string, ignoring case.
+             * \param the c-string to compare against
+             * \return true if equal, else false */
+        bool iequals(const char*) const;
+
+        /** Tests if the onestring is equivalent to a std::string, ignoring case.
+             * \param the std::string to compare against
+             * \return true if equal, else false */
+        bool iequals(const std::string&) const;
+
+        /** Tests if the onestring is equivalent to a onestring, ignoring case.
+             * \param the onestring to compare against
+             * \return true if equal, else false */
+        bool iequals(const onestring&) const;
+
+        /** Tests if the onestring is equivalent to a onestring_view, ignoring case.
+             * \param the onestring_view to compare against
+             * \return true if equal, else false */
+        bool iequals(const onestring_view&) const;
 
         /*******************************************
-        * Mutators
+        * Search
+        ********************************************/
+
+        /* All searches work on character indexes, not bytes. Substrings are
+         * matched bytewise, which is exact for valid UTF-8, since a
+         * character's first byte can never appear inside another character.
+         * A char, c-string, or std::string is repaired first, as when it is
+         * added to a onestring, so an invalid byte is searched for as U+FFFD.
+         */
+
+        /** Finds the first occurrence of the char in the onestring,
+             * at or after the given position.
+             * \param the char to search for
+             * \param the index of the first character to search from, default 0
+             * \return the index of the first character of the match, or npos */
+        size_t find(const char, size_t pos = 0) const;
+
+        /** Finds the first occurrence of the onechar in the onestring,
+             * at or after the given position.
+             * \param the onechar to search for
+             * \param the index of the first character to search from, default 0
+             * \return the index of the first character of the match, or npos */
+        size_t find(const onechar&, size_t pos = 0) const;
+
+        /** Finds the first occurrence of the c-string in the onestring,
+             * at or after the given position.
+             * \param the c-string to search for
+             * \param the index of the first character to search from, default 0
+             * \return the index of the first character of the match, or npos */
+        size_t find(const char*, size_t pos = 0) const;
+
+        /** Finds the first occurrence of the std::string in the onestring,
+             * at or after the given position.
+             * \param the std::string to search for
+             * \param the index of the first character to search from, default 0
+             * \return the index of the first character of the match, or npos */
+        size_t find(const std::string&, size_t pos = 0) const;
+
+        /** Finds the first occurrence of the onestring in the onestring,
+             * at or after the given position.
+             * \param the onestring to search for
+             * \param the index of the first character to search from, default 0
+             * \return the index of the first character of the match, or npos */
+        size_t find(const onestring&, size_t pos = 0) const;
+
+        /** Finds the first occurrence of the onestring_view in the onestring,
+             * at or after the given position.
+             * \param the onestring_view to search for
+             * \param the index of the first character to search from, default 0
+             * \return the index of the first character of the match, or npos */
+        size_t find(const onestring_view&, size_t pos = 0) const;
+
+        /** Finds the last occurrence of the char in the onestring,
+             * starting at or before the given position.
+             * \param the char to search for
+             * \param the index of the last character a match may start at,
+             * default npos (the whole string)
+             * \return the index of the first character of the match, or npos */
+        size_t rfind(const char, size_t pos = npos) const;
+
+        /** Finds the last occurrence of the onechar in the onestring,
+             * starting at or before the given position.
+             * \param the onechar to search for
+             * \param the index of the last character a match may start at,
+             * default npos (the whole string)
+             * \return the index of the first character of the match, or npos */
+        size_t rfind(const onechar&, size_t pos = npos) const;
+
+        /** Finds the last occurrence of the c-string in the onestring,
+             * starting at or before the given position.
+             * \param the c-string to search for
+             * \param the index of the last character a match may start at,
+             * default npos (the whole string)
+             * \return the index of the first character of the match, or npos */
+        size_t rfind(const char*, size_t pos = npos) const;
+
+        /** Finds the last occurrence of the std::string in the onestring,
+             * starting at or before the given position.
+             * \param the std::string to search for
+             * \param the index of the last character a match may start at,
+             * default npos (the whole string)
+             * \return the index of the first character of the match, or npos */
+        size_t rfind(const std::string&, size_t pos = npos) const;
+
+        /** Finds the last occurrence of the onestring in the onestring,
+             * starting at or before the given position.
+             * \param the onestring to search for
+             * \param the index of the last character a match may start at,
+             * default npos (the whole string)
+             * \return the index of the first character of the match, or npos */
+        size_t rfind(const onestring&, size_t pos = npos) const;
+
+        /** Finds the last occurrence of the onestring_view in the onestring,
+             * starting at or before the given position.
+             * \param the onestring_view to search for
+             * \param the index of the last character a match may start at,
+             * default npos (the whole string)
+             * \return the index of the first character of the match, or npos */
+        size_t rfind(const onestring_view&, size_t pos = npos) const;
+
+        /** Finds the first character in the onestring, at or after the given
+             * position, that matches any of the characters in the char.
+             * \param the char of characters to search for
+             * \param the index of the first character to search from, default 0
+             * \return the index of the character found, or npos */
+        size_t find_first_of(const char, size_t pos = 0) const;
+
+        /** Finds the first character in the onestring, at or after the given
+             * position, that matches any of the characters in the onechar.
+             * \param the onechar of characters to search for
+             * \param the index of the first character to search from, default 0
+             * \return the index of the character found, or npos */
+        size_t find_first_of(const onechar&, size_t pos = 0) const;
+
+        /** Finds the first character in the onestring, at or after the given
+             * position, that matches any of the characters in the c-string.
+             * \param the c-string of characters to search for
+             * \param the index of the first character to search from, default 0
+             * \return the index of the character found, or npos */
+        size_t find_first_of(const char*, size_t pos = 0) const;
+
+        /** Finds the first character in the onestring, at or after the given
+             * position, that matches any of the characters in the std::string.
+             * \param the std::string of characters to search for
+             * \param the index of the first character to search from, default 0
+             * \return the index of the character found, or npos */
+        size_t find_first_of(const std::string&, size_t pos = 0) const;
+
+        /** Finds the first character in the onestring, at or after the given
+             * position, that matches any of the characters in the onestring.
+             * \param the onestring of characters to search for
+             * \param the index of the first character to search from, default 0
+             * \return the index of the character found, or npos */
+        size_t find_first_of(const onestring&, size_t pos = 0) const;
+
+        /** Finds the first character in the onestring, at or after the given
+             * position, that matches any of the characters in the onestring_view.
+             * \param the onestring_view of characters to search for
+             * \param the index of the first character to search from, default 0
+             * \return the index of the character found, or npos */
+        size_t find_first_of(const onestring_view&, size_t pos = 0) const;
+
+        /** Finds the first character in the onestring, at or after the given
+             * position, that matches none of the characters in the char.
+             * \param the char of characters to skip
+             * \param the index of the first character to search from, default 0
+             * \return the index of the character found, or npos */
+        size_t find_first_not_of(const char, size_t pos = 0) const;
+
+        /** Finds the first character in the onestring, at or after the given
+             * position, that matches none of the characters in the onechar.
+             * \param the onechar of characters to skip
+             * \param the index of the first character to search from, default 0
+             * \return the index of the character found, or npos */
+        size_t find_first_not_of(const onechar&, size_t pos = 0) const;
+
+        /** Finds the first character in the onestring, at or after the given
+             * position, that matches none of the characters in the c-string.
+             * \param the c-string of characters to skip
+             * \param the index of the first character to search from, default 0
+             * \return the index of the character found, or npos */
+        size_t find_first_not_of(const char*, size_t pos = 0) const;
+
+        /** Finds the first character in the onestring, at or after the given
+             * position, that matches none of the characters in the std::string.
+             * \param the std::string of characters to skip
+             * \param the index of the first character to search from, default 0
+             * \return the index of the character found, or npos */
+        size_t find_first_not_of(const std::string&, size_t pos = 0) const;
+
+        /** Finds the first character in the onestring, at or after the given
+             * position, that matches none of the characters in the onestring.
+             * \param the onestring of characters to skip
+             * \param the index of the first character to search from, default 0
+             * \return the index of the character found, or npos */
+        size_t find_first_not_of(const onestring&, size_t pos = 0) const;
+
+        /** Finds the first character in the onestring, at or after the given
+             * position, that matches none of the characters in the onestring_view.
+             * \param the onestring_view of characters to skip
+             * \param the index of the first character to search from, default 0
+             * \return the index of the character found, or npos */
+        size_t find_first_not_of(const onestring_view&, size_t pos = 0) const;
+
+        /** Finds the last character in the onestring, at or before the given
+             * position, that matches any of the characters in the char.
+             * \param the char of characters to search for
+             * \param the index of the last character to search from,
+             * default npos (the whole string)
+             * \return the index of the character found, or npos */
+        size_t find_last_of(const char, size_t pos = npos) const;
+
+        /** Finds the last character in the onestring, at or before the given
+             * position, that matches any of the characters in the onechar.
+             * \param the onechar of characters to search for
+             * \param the index of the last character to search from,
+             * default npos (the whole string)
+             * \return the index of the character found, or npos */
+        size_t find_last_of(const onechar&, size_t pos = npos) const;
+
+        /** Finds the last character in the onestring, at or before the given
+             * position, that matches any of the characters in the c-string.
+             * \param the c-string of characters to search for
+             * \param the index of the last character to search from,
+             * default npos (the whole string)
+             * \return the index of the character found, or npos */
+        size_t find_last_of(const char*, size_t pos = npos) const;
+
+        /** Finds the last character in the onestring, at or before the given
+             * position, that matches any of the characters in the std::string.
+             * \param the std::string of characters to search for
+             * \param the index of the last character to search from,
+             * default npos (the whole string)
+             * \return the index of the character found, or npos */
+        size_t find_last_of(const std::string&, size_t pos = npos) const;
+
+        /** Finds the last character in the onestring, at or before the given
+             * position, that matches any of the characters in the onestring.
+             * \param the onestring of characters to search for
+             * \param the index of the last character to search from,
+             * default npos (the whole string)
+             * \return the index of the character found, or npos */
+        size_t find_last_of(const onestring&, size_t pos = npos) const;
+
+        /** Finds the last character in the onestring, at or before the given
+             * position, that matches any of the characters in the onestring_view.
+             * \param the onestring_view of characters to search for
+             * \param the index of the last character to search from,
+             * default npos (the whole string)
+             * \return the index of the character found, or npos */
+        size_t find_last_of(const onestring_view&, size_t pos = npos) const;
+
+        /** Finds the last character in the onestring, at or before the given
+             * position, that matches none of the characters in the char.
+             * \param the char of characters to skip
+             * \param the index of the last character to search from,
+             * default npos (the whole string)
+             * \return the index of the character found, or npos */
+        size_t find_last_not_of(const char, size_t pos = npos) const;
+
+        /** Finds the last character in the onestring, at or before the given
+             * position, that matches none of the characters in the onechar.
+             * \param the onechar of characters to skip
+             * \param the index of the last character to search from,
+             * default npos (the whole string)
+             * \return the index of the character found, or npos */
+        size_t find_last_not_of(const onechar&, size_t pos = npos) const;
+
+        /** Finds the last character in the onestring, at or before the given
+             * position, that matches none of the characters in the c-string.
+             * \param the c-string of characters to skip
+             * \param the index of the last character to search from,
+             * default npos (the whole string)
+             * \return the index of the character found, or npos */
+        size_t find_last_not_of(const char*, size_t pos = npos) const;
+
+        /** Finds the last character in the onestring, at or before the given
+             * position, that matches none of the characters in the std::string.
+             * \param the std::string of characters to skip
+             * \param the index of the last character to search from,
+             * default npos (the whole string)
+             * \return the index of the character found, or npos */
+        size_t find_last_not_of(const std::string&, size_t pos = npos) const;
+
+        /** Finds the last character in the onestring, at or before the given
+             * position, that matches none of the characters in the onestring.
+             * \param the onestring of characters to skip
+             * \param the index of the last character to search from,
+             * default npos (the whole string)
+             * \return the index of the character found, or npos */
+        size_t find_last_not_of(const onestring&, size_t pos = npos) const;
+
+        /** Finds the last character in the onestring, at or before the given
+             * position, that matches none of the characters in the onestring_view.
+             * \param the onestring_view of characters to skip
+             * \param the index of the last character to search from,
+             * default npos (the whole string)
+             * \return the index of the character found, or npos */
+        size_t find_last_not_of(const onestring_view&, size_t pos = npos) const;
+
+        /** Counts the non-overlapping occurrences of the char in the onestring.
+             * An empty substring is never counted.
+             * \param the char to search for
+             * \return the number of occurrences */
+        size_t count(const char) const;
+
+        /** Counts the non-overlapping occurrences of the onechar in the onestring.
+             * An empty substring is never counted.
+             * \param the onechar to search for
+             * \return the number of occurrences */
+        size_t count(const onechar&) const;
+
+        /** Counts the non-overlapping occurrences of the c-string in the onestring.
+             * An empty substring is never counted.
+             * \param the c-string to search for
+             * \return the number of occurrences */
+        size_t count(const char*) const;
+
+        /** Counts the non-overlapping occurrences of the std::string in the onestring.
+             * An empty substring is never counted.
+             * \param the std::string to search for
+             * \return the number of occurrences */
+        size_t count(const std::string&) const;
+
+        /** Counts the non-overlapping occurrences of the onestring in the onestring.
+             * An empty substring is never counted.
+             * \param the onestring to search for
+             * \return the number of occurrences */
+        size_t count(const onestring&) const;
+
+        /** Counts the non-overlapping occurrences of the onestring_view in the onestring.
+             * An empty substring is never counted.
+             * \param the onestring_view to search for
+             * \return the number of occurrences */
+        size_t count(const onestring_view&) const;
+
+        /** Checks whether the char occurs anywhere in the onestring.
+             * \param the char to search for
+             * \return true if found, else false */
+        bool contains(const char) const;
+
+        /** Checks whether the onechar occurs anywhere in the onestring.
+             * \param the onechar to search for
+             * \return true if found, else false */
+        bool contains(const onechar&) const;
+
+        /** Checks whether the c-string occurs anywhere in the onestring.
+             * \param the c-string to search for
+             * \return true if found, else false */
+        bool contains(const char*) const;
+
+        /** Checks whether the std::string occurs anywhere in the onestring.
+             * \param the std::string to search for
+             * \return true if found, else false */
+        bool contains(const std::string&) const;
+
+        /** Checks whether the onestring occurs anywhere in the onestring.
+             * \param the onestring to search for
+             * \return true if found, else false */
+        bool contains(const onestring&) const;
+
+        /** Checks whether the onestring_view occurs anywhere in the onestring.
+             * \param the onestring_view to search for
+             * \return true if found, else false */
+        bool contains(const onestring_view&) const;
+
+        /** Checks whether the onestring starts with the char.
+             * \param the char to look for
+             * \return true if the onestring starts with it, else false */
+        bool starts_with(const char) const;
+
+        /** Checks whether the onestring starts with the onechar.
+             * \param the onechar to look for
+             * \return true if the onestring starts with it, else false */
+        bool starts_with(const onechar&) const;
+
+        /** Checks whether the onestring starts with the c-string.
+             * \param the c-string to look for
+             * \return true if the onestring starts with it, else false */
+        bool starts_with(const char*) const;
+
+        /** Checks whether the onestring starts with the std::string.
+             * \param the std::string to look for
+             * \return true if the onestring starts with it, else false */
+        bool starts_with(const std::string&) const;
+
+        /** Checks whether the onestring starts with the onestring.
+             * \param the onestring to look for
+             * \return true if the onestring starts with it, else false */
+        bool starts_with(const onestring&) const;
+
+        /** Checks whether the onestring starts with the onestring_view.
+             * \param the onestring_view to look for
+             * \return true if the onestring starts with it, else false */
+        bool starts_with(const onestring_view&) const;
+
+        /** Checks whether the onestring ends with the char.
+             * \param the char to look for
+             * \return true if the onestring ends with it, else false */
+        bool ends_with(const char) const;
+
+        /** Checks whether the onestring ends with the onechar.
+             * \param the onechar to look for
+             * \return true if the onestring ends with it, else false */
+        bool ends_with(const onechar&) const;
+
+        /** Checks whether the onestring ends with the c-string.
+             * \param the c-string to look for
+             * \return true if the onestring ends with it, else false */
+        bool ends_with(const char*) const;
+
+        /** Checks whether the onestring ends with the std::string.
+             * \param the std::string to look for
+             * \return true if the onestring ends with it, else false */
+        bool ends_with(const std::string&) const;
+
+        /** Checks whether the onestring ends with the onestring.
+             * \param the onestring to look for
+             * \return true if the onestring ends with it, else false */
+        bool ends_with(const onestring&) const;
+
+        /** Checks whether the onestring ends with the onestring_view.
+             * \param the onestring_view to look for
+             * \return true if the onestring ends with it, else false */
+        bool ends_with(const onestring_view&) const;
+
+        /*******************************************
+        * Transcoding
         ********************************************/
 
-        // TODO How many need rvalue versions?
+        /** Gets the number of UTF-16 code units needed to hold the
+             * onestring, not counting any terminator.
+             * \return the number of code units */
+        size_t utf16_size() const;
+
+        /** Gets the number of UTF-32 code units needed to hold the
+             * onestring, not counting any terminator. This is the same as
+             * length().
+             * \return the number of code units */
+        size_t utf32_size() const { return this->_elements; }
+
+        /** Copies the onestring into a buffer as UTF-16. No terminator is
+             * written.
+             * \param the buffer, which must have room for utf16_size() units
+             * \return the number of code units written */
+        size_t to_utf16(char16_t* out) const;
+
+        /** Copies the onestring into a buffer as UTF-32. No terminator is
+             * written.
+             * \param the buffer, which must have room for utf32_size() units
+             * \return the number of code units written */
+        size_t to_utf32(char32_t* out) const;
+
+        /** Converts the onestring to UTF-16.
+             * \return the UTF-16 text */
+        std::u16string to_utf16() const;
+
+        /** Converts the onestring to UTF-32.
+             * \return the UTF-32 text */
+        std::u32string to_utf32() const;
+
+        /** Creates a onestring from UTF-16. A lone surrogate is stored as
+             * U+FFFD.
+             * \param the UTF-16 code units
+             * \param the number of code units
+             * \return the new onestring */
+        static onestring from_utf16(const char16_t* units, size_t n);
+
+        /** Creates a onestring from UTF-16. A lone surrogate is stored as
+             * U+FFFD.
+             * \param the UTF-16 text
+             * \return the new onestring */
+        static onestring from_utf16(const std::u16string& str) { return from_utf16(str.data(), str.size()); }
+
+        /** Creates a onestring from UTF-32. A surrogate, or anything past
+             * U+10FFFF, is stored as U+FFFD.
+             * \param the UTF-32 code units
+             * \param the number of code units
+             * \return the new onestring */
+        static onestring from_utf32(const char32_t* units, size_t n);
+
+        /** Creates a onestring from UTF-32. A surrogate, or anything past
+             * U+10FFFF, is stored as U+FFFD.
+             * \param the UTF-32 text
+             * \return the new onestring */
+        static onestring from_utf32(const std::u32string& str) { return from_utf32(str.data(), str.size()); }
+
+        /*******************************************
+        * Mutators
+        ********************************************/
 
         /** Appends a character to the end of the onestring.
              * \param the char to append
@@ -368,6 +1631,155 @@ class onestring
              * \return a reference to the onestring */
         onestring& append(const onestring&, size_t repeat = 1);
 
+        /** Appends characters to the end of the onestring. If this
+             * onestring is empty, the contents are moved instead of copied.
+             * \param the onestring to append from
+             * \param how many times to repeat the append, default 1
+             * \return a reference to the onestring */
+        onestring& append(onestring&&, size_t repeat = 1);
+
+        /** Appends characters to the end of the onestring.
+             * \param the onestring_view to append from
+             * \param how many times to repeat the append, default 1
+             * \return a reference to the onestring */
+        onestring& append(const onestring_view&, size_t repeat = 1);
+
+        /** Appends several pieces of text to the end of the onestring,
+             * reserving space for all of them first. Each may be a char,
+             * onechar, c-string, std::string, onestring, onestring_view,
+             * bool, or number.
+             * \param the pieces to append
+             * \return a reference to the onestring */
+        template<typename... Pieces>
+        onestring& append_all(const Pieces&... pieces)
+        {
+            if constexpr (sizeof...(Pieces) > 0)
+            {
+                const piece parts[] = {piece(pieces)...};
+                append_pieces(parts, sizeof...(Pieces));
+            }
+            return *this;
+        }
+
+        /** Count the fields in a format string. A field is written "{}",
+             * and a literal brace is written twice, "{{" or "}}".
+             * \param the format string
+             * \param the number of bytes in the format string
+             * \return the number of fields, or npos if a brace is unmatched */
+        static constexpr size_t count_fields(const char* fmt, size_t n)
+        {
+            size_t fields = 0;
+            for (size_t i = 0; i < n; ++i)
+            {
+                if (fmt[i] != '{' && fmt[i] != '}') { continue; }
+                if (i + 1 >= n) { return npos; }
+
+                if (fmt[i] == '{' && fmt[i + 1] == '}')
+                {
+                    ++fields;
+                }
+                else if (fmt[i + 1] != fmt[i])
+                {
+                    return npos;
+                }
+                ++i;
+            }
+            return fields;
+        }
+
+        /** A string literal to use with format(), which must have as many
+         * fields as there are values given. It is checked at compile time:
+         * see PAWLIB_FORMAT_CHECK and PAWLIB_FORMAT(). */
+        template<size_t Fields>
+        class format_string
+        {
+            private:
+                /// The format string.
+                const char* _fmt;
+
+                /// The number of bytes in the format string.
+                size_t _size;
+
+            public:
+                /** Check a format string.
+                     * \param the string literal, with Fields fields */
+                template<size_t N>
+                // cppcheck-suppress noExplicitConstructor
+                PAWLIB_FORMAT_CHECK format_string(const char (&fmt)[N])
+                :_fmt(fmt), _size(N - 1)
+                {
+                    if (count_fields(fmt, N - 1) != Fields)
+                    {
+                        throw std::invalid_argument("Onestring::format(): format string does not match its arguments");
+                    }
+                }
+
+                /** Take a checked format string with a different number of
+                     * fields, which can never match. This only exists to
+                     * explain the compile error.
+                     * \param the checked format string */
+                template<size_t Counted>
+                // cppcheck-suppress noExplicitConstructor
+                constexpr format_string(const format_string<Counted>& fmt)
+                :_fmt(fmt.data()), _size(fmt.size())
+                {
+                    static_assert(Counted == Fields, "Onestring::format(): format string does not match its arguments");
+                }
+
+                constexpr const char* data() const { return this->_fmt; }
+                constexpr size_t size() const { return this->_size; }
+        };
+
+        /** Creates a onestring from a format string, with each field, "{}",
+             * replaced by the next value. Values may be anything concat()
+             * accepts. Numbers are written straight into the result, which
+             * is allocated once.
+             * \param the format string, from PAWLIB_FORMAT() or (from C++20)
+             * a string literal
+             * \param the values for the fields
+             * \return the new onestring */
+        template<typename... Values>
+        static onestring format(const format_string<sizeof...(Values)>& fmt, const Values&... values)
+        {
+            static_assert((std::is_constructible_v<piece, const Values&> && ...),
+                          "Onestring::format(): a value has a type which can't be formatted");
+            onestring r;
+            if constexpr (sizeof...(Values) > 0)
+            {
+                const piece parts[] = {piece(values)...};
+                r.format_pieces(fmt.data(), fmt.size(), parts, sizeof...(Values));
+            }
+            else
+            {
+                r.format_pieces(fmt.data(), fmt.size(), nullptr, 0);
+            }
+            return r;
+        }
+
+#if !defined(__cpp_consteval)
+        /** Without consteval, a bare string literal can't be checked at
+             * compile time, so it isn't accepted. */
+        template<size_t N, typename... Values>
+        static onestring format(const char (&)[N], const Values&...)
+        {
+            static_assert(N == 0, "Onestring::format(): before C++20, wrap the format string in PAWLIB_FORMAT()");
+            return onestring();
+        }
+#endif
+
+        /** Creates a onestring from several pieces of text, allocating
+             * once for the whole result. Unlike a chain of +, no
+             * intermediate strings are built. See append_all().
+             * \param the pieces to join
+             * \return the new onestring */
+        template<typename... Pieces>
+        static onestring concat(const Pieces&... pieces)
+        {
+            onestring r;
+            r.append_all(pieces...);
+            return r;
+        }
+
 
         /** Assigns a character to the onestring.
              * \param the char to copy
@@ -394,8 +1806,28 @@ class onestring
              * \return a reference to the onestring */
         onestring& assign(const onestring&);
 
+        /** Assigns characters to the onestring by moving them from
+             * another onestring, which is left empty. The text is copied
+             * if the two use different memory resources.
+             * \param the onestring to move from
+             * \return a reference to the onestring */
+        onestring& assign(onestring&& ostr)
+        {
+            // Moving a string into itself should change nothing.
+            if (this != &ostr)
+            {
+                steal(ostr);
+            }
+            return *this;
+        }
+
+        /** Assigns characters to the onestring.
+             * \param the onestring_view to copy from
+             * \return a reference to the onestring */
+        onestring& assign(const onestring_view&);
 
-        /** Clears a onestring and reallocates it back to BASE_SIZE */
+
+        /** Clears a onestring, keeping its current capacity. */
         void clear();
 
 
@@ -416,7 +1848,8 @@ class onestring
              * \param the onestring to store to
              * \param the optional delimiter. The newline character is used if
              * none is specified.
-             * \return the same istream passed to the function */
+             * \return the same istream passed to the function
+             * To read many lines, onestring_reader is much faster. */
         static std::istream& getline(std::istream& is, onestring& ostr, char delim = '\n');
 
 
@@ -432,21 +1865,21 @@ class onestring
              * If this is greater than the string length, it throws out_of_range
              * \param the onechar to insert
              * \return a reference to the onestring */
-        onestring& insert(size_t pos, onechar& ochr);
+        onestring& insert(size_t pos, const onechar& ochr);
 
         /** Inserts characters in the onestring at the given position.
              * \param the index to insert at.
              * If this is greater than the string length, it throws out_of_range
              * \param the c-string to insert
              * \return a reference to the onestring */
-        onestring& insert(size_t pos, char* cstr);
+        onestring& insert(size_t pos, const char* cstr);
 
         /** Inserts characters in the onestring at the given position.
              * \param the index to insert at.
              * If this is greater than the string length, it throws out_of_range
              * \param the std::string to insert
              * \return a reference to the onestring */
-        onestring& insert(size_t pos, std::string& str);
+        onestring& insert(size_t pos, const std::string& str);
 
         /** Inserts characters in the onestring at the given position.
              * \param the index to insert at.
@@ -455,6 +1888,13 @@ class onestring
              * \return a reference to the onestring */
         onestring& insert(size_t pos, const onestring& ostr);
 
+        /** Inserts characters in the onestring at the given position.
+             * \param the index to insert at.
+             * If this is greater than the string length, it throws out_of_range
+             * \param the onestring_view to insert
+             * \return a reference to the onestring */
+        onestring& insert(size_t pos, const onestring_view& view);
+
 
         /**Removes the last element in a onestring */
         void pop_back();
@@ -479,20 +1919,12 @@ class onestring
              * \param the onestring to append from */
         void push_back(const onestring& ostr) { append(ostr); }
 
-        // TODO: Implement rvalue versions of most of the above
+        /** Appends characters to the end of the onestring.
+             * \param the onestring_view to append from */
+        void push_back(const onestring_view& view) { append(view); }
 
-    protected:
-        /** Modifies the internal data structure in preparation for a
-             * replacement of characters. Intended ONLY to be used by
-             * replace()! DOES NOT validate pos, len, or sublen! If used
-             * improperly, can cause undefined behavior or memory errors.
-             * \param the first index of the range to replace in the onestring
-             * \param the number of characters in the range to replace
-             * \param the number of characters that will be substituted in
-             * place of the given range */
-        inline void replace_setup(size_t pos, size_t len, size_t sublen);
+        // insert() has no rvalue versions: its text is always copied in.
 
-    public:
         /** Replaces characters in the onestring.
              * \param the first position to replace.
              * If this is greater than the string length, it throws out_of_range.
@@ -533,6 +1965,14 @@ class onestring
              * \return a reference to the onestring */
         onestring& replace(size_t pos, size_t len, const onestring& ostr);
 
+        /** Replaces characters in the onestring.
+             * \param the first position to replace.
+             * If this is greater than the string length, it throws out_of_range.
+             * \param the number of characters to replace.
+             * \param the onestring_view to replace from.
+             * \return a reference to the onestring */
+        onestring& replace(size_t pos, size_t len, const onestring_view& view);
+
         /** Replaces characters in the onestring.
              * \param the first position to replace.
              * If this is greater than the string length, it throws out_of_range.
@@ -571,13 +2011,63 @@ class onestring
         onestring& reverse();
 
 
+        /** Maps the onestring to lowercase in place. Characters with no
+             * lowercase, or whose lowercase has a different length in
+             * UTF-8, are left alone.
+             * \return a reference to the onestring */
+        onestring& to_lower();
+
+        /** Copies text into a new onestring, mapped to lowercase.
+             * \param the text to copy
+             * \return the new onestring */
+        static onestring to_lower(const onestring_view& view) { return mapped(view, casing::lower); }
+
+        /** Maps the onestring to uppercase in place. Characters with no
+             * uppercase, or whose uppercase has a different length in
+             * UTF-8, are left alone.
+             * \return a reference to the onestring */
+        onestring& to_upper();
+
+        /** Copies text into a new onestring, mapped to uppercase.
+             * \param the text to copy
+             * \return the new onestring */
+        static onestring to_upper(const onestring_view& view) { return mapped(view, casing::upper); }
+
+
         /** Exchanges the content of this onestring with that of the given std::string.
              * \param the std::string to swap with */
         void swap(std::string& str);
 
         /** Exchanges the content of this onestring with that of the given onestring.
+             * Their memory resources are exchanged along with the text.
              * \param the onestring to swap with */
-        void swap(onestring& ostr);
+        void swap(onestring& ostr) noexcept
+        {
+            bool thisLocal = this->is_local();
+            bool otherLocal = ostr.is_local();
+
+            // Exchange everything, including any inline text...
+            char local[sizeof(this->_local)];
+            memcpy(local, this->_local, sizeof(local));
+            memcpy(this->_local, ostr._local, sizeof(local));
+            memcpy(ostr._local, local, sizeof(local));
+
+            std::swap(this->_bytes, ostr._bytes);
+            std::swap(this->_size, ostr._size);
+            std::swap(this->_capacity, ostr._capacity);
+            std::swap(this->_elements, ostr._elements);
+            std::swap(this->_index, ostr._index);
+            std::swap(this->_index_capacity, ostr._index_capacity);
+            std::swap(this->_indexed, ostr._indexed);
+            std::swap(this->_cursor_pos, ostr._cursor_pos);
+            std::swap(this->_cursor_off, ostr._cursor_off);
+            std::swap(this->_hash, ostr._hash);
+            std::swap(this->_resource, ostr._resource);
+
+            // ...then point inline text at its new home.
+            if (otherLocal) { this->_bytes = this->_local; }
+            if (thisLocal) { ostr._bytes = ostr._local; }
+        }
 
         /** Exchanges the content of the given strings.
              * \param the first string to swap
@@ -597,26 +2087,93 @@ class onestring
              */
         static void swap(onestring& lhs, onestring& rhs) { lhs.swap(rhs); }
 
+        /** Exchanges the content of the given strings. Found by
+             * argument-dependent lookup, so std::sort() and other
+             * algorithms swap onestrings without moving them three times.
+             * \param the first string to swap
+             * \param the second string to swap
+             */
+        friend void swap(onestring& lhs, onestring& rhs) noexcept { lhs.swap(rhs); }
+
 
         /*******************************************
         * Operators
         ********************************************/
 
-        onechar& operator[](size_t pos) { return at(pos); }
-        const onechar& operator[](size_t pos) const { return at(pos); }
+        reference operator[](size_t pos) { return at(pos); }
+        onechar operator[](size_t pos) const { return at(pos); }
 
         onestring& operator=(char ch) { assign(ch); return *this; }
         onestring& operator=(const onechar& ochr) { assign(ochr); return *this; }
         onestring& operator=(const char* cstr) { assign(cstr); return *this; }
         onestring& operator=(const std::string& str) { assign(str); return *this; }
-        onestring& operator=(onestring& ostr) { assign(ostr); return *this; }
+        onestring& operator=(const onestring& ostr) { assign(ostr); return *this; }
+        onestring& operator=(onestring&& ostr) { assign(std::move(ostr)); return *this; }
+        onestring& operator=(const onestring_view& view) { assign(view); return *this; }
 
         void operator+=(const char ch) { append(ch); }
         void operator+=(const onechar& ochr) { append(ochr); }
         void operator+=(const char* cstr) { append(cstr); }
         void operator+=(const std::string& str) { append(str); }
         void operator+=(const onestring& ostr) { append(ostr); }
+        void operator+=(onestring&& ostr) { append(std::move(ostr)); }
+        void operator+=(const onestring_view& view) { append(view); }
+
+        friend onestring operator+(const onestring& lhs, const char rhs) { onestring r(lhs); r.append(rhs); return r; }
+        friend onestring operator+(const onestring& lhs, const onechar& rhs) { onestring r(lhs); r.append(rhs); return r; }
+        friend onestring operator+(const onestring& lhs, const char* rhs) { onestring r(lhs); r.append(rhs); return r; }
+        friend onestring operator+(const onestring& lhs, const std::string& rhs) { onestring r(lhs); r.append(rhs); return r; }
+        friend onestring operator+(const onestring& lhs, const onestring& rhs) { onestring r(lhs); r.append(rhs); return r; }
+        friend onestring operator+(const onestring& lhs, const onestring_view& rhs) { onestring r(lhs); r.append(rhs); return r; }
+
+        // When the left side is temporary, append to it in place.
+        friend onestring operator+(onestring&& lhs, const char rhs) { lhs.append(rhs); return std::move(lhs); }
+        friend onestring operator+(onestring&& lhs, const onechar& rhs) { lhs.append(rhs); return std::move(lhs); }
+        friend onestring operator+(onestring&& lhs, const char* rhs) { lhs.append(rhs); return std::move(lhs); }
+        friend onestring operator+(onestring&& lhs, const std::string& rhs) { lhs.append(rhs); return std::move(lhs); }
+        friend onestring operator+(onestring&& lhs, const onestring& rhs) { lhs.append(rhs); return std::move(lhs); }
+        friend onestring operator+(onestring&& lhs, onestring&& rhs) { lhs.append(std::move(rhs)); return std::move(lhs); }
+        friend onestring operator+(onestring&& lhs, const onestring_view& rhs) { lhs.append(rhs); return std::move(lhs); }
+
+        // When only the right side is temporary, prepend to it in place.
+        friend onestring operator+(const char lhs, onestring&& rhs)
+        {
+            // A lone byte above 0x7F goes in as U+FFFD, as with append().
+            rhs.splice_text(0, 0, &lhs, 1);
+            return std::move(rhs);
+        }
+
+        friend onestring operator+(const onechar& lhs, onestring&& rhs)
+        {
+            const char* bytes = lhs.c_str();
+            rhs.splice(0, 0, bytes, onechar::evaluateLength(bytes), 1);
+            return std::move(rhs);
+        }
 
+        friend onestring operator+(const char* lhs, onestring&& rhs)
+        {
+            rhs.splice_text(0, 0, lhs, strlen(lhs));
+            return std::move(rhs);
+        }
+
+        friend onestring operator+(const std::string& lhs, onestring&& rhs)
+        {
+            rhs.splice_text(0, 0, lhs.data(), lhs.size());
+            return std::move(rhs);
+        }
+
+        friend onestring operator+(const onestring& lhs, onestring&& rhs)
+        {
+            rhs.splice(0, 0, lhs._bytes, lhs._size, lhs._elements);
+            return std::move(rhs);
+        }
+
+        friend onestring operator+(const char lhs, const onestring& rhs) { onestring r(lhs); r.append(rhs); return r; }
+        friend onestring operator+(const onechar& lhs, const onestring& rhs) { onestring r(lhs); r.append(rhs); return r; }
+        friend onestring operator+(const char* lhs, const onestring& rhs) { onestring r(lhs); r.append(rhs); return r; }
+        friend onestring operator+(const std::string& lhs, const onestring& rhs) { onestring r(lhs); r.append(rhs); return r; }
+
+        // Comparisons against a onestring_view are provided by onestring_view.
         bool operator==(const char ch) const { return equals(ch); }
         bool operator==(const onechar& ochr) const { return equals(ochr); }
         bool operator==(const char* cstr) const { return equals(cstr); }
@@ -687,13 +2244,13 @@ class onestring
 
         friend std::istream& operator>>(std::istream& is, onestring& ostr)
         {
-            ostr.clear();
-
+            std::string str;
             char ch;
             while (is.get(ch) && !isspace(ch))
             {
-                ostr.append(ch);
+                str.push_back(ch);
             }
+            ostr.assign(str);
             return is;
         }
 
@@ -704,4 +2261,14 @@ class onestring
         }
 };
 
+namespace std
+{
+    /// Allows onestring to be used as a key in unordered containers.
+    template<>
+    struct hash<onestring>
+    {
+        size_t operator()(const onestring& ostr) const { return ostr.hash(); }
+    };
+}
+
 #endif // PAWLIB_ONESTRING_HPP
@@ -0,0 +1,278 @@
+/** Onestring Interner [PawLIB]
+  * Version: 0.4
+  *
+  * Onestring_interner keeps exactly one copy of each distinct string it is
+  * given, and hands back a small handle to that copy. Two handles from the
+  * same interner are equal if and only if their text is equal, so comparing
+  * them is a single pointer comparison. Interned text is stored in large
+  * blocks owned by the interner, and stays put until the interner is
+  * destroyed. Interning is thread-safe, and looking up text that has
+  * already been interned never takes a lock.
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2016-2019 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_ONESTRING_INTERN_HPP
+#define PAWLIB_ONESTRING_INTERN_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <functional> // std::hash
+#include <mutex>
+
+#include "pawlib/onestring.hpp"
+#include "pawlib/onestring_view.hpp"
+
+class onestring_interner
+{
+    private:
+        /** Every interned string is stored as an entry, immediately
+         * followed by its bytes and a null terminator. Entries never
+         * change or move once they are stored. */
+        struct entry
+        {
+            /// The hash of the text, as from onestring::hash().
+            size_t hash;
+
+            /// The number of bytes in the text, excluding the terminator.
+            size_t size;
+
+            /// The number of Unicode characters in the text.
+            size_t elements;
+
+            const char* bytes() const { return reinterpret_cast<const char*>(this + 1); }
+        };
+
+        /** Every block of storage begins with a pointer to the previously
+         * allocated block, so we can release them all later. */
+        struct block
+        {
+            block* prev;
+        };
+
+        /** An open-addressed table of entries. Tables are never changed
+         * except to fill an empty slot, and are never freed until the
+         * interner is, so readers never need to lock them. */
+        struct table
+        {
+            /// The table this one replaced, kept for readers still using it.
+            table* prev;
+
+            /// The number of slots. Always a power of two.
+            size_t capacity;
+
+            /// The slots, each empty or pointing to an entry.
+            std::atomic<entry*>* slots;
+        };
+
+        /** The interner is split into shards, each with its own lock,
+         * table, and storage, so threads interning different strings
+         * rarely wait on one another. */
+        struct shard
+        {
+            /// Guards everything else in the shard, but only for writing.
+            std::mutex lock;
+
+            /// The current table.
+            std::atomic<table*> current{nullptr};
+
+            /// The number of entries in the shard.
+            size_t count = 0;
+
+            /// The most recently allocated block of storage.
+            block* blocks = nullptr;
+
+            /// The next free byte in the current block.
+            char* cursor = nullptr;
+
+            /// The number of free bytes left in the current block.
+            size_t remaining = 0;
+        };
+
+        /// The number of bits of the hash used to select a shard.
+        static const size_t SHARD_BITS = 4;
+
+        /// The number of shards.
+        static const size_t SHARDS = 1 << SHARD_BITS;
+
+        /// The number of slots in each shard's first table.
+        static const size_t INITIAL_SLOTS = 64;
+
+        /// The default number of bytes in each block of storage.
+        static const size_t BLOCK_SIZE = 64 * 1024;
+
+        /// The shards. Mutable so that size() can lock them.
+        mutable shard shards[SHARDS];
+
+        /** Select the shard for a hash. Uses the high bits, since the
+         * slots within the shard use the low bits.
+             * \param the hash
+             * \return the shard */
+        shard& shard_for(size_t hash) const
+        {
+            return shards[hash >> (sizeof(size_t) * 8 - SHARD_BITS)];
+        }
+
+        /** Look for text in a table. Safe without locking.
+             * \param the table to search, or nullptr
+             * \param the text to look for
+             * \param the hash of the text
+             * \return the entry, or nullptr if the text isn't interned */
+        static entry* lookup(const table*, const onestring_view&, size_t hash);
+
+        /** Copy text into a shard's storage and add it to the table.
+         * The shard must be locked.
+             * \param the shard to store in
+             * \param the text to store
+             * \param the hash of the text
+             * \return the new entry */
+        static entry* store(shard&, const onestring_view&, size_t hash);
+
+        /** Replace a shard's table with one twice the size. The shard
+         * must be locked.
+             * \param the shard to grow */
+        static void grow(shard&);
+
+    public:
+        /** A handle to an interned string. Handles are the size of a
+         * pointer, and may be freely copied. A default-constructed handle
+         * refers to nothing, and is equal only to other such handles. */
+        class handle
+        {
+            friend onestring_interner;
+            private:
+                const entry* _entry;
+
+                explicit handle(const entry* e)
+                :_entry(e)
+                {}
+
+            public:
+                handle()
+                :_entry(nullptr)
+                {}
+
+                /** Checks whether the handle refers to a string. */
+                explicit operator bool() const { return _entry != nullptr; }
+
+                /** Gets a view of the interned text. The view remains valid
+                 * as long as the interner does.
+                 * WARNING: The handle must not be null.
+                 * \return a onestring_view of the text */
+                onestring_view view() const
+                {
+                    return onestring_view(_entry->bytes(), _entry->size, _entry->elements);
+                }
+
+                /** Gets the interned text as a c-string.
+                 * WARNING: The handle must not be null.
+                 * \return a null-terminated c-string */
+                const char* c_str() const { return _entry->bytes(); }
+
+                /** Copies the interned text into a new onestring.
+                 * WARNING: The handle must not be null.
+                 * \return a onestring with the text */
+                onestring str() const { return onestring(view()); }
+
+                /** Gets the hash of the interned text. This is the same as
+                 * onestring::hash() for the same text.
+                 * WARNING: The handle must not be null. */
+                size_t hash() const { return _entry->hash; }
+
+                /** Gets the number of characters in the interned text.
+                 * WARNING: The handle must not be null. */
+                size_t length() const { return _entry->elements; }
+
+                /** Gets the number of bytes in the interned text,
+                 * excluding the null terminator.
+                 * WARNING: The handle must not be null. */
+                size_t size() const { return _entry->size; }
+
+                /* Handles are ordered by address, not by text. This is
+                 * enough for ordered containers, but it is NOT
+                 * alphabetical, and differs between runs. */
+                friend bool operator==(handle lhs, handle rhs) { return lhs._entry == rhs._entry; }
+                friend bool operator!=(handle lhs, handle rhs) { return lhs._entry != rhs._entry; }
+                friend bool operator<(handle lhs, handle rhs) { return std::less<const void*>()(lhs._entry, rhs._entry); }
+        };
+
+        onestring_interner() = default;
+
+        // Interned text belongs to exactly one interner, so it can't be copied!
+        onestring_interner(const onestring_interner&) = delete;
+        onestring_interner& operator=(const onestring_interner&) = delete;
+
+        /** Interns text, copying it into the interner the first time it
+         * is seen. Safe to call from multiple threads at once. Text that
+         * is already interned is found without locking.
+             * \param the text to intern
+             * \return the handle for the text */
+        handle intern(const onestring_view&);
+
+        /** Finds text that has already been interned, without interning
+         * it. Safe to call from multiple threads at once, and never
+         * locks.
+             * \param the text to look for
+             * \return the handle for the text, or a null handle if the
+             * text has not been interned */
+        handle find(const onestring_view&) const;
+
+        /** Gets the number of distinct strings interned so far.
+             * \return the number of strings */
+        size_t size() const;
+
+        /** Releases all of the interned text. Any handles from this
+         * interner become invalid. */
+        ~onestring_interner();
+};
+
+namespace std
+{
+    /// Allows interned handles to be used as keys in unordered containers.
+    template<>
+    struct hash<onestring_interner::handle>
+    {
+        size_t operator()(onestring_interner::handle h) const
+        {
+            // Equal handles have equal text, so the text's hash will do.
+            return h ? h.hash() : 0;
+        }
+    };
+}
+
+#endif // PAWLIB_ONESTRING_INTERN_HPP
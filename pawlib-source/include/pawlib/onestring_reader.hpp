@@ -0,0 +1,133 @@
+/** Onestring Reader [PawLIB]
+  * Version: 0.4
+  *
+  * Onestring_reader splits a stream into records, such as lines, reading
+  * it in large blocks instead of one character at a time. Each record is
+  * handed out as a onestring_view into the reader's own buffer, or copied
+  * into a onestring the caller reuses, and is validated as UTF-8 in bulk.
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2016-2019 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_ONESTRING_READER_HPP
+#define PAWLIB_ONESTRING_READER_HPP
+
+#include <cstddef>
+#include <istream>
+#include <string>
+
+#include "pawlib/onestring.hpp"
+#include "pawlib/onestring_view.hpp"
+
+class onestring_reader
+{
+    private:
+        /// The stream being read from.
+        std::istream& _stream;
+
+        /// The delimiter between records. It is never part of a record.
+        std::string _delim;
+
+        /// The buffer of text read from the stream, but not yet handed out.
+        char* _buffer;
+
+        /// The number of bytes allocated for the buffer.
+        size_t _capacity;
+
+        /// The offset of the first byte not yet handed out.
+        size_t _start;
+
+        /// The offset just past the last byte read into the buffer.
+        size_t _end;
+
+        /// The number of records handed out so far.
+        size_t _records;
+
+        /// Storage for a record that had to be repaired.
+        std::string _repaired;
+
+        /** Read more of the stream into the buffer, first moving what is
+             * left to the front, and growing the buffer if it is still full.
+             * \return false if the stream had nothing more to give */
+        bool refill();
+
+        /** Find the end of the next record in the buffer, reading more of
+             * the stream as needed.
+             * \param [out] the offset of the end of the record
+             * \param [out] the number of bytes to skip past the record
+             * \return false if there are no more records */
+        bool find_record(size_t& end, size_t& skip);
+
+    public:
+        /// The default number of bytes read from the stream at once.
+        inline static const size_t BUFFER_SIZE = 65536;
+
+        /** Create a reader which splits a stream into records.
+             * \param the stream to read from; it must outlive the reader
+             * \param the delimiter between records, default newline. This
+             * may be more than one character, such as "\r\n".
+             * \param the number of bytes to read from the stream at once */
+        explicit onestring_reader(std::istream& is,
+                                  const onestring_view& delim = onestring_view("\n"),
+                                  size_t buffer_size = BUFFER_SIZE);
+
+        onestring_reader(const onestring_reader&) = delete;
+        onestring_reader& operator=(const onestring_reader&) = delete;
+
+        ~onestring_reader();
+
+        /** Get the next record, as a view into the reader's buffer. The
+             * view is only valid until the next call to next(). Invalid
+             * UTF-8 is repaired, as it is in onestring.
+             * \param [out] the view to point at the record
+             * \return true if there was another record, else false */
+        bool next(onestring_view& record);
+
+        /** Get the next record, by copying it into a onestring. Reusing the
+             * same onestring for every record avoids reallocating it.
+             * \param [out] the onestring to store the record in
+             * \return true if there was another record, else false */
+        bool next(onestring& record);
+
+        /** Get the number of records handed out so far.
+             * \return the number of records */
+        size_t records() const { return this->_records; }
+};
+
+#endif // PAWLIB_ONESTRING_READER_HPP
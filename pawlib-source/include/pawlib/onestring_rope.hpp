@@ -0,0 +1,444 @@
+/** Onestring Rope [PawLIB]
+  * Version: 0.4
+  *
+  * Onestring_rope holds very large UTF-8 text as a balanced tree of
+  * immutable chunks, rather than one contiguous block. Inserting, erasing,
+  * and taking substrings are O(log n), concatenation is cheap, and copies
+  * share their chunks instead of duplicating them. Characters are indexed
+  * the same way as in onestring, and the two convert freely.
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2016-2019 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_ONESTRING_ROPE_HPP
+#define PAWLIB_ONESTRING_ROPE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+#include "pawlib/onechar.hpp"
+#include "pawlib/onestring.hpp"
+#include "pawlib/onestring_view.hpp"
+
+class onestring_rope
+{
+    private:
+        /** A node of the tree. A leaf (height 0) is immediately followed by
+         * its UTF-8 text; a branch joins two subtrees. Nodes never change
+         * once they are built, so they can be shared between ropes, and
+         * are freed when the last rope using them lets go. */
+        struct node
+        {
+            /// The number of ropes and branches using this node.
+            std::atomic<size_t> refs;
+
+            /// The number of bytes in the subtree.
+            size_t size;
+
+            /// The number of Unicode characters in the subtree.
+            size_t elements;
+
+            /// The height of the subtree. Leaves are 0.
+            size_t height;
+
+            /// The left subtree, or nullptr for a leaf.
+            node* left;
+
+            /// The right subtree, or nullptr for a leaf.
+            node* right;
+
+            const char* bytes() const { return reinterpret_cast<const char*>(this + 1); }
+        };
+
+        /// The root of the tree, or nullptr if the rope is empty.
+        node* root;
+
+        explicit onestring_rope(node* tree)
+        :root(tree)
+        {}
+
+        /** Create a leaf holding a copy of text.
+             * \param the UTF-8 text, which must be valid
+             * \param the number of bytes in the text
+             * \param the number of characters in the text
+             * \return the new leaf, with one reference */
+        static node* make_leaf(const char* bytes, size_t n, size_t chars);
+
+        /** Create a branch joining two subtrees, without rebalancing.
+             * \param the left subtree, whose reference is taken over
+             * \param the right subtree, whose reference is taken over
+             * \return the new branch, with one reference */
+        static node* make_branch(node* left, node* right);
+
+        /** Create a branch joining two subtrees whose heights differ by
+         * no more than two, rotating it back into balance if needed.
+             * \param the left subtree, whose reference is taken over
+             * \param the right subtree, whose reference is taken over
+             * \return the new subtree, with one reference */
+        static node* balance(node* left, node* right);
+
+        /** Add a reference to a node.
+             * \param the node, or nullptr
+             * \return the same node */
+        static node* retain(node* t);
+
+        /** Drop a reference to a node, freeing it (and dropping its
+         * references to its subtrees) if it was the last.
+             * \param the node, or nullptr */
+        static void release(node* t);
+
+        /** Concatenate two trees, keeping the result balanced.
+             * \param the left tree, whose reference is taken over
+             * \param the right tree, whose reference is taken over
+             * \return the joined tree, with one reference */
+        static node* join(node* left, node* right);
+
+        /** Split a tree in two at a character.
+             * \param the tree to split, which is left untouched
+             * \param the index of the first character of the right part
+             * \param [out] the left part, with one reference
+             * \param [out] the right part, with one reference */
+        static void split(node* t, size_t pos, node*& left, node*& right);
+
+        /** Build a balanced tree holding a copy of text.
+             * \param the UTF-8 text, which must be valid
+             * \param the number of bytes in the text
+             * \return the new tree, with one reference */
+        static node* build(const char* bytes, size_t n);
+
+        /** Find the leaf holding a character.
+             * WARNING: Does not check that the index is in range.
+             * \param the tree to search
+             * \param [in,out] the index of the character in the tree, which
+             * becomes its index in the leaf
+             * \return the leaf */
+        static const node* leaf_at(const node* t, size_t& pos);
+
+        /** Call a function with a view of each leaf's text, in order.
+             * \param the tree
+             * \param the function to call */
+        template<typename F>
+        static void for_each_leaf(const node* t, F&& f)
+        {
+            if (t == nullptr) { return; }
+            if (t->height == 0)
+            {
+                f(onestring_view(t->bytes(), t->size, t->elements));
+                return;
+            }
+            for_each_leaf(t->left, f);
+            for_each_leaf(t->right, f);
+        }
+
+    public:
+        /// The greatest possible value for an element.
+        inline static const size_t npos = -1;
+
+        /** The most bytes a leaf will normally hold. Longer text is split
+         * into leaves of about this size, and small neighbouring leaves are
+         * merged up to it. */
+        inline static const size_t LEAF_SIZE = 1024;
+
+        /** An iterator over the characters in a onestring_rope, which
+         * yields each one as a onechar. The rope must not be changed while
+         * the iterator is in use. */
+        class const_iterator
+        {
+            friend onestring_rope;
+            private:
+                /// The tree being iterated over.
+                const node* tree;
+
+                /// The leaf holding the current character.
+                const node* leaf;
+
+                /// The byte offset of the current character in its leaf.
+                size_t off;
+
+                /// The index of the current character in the rope.
+                size_t pos;
+
+                const_iterator(const node* t, size_t at);
+
+                /// Find the leaf and offset for the character at pos.
+                void seek();
+
+            public:
+                typedef std::bidirectional_iterator_tag iterator_category;
+                typedef onechar value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef const onechar* pointer;
+                typedef onechar reference;
+
+                const_iterator()
+                :tree(nullptr), leaf(nullptr), off(0), pos(0)
+                {}
+
+                onechar operator*() const { return onechar(leaf->bytes() + off); }
+
+                const_iterator& operator++();
+
+                const_iterator operator++(int)
+                {
+                    const_iterator r(*this);
+                    ++(*this);
+                    return r;
+                }
+
+                const_iterator& operator--();
+
+                const_iterator operator--(int)
+                {
+                    const_iterator r(*this);
+                    --(*this);
+                    return r;
+                }
+
+                bool operator==(const const_iterator& rhs) const { return pos == rhs.pos; }
+                bool operator!=(const const_iterator& rhs) const { return pos != rhs.pos; }
+        };
+
+        /*******************************************
+        * Constructors + Destructor
+        ********************************************/
+
+        /* Creating a rope from text copies the text, so, unlike onestring,
+         * those constructors are explicit. */
+
+        /** Create an empty rope. */
+        onestring_rope()
+        :root(nullptr)
+        {}
+
+        /** Create a rope from a c-string. Invalid UTF-8 is repaired, as it
+         * is in onestring.
+             * \param the c-string */
+        explicit onestring_rope(const char* cstr);
+
+        /** Create a rope from a std::string. Invalid UTF-8 is repaired, as
+         * it is in onestring.
+             * \param the std::string */
+        explicit onestring_rope(const std::string& str);
+
+        /** Create a rope from a onestring.
+             * \param the onestring */
+        explicit onestring_rope(const onestring& ostr);
+
+        /** Create a rope from a onestring_view.
+             * \param the view */
+        explicit onestring_rope(const onestring_view& view);
+
+        /** Create a rope sharing all the text of another. This is O(1).
+             * \param the rope to copy */
+        onestring_rope(const onestring_rope& rope)
+        :root(retain(rope.root))
+        {}
+
+        onestring_rope(onestring_rope&& rope) noexcept
+        :root(rope.root)
+        {
+            rope.root = nullptr;
+        }
+
+        onestring_rope& operator=(const onestring_rope& rope)
+        {
+            node* old = root;
+            root = retain(rope.root);
+            release(old);
+            return *this;
+        }
+
+        onestring_rope& operator=(onestring_rope&& rope) noexcept
+        {
+            std::swap(root, rope.root);
+            return *this;
+        }
+
+        ~onestring_rope()
+        {
+            release(root);
+        }
+
+        /*******************************************
+        * Accessors
+        ********************************************/
+
+        /** Gets the character at a position. This is O(log n).
+             * \param the index of the character
+             * \return a copy of the character, as a onechar */
+        onechar at(size_t pos) const;
+
+        /** Gets the last character in the rope.
+             * WARNING: The rope must not be empty.
+             * \return a copy of the character, as a onechar */
+        onechar back() const { return at(length() - 1); }
+
+        /** Checks whether the rope is empty.
+             * \return true if the rope is empty, else false */
+        bool empty() const { return root == nullptr; }
+
+        /** Gets the first character in the rope.
+             * WARNING: The rope must not be empty.
+             * \return a copy of the character, as a onechar */
+        onechar front() const { return at(0); }
+
+        /** Gets the number of characters in the rope.
+             * \return the number of characters */
+        size_t length() const { return (root == nullptr) ? 0 : root->elements; }
+
+        /** Gets the number of bytes of UTF-8 in the rope. Unlike
+         * onestring::size(), there is no null terminator to count.
+             * \return the number of bytes */
+        size_t size() const { return (root == nullptr) ? 0 : root->size; }
+
+        /** Gets part of the rope, sharing its text. This is O(log n).
+             * \param the index of the first character to include
+             * \param the number of characters to include
+             * \return a new rope */
+        onestring_rope substr(size_t pos = 0, size_t len = npos) const;
+
+        /** Copies the rope's text into a new onestring.
+             * \return a onestring with the text */
+        onestring str() const;
+
+        explicit operator onestring() const { return str(); }
+
+        const_iterator begin() const { return const_iterator(root, 0); }
+        const_iterator end() const { return const_iterator(root, length()); }
+
+        /*******************************************
+        * Comparison
+        ********************************************/
+
+        /** Checks whether the rope holds the same text as a view.
+             * \param the text to compare to
+             * \return true if equal, else false */
+        bool equals(const onestring_view&) const;
+
+        /** Checks whether two ropes hold the same text.
+             * \param the rope to compare to
+             * \return true if equal, else false */
+        bool equals(const onestring_rope&) const;
+
+        /*******************************************
+        * Modifiers
+        ********************************************/
+
+        /** Appends text to the end of the rope. This is O(log n).
+             * \param the text to append
+             * \return a reference to the rope */
+        onestring_rope& append(const onestring_view&);
+
+        /** Appends another rope, sharing its text. This is O(log n).
+             * \param the rope to append
+             * \return a reference to the rope */
+        onestring_rope& append(const onestring_rope&);
+
+        /** Removes all text from the rope. */
+        void clear();
+
+        /** Erases characters from the rope. This is O(log n).
+             * \param the index of the first character to erase
+             * \param the number of characters to erase
+             * \return a reference to the rope */
+        onestring_rope& erase(size_t pos = 0, size_t len = npos);
+
+        /** Inserts text into the rope. This is O(log n).
+             * \param the index to insert at
+             * \param the text to insert
+             * \return a reference to the rope */
+        onestring_rope& insert(size_t pos, const onestring_view&);
+
+        /** Inserts another rope, sharing its text. This is O(log n).
+             * \param the index to insert at
+             * \param the rope to insert
+             * \return a reference to the rope */
+        onestring_rope& insert(size_t pos, const onestring_rope&);
+
+        /** Replaces characters in the rope with text. This is O(log n).
+             * \param the index of the first character to replace
+             * \param the number of characters to replace
+             * \param the text to replace them with
+             * \return a reference to the rope */
+        onestring_rope& replace(size_t pos, size_t len, const onestring_view&);
+
+        /** Replaces characters in the rope with another rope, sharing its
+         * text. This is O(log n).
+             * \param the index of the first character to replace
+             * \param the number of characters to replace
+             * \param the rope to replace them with
+             * \return a reference to the rope */
+        onestring_rope& replace(size_t pos, size_t len, const onestring_rope&);
+
+        /** Swaps the contents of two ropes. This is O(1).
+             * \param the rope to swap with */
+        void swap(onestring_rope& rope) { std::swap(root, rope.root); }
+
+        /*******************************************
+        * Operators
+        ********************************************/
+
+        onechar operator[](size_t pos) const { return at(pos); }
+
+        onestring_rope& operator+=(const onestring_view& view) { return append(view); }
+        onestring_rope& operator+=(const onestring_rope& rope) { return append(rope); }
+
+        friend onestring_rope operator+(const onestring_rope& lhs, const onestring_rope& rhs)
+        {
+            onestring_rope r(lhs);
+            r.append(rhs);
+            return r;
+        }
+
+        friend bool operator==(const onestring_rope& lhs, const onestring_rope& rhs) { return lhs.equals(rhs); }
+        friend bool operator!=(const onestring_rope& lhs, const onestring_rope& rhs) { return !lhs.equals(rhs); }
+        friend bool operator==(const onestring_rope& lhs, const onestring_view& rhs) { return lhs.equals(rhs); }
+        friend bool operator!=(const onestring_rope& lhs, const onestring_view& rhs) { return !lhs.equals(rhs); }
+
+        friend std::ostream& operator<<(std::ostream& os, const onestring_rope& rope)
+        {
+            for_each_leaf(rope.root, [&os](const onestring_view& chunk) { os << chunk; });
+            return os;
+        }
+};
+
+#endif // PAWLIB_ONESTRING_ROPE_HPP
@@ -42,10 +42,24 @@
 #ifndef PAWLIB_ONESTRING_TESTS_HPP
 #define PAWLIB_ONESTRING_TESTS_HPP
 
+#include <algorithm>
+#include <memory_resource>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <string_view>
 
 #include "pawlib/goldilocks.hpp"
 #include "pawlib/onestring.hpp"
+#include "pawlib/onestring_intern.hpp"
+#include "pawlib/onestring_reader.hpp"
+#include "pawlib/onestring_rope.hpp"
+#include "pawlib/onestring_tokenizer.hpp"
+#include "pawlib/onestring_view.hpp"
+#include "pawlib/stdutils.hpp"
 
 class TestOnestring : public Test
 {
@@ -1823,7 +1837,7 @@ class TestOnestring_Back : public Test
 
         bool run() override
         {
-            onechar& ochr = test.back();
+            onestring::reference ochr = test.back();
             PL_ASSERT_EQUAL(ochr, "⛰");
 
             ochr = "!";
@@ -1863,7 +1877,7 @@ class TestOnestring_Front : public Test
 
         bool run() override
         {
-            onechar& ochr = test.front();
+            onestring::reference ochr = test.front();
             PL_ASSERT_EQUAL(ochr, "⛰");
 
             ochr = "!";
@@ -1896,7 +1910,8 @@ class TestOnestring_Capacity : public Test
         bool run() override
         {
             size_t expected_capacity = onestring::BASE_SIZE;
-            size_t string_length = test.length();
+            // Capacity is measured in bytes, not counting the terminator.
+            size_t string_length = test.size() - 1;
             while (expected_capacity < string_length)
             {
                 expected_capacity *= onestring::RESIZE_FACTOR;
@@ -2884,7 +2899,7 @@ class TestOnestring_Reserve : public Test
             PL_ASSERT_GREATER_EQUAL(test.capacity(), 10u);
 
             test.reserve(45);
-            PL_ASSERT_GREATER_EQUAL(test.capacity(), 55u);
+            PL_ASSERT_GREATER_EQUAL(test.capacity(), 45u);
 
             test.reserve(99);
             PL_ASSERT_GREATER_EQUAL(test.capacity(), 99u);
@@ -2911,17 +2926,25 @@ class TestOnestring_Resize : public Test
 
         bool run() override
         {
-            onestring test = "Hello!";
-            test.resize(9, '!');
-            PL_ASSERT_EQUAL(test.capacity(), 9u);
-            PL_ASSERT_EQUAL(test, "Hello!!!!");
-
+            // Use a string too long to be stored inline.
+            onestring test = "Hello, my big sphinx of quartz!";
+            PL_ASSERT_GREATER(test.capacity(), onestring::BASE_SIZE);
+            test.resize(40, '!');
+            PL_ASSERT_EQUAL(test.capacity(), 40u);
+            PL_ASSERT_EQUAL(test, "Hello, my big sphinx of quartz!!!!!!!!!!");
+
+            test.resize(35);
+            PL_ASSERT_EQUAL(test.capacity(), 35u);
+            PL_ASSERT_EQUAL(test, "Hello, my big sphinx of quartz!!!!!");
+
+            test.resize(50);
+            PL_ASSERT_EQUAL(test.capacity(), 50u);
+            PL_ASSERT_EQUAL(test, "Hello, my big sphinx of quartz!!!!!");
+
+            /* Shrinking moves the string back inline, and the capacity
+             * never drops below the inline storage. */
             test.resize(5);
-            PL_ASSERT_EQUAL(test.capacity(), 5u);
-            PL_ASSERT_EQUAL(test, "Hello");
-
-            test.resize(10);
-            PL_ASSERT_EQUAL(test.capacity(), 10u);
+            PL_ASSERT_EQUAL(test.capacity(), onestring::BASE_SIZE);
             PL_ASSERT_EQUAL(test, "Hello");
 
             return true;
@@ -2946,15 +2969,17 @@ class TestOnestring_ShrinkToFit : public Test
 
         bool run() override
         {
-            onestring test = "Hello!!";
+            // Fill the inline storage, then grow just past it.
+            onestring test = "Hello, my big sphinx!!";
+            test.append("!");
             test.shrink_to_fit();
-            PL_ASSERT_EQUAL(test.capacity(), 7u);
-            PL_ASSERT_EQUAL(test, "Hello!!");
+            PL_ASSERT_EQUAL(test.capacity(), 23u);
+            PL_ASSERT_EQUAL(test, "Hello, my big sphinx!!!");
 
             test.append("!!");
             test.shrink_to_fit();
-            PL_ASSERT_EQUAL(test.capacity(), 9u);
-            PL_ASSERT_EQUAL(test, "Hello!!!!");
+            PL_ASSERT_EQUAL(test.capacity(), 25u);
+            PL_ASSERT_EQUAL(test, "Hello, my big sphinx!!!!!");
 
             return true;
         }
@@ -3019,6 +3044,3099 @@ class TestOnestring_ForceResizeStress : public Test
         }
 };
 
+// P-tB4040
+class TestOnestring_LongAccess : public Test
+{
+    protected:
+        // One character of each UTF-8 byte length.
+        const char* pattern[4] = {"a", "é", "⛰", "🐉"};
+        size_t length = 500;
+        onestring test;
+
+        bool check(size_t skip)
+        {
+            // Check every character, back to front, so we can't rely on
+            // walking forward from the last character found.
+            size_t i = test.length();
+            while (i-- > 0)
+            {
+                size_t expect = (i < skip) ? i : i + 1;
+                PL_ASSERT_EQUAL(test.at(i), pattern[expect % 4]);
+            }
+            return true;
+        }
+
+    public:
+        TestOnestring_LongAccess(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Long Unicode Access";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test accessing characters of mixed byte lengths throughout a long onestring, before and after edits.";
+        }
+
+        bool janitor() override
+        {
+            test.clear();
+            for (size_t i = 0; i < length; ++i)
+            {
+                test.append(pattern[i % 4]);
+            }
+            return (test.length() == length);
+        }
+
+        bool run() override
+        {
+            PL_ASSERT_TRUE(check(length));
+
+            // Swap a 1-byte character for a 4-byte one, then restore it.
+            test[300] = "🐉";
+            PL_ASSERT_EQUAL(test.at(301), pattern[1]);
+            test[300] = pattern[0];
+            PL_ASSERT_TRUE(check(length));
+
+            // Remove a character early on, shifting everything after it.
+            test.erase(37, 1);
+            PL_ASSERT_EQUAL(test.length(), length - 1);
+            PL_ASSERT_TRUE(check(37));
+
+            return true;
+        }
+};
+
+// P-tB4041*
+class TestStdString_ShortBuild : public Test
+{
+    protected:
+        std::string test;
+
+    public:
+        TestStdString_ShortBuild(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Build Short String (std::string)";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Build a short identifier with a std::string and get its c-string.";
+        }
+
+        bool run() override
+        {
+            std::string str = "window_title";
+            str += "_label";
+            test = str.c_str();
+            return true;
+        }
+
+        bool verify() override
+        {
+            return (test == "window_title_label");
+        }
+};
+
+// P-tB4041
+class TestOnestring_ShortBuild : public Test
+{
+    protected:
+        std::string test;
+
+    public:
+        TestOnestring_ShortBuild(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Build Short String";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Build a short identifier with a onestring and get its c-string.";
+        }
+
+        bool run() override
+        {
+            onestring ostr = "window_title";
+            ostr += "_label";
+            test = ostr.c_str();
+            return true;
+        }
+
+        bool verify() override
+        {
+            return (test == "window_title_label");
+        }
+};
+
+// P-tB4042
+class TestOnestring_Inline : public Test
+{
+    protected:
+        onestring start_short = "🐉 Inline 🐉";
+        onestring start_long = "The quick brown 🦊 jumped over the lazy 🐶.";
+
+    public:
+        TestOnestring_Inline(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Inline Storage";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test moving between inline and heap storage, and swapping across them.";
+        }
+
+        bool run() override
+        {
+            // Short strings should stay in the inline storage.
+            onestring test = start_short;
+            PL_ASSERT_EQUAL(test.capacity(), onestring::BASE_SIZE);
+
+            // Growing should move to the heap.
+            test.append(start_long);
+            PL_ASSERT_GREATER(test.capacity(), onestring::BASE_SIZE);
+
+            // Shrinking should move back inline.
+            test.resize(start_short.length());
+            PL_ASSERT_EQUAL(test.capacity(), onestring::BASE_SIZE);
+            PL_ASSERT_EQUAL(test, start_short);
+
+            // Swap an inline string with a heap string.
+            onestring other = start_long;
+            test.swap(other);
+            PL_ASSERT_EQUAL(test, start_long);
+            PL_ASSERT_EQUAL(other, start_short);
+
+            // And back again.
+            other.swap(test);
+            PL_ASSERT_EQUAL(test, start_short);
+            PL_ASSERT_EQUAL(other, start_long);
+
+            return true;
+        }
+};
+
+// P-tB4043
+class TestOnestring_Move : public Test
+{
+    protected:
+        onestring start_short = "🐉 Inline 🐉";
+        onestring start_long = "The quick brown 🦊 jumped over the lazy 🐶.";
+
+    public:
+        TestOnestring_Move(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Move";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test moving onestrings with construction, assignment, append(), and +.";
+        }
+
+        bool run() override
+        {
+            // Moving heap text should take the buffer itself.
+            onestring from = start_long;
+            const char* buffer = from.c_str();
+            onestring to(std::move(from));
+            PL_ASSERT_EQUAL(to, start_long);
+            PL_ASSERT_TRUE(to.c_str() == buffer);
+            PL_ASSERT_TRUE(from.empty());
+
+            // Moving inline text should copy it.
+            from = start_short;
+            to = std::move(from);
+            PL_ASSERT_EQUAL(to, start_short);
+            PL_ASSERT_TRUE(from.empty());
+
+            // The moved-from string should still be usable.
+            from.append(start_long);
+            PL_ASSERT_EQUAL(from, start_long);
+
+            // Appending to an empty string should take the buffer.
+            onestring empty;
+            buffer = from.c_str();
+            empty.append(std::move(from));
+            PL_ASSERT_EQUAL(empty, start_long);
+            PL_ASSERT_TRUE(empty.c_str() == buffer);
+
+            // Concatenating temporaries should work on either side.
+            PL_ASSERT_EQUAL(start_short + start_long.substr(0, 3), "🐉 Inline 🐉The");
+            PL_ASSERT_EQUAL("The" + start_short.substr(1), "The Inline 🐉");
+            PL_ASSERT_EQUAL(onechar("🐉") + start_long.substr(3, 6), "🐉 quick");
+            PL_ASSERT_EQUAL(start_short.substr(0, 1) + start_long.substr(3, 6), "🐉 quick");
+            PL_ASSERT_EQUAL(start_short.substr(0, 1) + '!', "🐉!");
+            PL_ASSERT_EQUAL('!' + start_short.substr(0, 1), "!🐉");
+
+            // A lone byte above 0x7F goes in as U+FFFD either way.
+            const onestring dragon = start_short.substr(0, 1);
+            onestring replaced = '\xE9' + start_short.substr(0, 1);
+            PL_ASSERT_EQUAL(replaced, "\uFFFD🐉");
+            PL_ASSERT_EQUAL(replaced, '\xE9' + dragon);
+            PL_ASSERT_EQUAL(replaced.length(), 2u);
+            PL_ASSERT_EQUAL(start_short.substr(0, 1) + '\xE9', "🐉\uFFFD");
+
+            return true;
+        }
+};
+
+// P-tB4044
+class TestOnestring_CStrStable : public Test
+{
+    protected:
+        onestring test;
+
+    public:
+        TestOnestring_CStrStable(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: c_str() Stability";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test that c_str() is stable while a onestring is unchanged, and reflects each change.";
+        }
+
+        bool janitor() override
+        {
+            test = "The quick brown 🦊 jumped over the lazy 🐶.";
+            return true;
+        }
+
+        bool run() override
+        {
+            // Repeated calls should return the same buffer.
+            const char* cstr = test.c_str();
+            PL_ASSERT_TRUE(test.c_str() == cstr);
+            PL_ASSERT_TRUE(test.data() == cstr);
+            PL_ASSERT_EQUAL(strcmp(cstr, "The quick brown 🦊 jumped over the lazy 🐶."), 0);
+
+            // Changes that fit in place should show up in the same buffer.
+            test[16] = "🐱";
+            PL_ASSERT_TRUE(test.c_str() == cstr);
+            PL_ASSERT_EQUAL(strcmp(cstr, "The quick brown 🐱 jumped over the lazy 🐶."), 0);
+
+            test.erase(3, 6);
+            PL_ASSERT_EQUAL(strcmp(test.c_str(), "The brown 🐱 jumped over the lazy 🐶."), 0);
+
+            test.clear();
+            PL_ASSERT_EQUAL(strcmp(test.c_str(), ""), 0);
+
+            return true;
+        }
+};
+
+// P-tB4035
+class TestOnestring_Find : public Test
+{
+    protected:
+        onestring test = "The quick brown 🦊 jumped over the lazy 🐶. The 🦊 ran.";
+        onestring longer;
+
+    public:
+        TestOnestring_Find(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: find()";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test finding substrings in a onestring with find().";
+        }
+
+        bool janitor() override
+        {
+            // Long enough to need several blocks of the vectorized search.
+            longer.clear();
+            longer.append("🐉abc", 40);
+            longer.append("needle🦊");
+            return true;
+        }
+
+        bool run() override
+        {
+            PL_ASSERT_EQUAL(test.find('q'), 4u);
+            PL_ASSERT_EQUAL(test.find(onechar("🐶")), 39u);
+            PL_ASSERT_EQUAL(test.find("🦊"), 16u);
+            PL_ASSERT_EQUAL(test.find("🦊", 17), 46u);
+            PL_ASSERT_EQUAL(test.find(std::string("lazy")), 34u);
+            PL_ASSERT_EQUAL(test.find(onestring("The"), 1), 42u);
+
+            // An empty substring is found at the starting position.
+            PL_ASSERT_EQUAL(test.find(""), 0u);
+            PL_ASSERT_EQUAL(test.find("", 52), 52u);
+
+            PL_ASSERT_EQUAL(test.find("🦊 jumped under"), onestring::npos);
+            PL_ASSERT_EQUAL(test.find("The", 100), onestring::npos);
+
+            PL_ASSERT_EQUAL(longer.find("needle🦊"), 160u);
+            PL_ASSERT_EQUAL(longer.find("c🐉a", 150), 151u);
+            PL_ASSERT_EQUAL(longer.find("needle🐉"), onestring::npos);
+
+            // Invalid bytes are searched for as U+FFFD, so they can't match part of a character.
+            onestring accented = "xé";
+            PL_ASSERT_EQUAL(accented.find('\xA9'), onestring::npos);
+            PL_ASSERT_EQUAL(accented.find("\xC3"), onestring::npos);
+            PL_ASSERT_EQUAL(accented.rfind(std::string("\xA9")), onestring::npos);
+            PL_ASSERT_EQUAL(accented.find_first_of("\xA9"), onestring::npos);
+            PL_ASSERT_EQUAL(test.find_last_of("\xF0"), onestring::npos);
+            onestring replaced = "x\xA9";
+            PL_ASSERT_EQUAL(replaced.find('\xA9'), 1u);
+
+            return true;
+        }
+};
+
+// P-tB4036
+class TestOnestring_FindFirstNotOf : public Test
+{
+    protected:
+        onestring test = "The quick brown 🦊 jumped over the lazy 🐶. The 🦊 ran.";
+
+    public:
+        TestOnestring_FindFirstNotOf(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: find_first_not_of()";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test finding the first character not in a set with find_first_not_of().";
+        }
+
+        bool run() override
+        {
+            PL_ASSERT_EQUAL(test.find_first_not_of('T'), 1u);
+            PL_ASSERT_EQUAL(test.find_first_not_of("The qu"), 6u);
+            PL_ASSERT_EQUAL(test.find_first_not_of(std::string("Teh 🐶")), 4u);
+            PL_ASSERT_EQUAL(test.find_first_not_of(onestring("🦊 "), 15), 18u);
+            PL_ASSERT_EQUAL(test.find_first_not_of(onechar("🦊"), 16), 17u);
+            PL_ASSERT_EQUAL(test.find_first_not_of(test), onestring::npos);
+            return true;
+        }
+};
+
+// P-tB4037
+class TestOnestring_FindFirstOf : public Test
+{
+    protected:
+        onestring test = "The quick brown 🦊 jumped over the lazy 🐶. The 🦊 ran.";
+
+    public:
+        TestOnestring_FindFirstOf(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: find_first_of()";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test finding the first character in a set with find_first_of().";
+        }
+
+        bool run() override
+        {
+            PL_ASSERT_EQUAL(test.find_first_of('e'), 2u);
+            PL_ASSERT_EQUAL(test.find_first_of("aeiou"), 2u);
+            PL_ASSERT_EQUAL(test.find_first_of(std::string("🐶🦊")), 16u);
+            PL_ASSERT_EQUAL(test.find_first_of(onestring("xyz"), 30), 36u);
+            PL_ASSERT_EQUAL(test.find_first_of(onechar("🐶")), 39u);
+            PL_ASSERT_EQUAL(test.find_first_of("🐉"), onestring::npos);
+            PL_ASSERT_EQUAL(test.find_first_of(""), onestring::npos);
+            return true;
+        }
+};
+
+// P-tB4038
+class TestOnestring_FindLastNotOf : public Test
+{
+    protected:
+        onestring test = "The quick brown 🦊 jumped over the lazy 🐶. The 🦊 ran.";
+
+    public:
+        TestOnestring_FindLastNotOf(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: find_last_not_of()";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test finding the last character not in a set with find_last_not_of().";
+        }
+
+        bool run() override
+        {
+            PL_ASSERT_EQUAL(test.find_last_not_of('.'), 50u);
+            PL_ASSERT_EQUAL(test.find_last_not_of(".nar "), 46u);
+            PL_ASSERT_EQUAL(test.find_last_not_of(std::string(".nar🦊 ")), 44u);
+            PL_ASSERT_EQUAL(test.find_last_not_of(onestring(". "), 41), 39u);
+            PL_ASSERT_EQUAL(test.find_last_not_of(onechar("🦊"), 16), 15u);
+            PL_ASSERT_EQUAL(test.find_last_not_of(test), onestring::npos);
+            return true;
+        }
+};
+
+// P-tB4039
+class TestOnestring_RFind : public Test
+{
+    protected:
+        onestring test = "The quick brown 🦊 jumped over the lazy 🐶. The 🦊 ran.";
+        onestring longer;
+
+    public:
+        TestOnestring_RFind(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: rfind()";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test finding the last occurrence of substrings in a onestring with rfind().";
+        }
+
+        bool janitor() override
+        {
+            // Long enough to need several blocks of the vectorized search.
+            longer = "needle🦊";
+            longer.append("🐉abc", 40);
+            return true;
+        }
+
+        bool run() override
+        {
+            PL_ASSERT_EQUAL(test.rfind('e'), 44u);
+            PL_ASSERT_EQUAL(test.rfind(onechar("🦊")), 46u);
+            PL_ASSERT_EQUAL(test.rfind("🦊", 45), 16u);
+            PL_ASSERT_EQUAL(test.rfind(std::string("The")), 42u);
+            PL_ASSERT_EQUAL(test.rfind(onestring("The"), 41), 0u);
+            PL_ASSERT_EQUAL(test.rfind(""), 52u);
+            PL_ASSERT_EQUAL(test.rfind("🐉"), onestring::npos);
+
+            PL_ASSERT_EQUAL(longer.rfind("needle🦊"), 0u);
+            PL_ASSERT_EQUAL(longer.rfind("c🐉a"), 162u);
+            PL_ASSERT_EQUAL(longer.rfind("c🐉a", 161), 158u);
+
+            return true;
+        }
+};
+
+// P-tB4045
+class TestOnestring_FindLastOf : public Test
+{
+    protected:
+        onestring test = "The quick brown 🦊 jumped over the lazy 🐶. The 🦊 ran.";
+
+    public:
+        TestOnestring_FindLastOf(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: find_last_of()";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test finding the last character in a set with find_last_of().";
+        }
+
+        bool run() override
+        {
+            PL_ASSERT_EQUAL(test.find_last_of('T'), 42u);
+            PL_ASSERT_EQUAL(test.find_last_of("🐶🦊"), 46u);
+            PL_ASSERT_EQUAL(test.find_last_of(std::string("🐶🦊"), 40), 39u);
+            PL_ASSERT_EQUAL(test.find_last_of(onestring("q"), 3), onestring::npos);
+            PL_ASSERT_EQUAL(test.find_last_of(onechar("🦊"), 45), 16u);
+            PL_ASSERT_EQUAL(test.find_last_of(""), onestring::npos);
+            return true;
+        }
+};
+
+// P-tB4046
+class TestOnestring_Count : public Test
+{
+    protected:
+        onestring test = "The quick brown 🦊 jumped over the lazy 🐶. The 🦊 ran.";
+
+    public:
+        TestOnestring_Count(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: count() and contains()";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test counting and checking for substrings with count() and contains().";
+        }
+
+        bool run() override
+        {
+            PL_ASSERT_EQUAL(test.count('e'), 5u);
+            PL_ASSERT_EQUAL(test.count(onechar("🦊")), 2u);
+            PL_ASSERT_EQUAL(test.count("The"), 2u);
+            PL_ASSERT_EQUAL(test.count(std::string("🐉")), 0u);
+            PL_ASSERT_EQUAL(test.count(""), 0u);
+
+            // Matches should not overlap.
+            onestring repeated = "🦊🦊🦊🦊🦊";
+            PL_ASSERT_EQUAL(repeated.count(onestring("🦊🦊")), 2u);
+
+            PL_ASSERT_TRUE(test.contains('q'));
+            PL_ASSERT_TRUE(test.contains(onechar("🐶")));
+            PL_ASSERT_TRUE(test.contains("lazy 🐶"));
+            PL_ASSERT_TRUE(test.contains(std::string("")));
+            PL_ASSERT_FALSE(test.contains(onestring("lazy 🦊")));
+
+            // Invalid bytes are searched for as U+FFFD, so they can't match part of a character.
+            onestring accented = "xé";
+            PL_ASSERT_EQUAL(accented.count("\xA9"), 0u);
+            PL_ASSERT_EQUAL(accented.count('\xC3'), 0u);
+            PL_ASSERT_FALSE(accented.contains("\xA9"));
+            PL_ASSERT_FALSE(accented.contains(std::string("\xC3")));
+            PL_ASSERT_EQUAL(onestring("\xA9\xA9").count('\xA9'), 2u);
+            return true;
+        }
+};
+
+// P-tB4047*
+class TestStdString_FindLong : public Test
+{
+    protected:
+        std::string test;
+        size_t found;
+
+    public:
+        TestStdString_FindLong()
+        :found(0)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Find in Long String (std::string)";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Find a substring at the end of a long string with std::string::find().";
+        }
+
+        bool pre() override
+        {
+            for (int i = 0; i < 500; ++i)
+            {
+                test.append("The quick brown 🦊 jumped over the lazy 🐶. ");
+            }
+            test.append("The 🦊 ran.");
+            return true;
+        }
+
+        bool run() override
+        {
+            found = test.find("🦊 ran");
+            return true;
+        }
+
+        bool verify() override
+        {
+            return (found == test.size() - 9);
+        }
+};
+
+// P-tB4047
+class TestOnestring_FindLong : public Test
+{
+    protected:
+        onestring test;
+        size_t found;
+
+    public:
+        TestOnestring_FindLong()
+        :found(0)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Find in Long String";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Find a substring at the end of a long onestring with find().";
+        }
+
+        bool pre() override
+        {
+            for (int i = 0; i < 500; ++i)
+            {
+                test.append("The quick brown 🦊 jumped over the lazy 🐶. ");
+            }
+            test.append("The 🦊 ran.");
+            return true;
+        }
+
+        bool run() override
+        {
+            found = test.find("🦊 ran");
+            return true;
+        }
+
+        bool verify() override
+        {
+            return (found == test.length() - 6);
+        }
+};
+
+// P-tB4048
+class TestOnestring_Validate : public Test
+{
+    public:
+        TestOnestring_Validate(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: UTF-8 Validation";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test that malformed UTF-8 is detected with validate(), and replaced with U+FFFD on the way into a onestring.";
+        }
+
+        bool run() override
+        {
+            // Well-formed input, including the edges of each range.
+            PL_ASSERT_EQUAL(onestring::validate("The quick brown 🦊"), onestring::npos);
+            PL_ASSERT_EQUAL(onestring::validate("\xC2\x80\xDF\xBF\xE0\xA0\x80\xED\x9F\xBF\xF4\x8F\xBF\xBF"), onestring::npos);
+            PL_ASSERT_EQUAL(onestring::validate(""), onestring::npos);
+
+            // Overlong forms, a surrogate, and a value past U+10FFFF.
+            PL_ASSERT_EQUAL(onestring::validate("ab\xC0\xAF"), 2u);
+            PL_ASSERT_EQUAL(onestring::validate("\xE0\x9F\xBF"), 0u);
+            PL_ASSERT_EQUAL(onestring::validate("🦊\xED\xA0\x80"), 4u);
+            PL_ASSERT_EQUAL(onestring::validate("\xF4\x90\x80\x80"), 0u);
+            PL_ASSERT_EQUAL(onestring::validate("\xF5\x80\x80\x80"), 0u);
+
+            // A stray continuation byte, and a truncated sequence.
+            PL_ASSERT_EQUAL(onestring::validate("abcdefghijklmnopqrstuvwxyz\x80"), 26u);
+            PL_ASSERT_EQUAL(onestring::validate(std::string("🐶\xF0\x9F\x90")), 4u);
+            PL_ASSERT_EQUAL(onestring::validate("\xE2\x82" "A"), 0u);
+
+            // Each invalid byte counts, and is stored, as one U+FFFD.
+            PL_ASSERT_EQUAL(onestring::characterCount("a\xE2\x82" "b"), 4u);
+            onestring test = "a\xE2\x82" "b";
+            PL_ASSERT_EQUAL(test.length(), 4u);
+            PL_ASSERT_EQUAL(test, "a\xEF\xBF\xBD\xEF\xBF\xBD" "b");
+
+            test.append(std::string("\xC0"));
+            test.insert(0, "\xFF🦊");
+            test.replace(1, 1, "\x80", 0, 1);
+            PL_ASSERT_EQUAL(test, "\xEF\xBF\xBD\xEF\xBF\xBD" "a\xEF\xBF\xBD\xEF\xBF\xBD" "b\xEF\xBF\xBD");
+            PL_ASSERT_EQUAL(test.length(), 7u);
+            PL_ASSERT_EQUAL(onestring::validate(test.c_str()), onestring::npos);
+            return true;
+        }
+};
+
+// P-tB4049*
+class TestStdString_Ingest : public Test
+{
+    protected:
+        std::string payload;
+        std::string test;
+
+    public:
+        TestStdString_Ingest(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Ingest Long Text (std::string)";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Copy a long, mostly-ASCII UTF-8 payload into a std::string.";
+        }
+
+        bool pre() override
+        {
+            for (int i = 0; i < 200; ++i)
+            {
+                payload.append("The quick brown fox jumped over the lazy dog, and then the 🦊 jumped over the 🐶. ");
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            test = payload;
+            return true;
+        }
+
+        bool verify() override
+        {
+            return (test.size() == payload.size());
+        }
+};
+
+// P-tB4049
+class TestOnestring_Ingest : public Test
+{
+    protected:
+        std::string payload;
+        onestring test;
+
+    public:
+        TestOnestring_Ingest(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Ingest Long Text";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Validate and copy a long, mostly-ASCII UTF-8 payload into a onestring.";
+        }
+
+        bool pre() override
+        {
+            for (int i = 0; i < 200; ++i)
+            {
+                payload.append("The quick brown fox jumped over the lazy dog, and then the 🦊 jumped over the 🐶. ");
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            test = payload;
+            return true;
+        }
+
+        bool verify() override
+        {
+            return (test.size() == payload.size() + 1 && test.length() == 16000u);
+        }
+};
+
+// P-tB4050
+class TestOnestringView_Access : public Test
+{
+    protected:
+        onestring source = "The quick brown 🦊 jumped over the lazy 🐶.";
+
+    public:
+        TestOnestringView_Access(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring View: Access";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test creating, accessing, and narrowing a onestring_view.";
+        }
+
+        bool run() override
+        {
+            onestring_view view = source;
+            PL_ASSERT_TRUE(view.data() == source.c_str());
+            PL_ASSERT_EQUAL(view.length(), source.length());
+            PL_ASSERT_EQUAL(view.size(), source.size() - 1);
+            PL_ASSERT_EQUAL(view.at(16), onechar("🦊"));
+            PL_ASSERT_EQUAL(view[4], onechar("q"));
+            PL_ASSERT_EQUAL(view.front(), onechar("T"));
+            PL_ASSERT_EQUAL(view.back(), onechar("."));
+
+            // A substring is another view of the same text.
+            onestring_view part = view.substr(16, 8);
+            PL_ASSERT_EQUAL(part, "🦊 jumped");
+            PL_ASSERT_TRUE(part.data() == source.c_str() + 16);
+            PL_ASSERT_EQUAL(view.substr(39), "🐶.");
+
+            part.remove_prefix(2);
+            part.remove_suffix(3);
+            PL_ASSERT_EQUAL(part, "jum");
+            PL_ASSERT_EQUAL(part.length(), 3u);
+
+            // Views of other kinds of text are validated.
+            std::string str = "lazy 🐶";
+            onestring_view from_str = str;
+            PL_ASSERT_EQUAL(from_str.length(), 6u);
+            PL_ASSERT_EQUAL(onestring_view("🐉🐉", 4).length(), 1u);
+            PL_ASSERT_TRUE(onestring_view().empty());
+
+            bool threw = false;
+            try { onestring_view bad("ab\x80"); }
+            catch (const std::invalid_argument&) { threw = true; }
+            PL_ASSERT_TRUE(threw);
+
+            threw = false;
+            try { view.substr(view.length()); }
+            catch (const std::out_of_range&) { threw = true; }
+            PL_ASSERT_TRUE(threw);
+
+            // Comparisons work as they do for onestring.
+            PL_ASSERT_TRUE(from_str == view.substr(34, 6));
+            PL_ASSERT_TRUE(from_str != "lazy 🦊");
+            PL_ASSERT_TRUE(from_str < "lazy 🐶 dog");
+            PL_ASSERT_TRUE(from_str > "lazy 🐱");
+            PL_ASSERT_TRUE(onestring("lazy 🐶") == from_str);
+            PL_ASSERT_EQUAL(from_str.compare(onestring("lazy 🐶")), 0);
+            return true;
+        }
+};
+
+// P-tB4051
+class TestOnestringView_Search : public Test
+{
+    protected:
+        onestring source = "The quick brown 🦊 jumped over the lazy 🐶. The 🦊 ran.";
+
+    public:
+        TestOnestringView_Search(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring View: Search";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test the find functions, count(), and contains() on a onestring_view.";
+        }
+
+        bool run() override
+        {
+            onestring_view view = source;
+            PL_ASSERT_EQUAL(view.find("🦊"), 16u);
+            PL_ASSERT_EQUAL(view.find("🦊", 17), 46u);
+            PL_ASSERT_EQUAL(view.rfind("The"), 42u);
+            PL_ASSERT_EQUAL(view.rfind("The", 41), 0u);
+            PL_ASSERT_EQUAL(view.find_first_of("🐶🦊"), 16u);
+            PL_ASSERT_EQUAL(view.find_first_not_of("The "), 4u);
+            PL_ASSERT_EQUAL(view.find_last_of("🐶🦊"), 46u);
+            PL_ASSERT_EQUAL(view.find_last_not_of(" .nar"), 46u);
+            PL_ASSERT_EQUAL(view.count("🦊"), 2u);
+            PL_ASSERT_TRUE(view.contains("lazy 🐶"));
+            PL_ASSERT_FALSE(view.contains("lazy 🦊"));
+
+            // Results are relative to the view, not the text it views.
+            onestring_view tail = view.substr(40);
+            PL_ASSERT_EQUAL(tail.find("🦊"), 6u);
+            PL_ASSERT_EQUAL(tail.find_first_of("T"), 2u);
+
+            // A onestring can search with a view.
+            PL_ASSERT_EQUAL(source.find(tail.substr(2, 3)), 0u);
+            PL_ASSERT_EQUAL(source.rfind(tail.substr(2, 3)), 42u);
+            PL_ASSERT_EQUAL(source.count(onestring_view("🦊")), 2u);
+            return true;
+        }
+};
+
+// P-tB4052
+class TestOnestringView_Iterate : public Test
+{
+    protected:
+        onestring source = "🦊 and 🐶";
+
+    public:
+        TestOnestringView_Iterate(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring View: Iterate";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test iterating over the characters in a onestring_view.";
+        }
+
+        bool run() override
+        {
+            onestring_view view = source;
+            onestring forward;
+            for (onechar ochr : view)
+            {
+                forward.push_back(ochr);
+            }
+            PL_ASSERT_EQUAL(forward, source);
+
+            onestring backward;
+            onestring_view::const_iterator it = view.end();
+            while (it != view.begin())
+            {
+                --it;
+                backward.push_back(*it);
+            }
+            PL_ASSERT_EQUAL(backward, "🐶 dna 🦊");
+
+            PL_ASSERT_EQUAL(std::distance(view.begin(), view.end()), 7);
+            return true;
+        }
+};
+
+// P-tB4053
+class TestOnestring_FromView : public Test
+{
+    protected:
+        std::string text = "The quick brown 🦊 jumped over the lazy 🐶.";
+
+    public:
+        TestOnestring_FromView(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Using Views";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test building and modifying a onestring with onestring_views.";
+        }
+
+        bool run() override
+        {
+            onestring_view view = text;
+            onestring test(view.substr(4, 5));
+            PL_ASSERT_EQUAL(test, "quick");
+
+            test.append(view.substr(15, 2));
+            test.insert(0, view.substr(34, 5));
+            test.replace(5, 5, view.substr(16, 1));
+            PL_ASSERT_EQUAL(test, "lazy 🦊 🦊");
+            PL_ASSERT_EQUAL(test.length(), 8u);
+
+            test += view.substr(39);
+            PL_ASSERT_EQUAL(test, "lazy 🦊 🦊🐶.");
+            PL_ASSERT_EQUAL(test + view.substr(40), "lazy 🦊 🦊🐶..");
+            PL_ASSERT_TRUE(test.equals(onestring_view("lazy 🦊 🦊🐶.")));
+
+            // A onestring may be assigned a view of part of itself.
+            test = onestring_view(test).substr(5, 3);
+            PL_ASSERT_EQUAL(test, "🦊 🦊");
+            return true;
+        }
+};
+
+// P-tB4054*
+class TestStdString_Tokenize : public Test
+{
+    protected:
+        std::string text;
+        size_t tokens;
+
+    public:
+        TestStdString_Tokenize()
+        :tokens(0)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Tokenize (std::string_view)";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Split a long string into words with std::string_view.";
+        }
+
+        bool pre() override
+        {
+            for (int i = 0; i < 100; ++i)
+            {
+                text.append("The quick brown 🦊 jumped over the lazy 🐶. ");
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            std::string_view rest = text;
+            tokens = 0;
+            while (!rest.empty())
+            {
+                size_t end = rest.find(' ');
+                if (end == std::string_view::npos) { end = rest.size(); }
+                std::string_view token = rest.substr(0, end);
+                if (!token.empty()) { ++tokens; }
+                rest.remove_prefix((end < rest.size()) ? end + 1 : end);
+            }
+            return true;
+        }
+
+        bool verify() override
+        {
+            return (tokens == 900);
+        }
+};
+
+// P-tB4054
+class TestOnestringView_Tokenize : public Test
+{
+    protected:
+        onestring text;
+        size_t tokens;
+
+    public:
+        TestOnestringView_Tokenize()
+        :tokens(0)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Tokenize (onestring_view)";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Split a long onestring into words with onestring_view, without allocating.";
+        }
+
+        bool pre() override
+        {
+            for (int i = 0; i < 100; ++i)
+            {
+                text.append("The quick brown 🦊 jumped over the lazy 🐶. ");
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            onestring_view rest = text;
+            tokens = 0;
+            while (!rest.empty())
+            {
+                size_t end = rest.find(" ");
+                if (end == onestring_view::npos) { end = rest.length(); }
+                onestring_view token = (end > 0) ? rest.substr(0, end) : onestring_view();
+                if (!token.empty()) { ++tokens; }
+                rest.remove_prefix((end < rest.length()) ? end + 1 : end);
+            }
+            return true;
+        }
+
+        bool verify() override
+        {
+            return (tokens == 900);
+        }
+};
+
+// P-tB4055
+class TestOnestring_Hash : public Test
+{
+    public:
+        TestOnestring_Hash(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Hash";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test hashing onestrings, and using them as keys in a std::unordered_map.";
+        }
+
+        bool run() override
+        {
+            onestring test = "The quick brown 🦊 jumped over the lazy 🐶.";
+            onestring same = test;
+
+            // These must not depend on whether SSE2 is available.
+            PL_ASSERT_EQUAL(test.hash(), 18329239681378554781u);
+            PL_ASSERT_EQUAL(onestring("🦊").hash(42), 7732916207872321554u);
+
+            PL_ASSERT_EQUAL(test.hash(), same.hash());
+            PL_ASSERT_EQUAL(test.hash(), onestring_view(test).hash());
+            PL_ASSERT_EQUAL(test.hash(7), onestring_view(test).hash(7));
+            PL_ASSERT_EQUAL(test.hash(0), test.hash());
+            PL_ASSERT_NOT_EQUAL(test.hash(), test.hash(7));
+            PL_ASSERT_EQUAL(std::hash<onestring>()(test), test.hash());
+
+            // Any change must replace the kept hash.
+            size_t before = test.hash();
+            test[4] = 'Q';
+            PL_ASSERT_NOT_EQUAL(test.hash(), before);
+            PL_ASSERT_EQUAL(test.hash(), onestring(test.c_str()).hash());
+            test[4] = 'q';
+            PL_ASSERT_EQUAL(test.hash(), before);
+            test.append('!');
+            PL_ASSERT_EQUAL(test.hash(), onestring(test.c_str()).hash());
+            test.pop_back();
+            PL_ASSERT_EQUAL(test.hash(), before);
+
+            // Moving and swapping carry the hash along.
+            onestring other = "lazy 🐶";
+            size_t other_hash = other.hash();
+            test.swap(other);
+            PL_ASSERT_EQUAL(test.hash(), other_hash);
+            PL_ASSERT_EQUAL(other.hash(), before);
+            onestring moved = std::move(other);
+            PL_ASSERT_EQUAL(moved.hash(), before);
+            PL_ASSERT_EQUAL(other.hash(), onestring().hash());
+
+            std::unordered_map<onestring, int> map;
+            map["🦊"] = 1;
+            map[onestring("🐶")] = 2;
+            map["🦊"] += 2;
+            PL_ASSERT_EQUAL(map.size(), 2u);
+            PL_ASSERT_EQUAL(map.at("🦊"), 3);
+            PL_ASSERT_EQUAL(map.count("🐱"), 0u);
+            return true;
+        }
+};
+
+// P-tB4056*
+class TestStdString_HashLong : public Test
+{
+    protected:
+        std::string test;
+        size_t result;
+
+    public:
+        TestStdString_HashLong()
+        :result(0)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Hash Long String (std::string)";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Hash a long string with std::hash<std::string>.";
+        }
+
+        bool pre() override
+        {
+            for (int i = 0; i < 100; ++i)
+            {
+                test.append("The quick brown 🦊 jumped over the lazy 🐶. ");
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            result = std::hash<std::string>()(test);
+            return true;
+        }
+};
+
+// P-tB4056
+class TestOnestring_HashLong : public Test
+{
+    protected:
+        onestring test;
+        size_t result;
+
+    public:
+        TestOnestring_HashLong()
+        :result(0)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Hash Long String";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Hash a long onestring, with a seed so the hash isn't kept.";
+        }
+
+        bool pre() override
+        {
+            for (int i = 0; i < 100; ++i)
+            {
+                test.append("The quick brown 🦊 jumped over the lazy 🐶. ");
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            result = test.hash(1);
+            return true;
+        }
+};
+
+// P-tB4057
+class TestOnestring_Intern : public Test
+{
+    public:
+        TestOnestring_Intern(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Intern";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test interning onestrings, including from several threads at once.";
+        }
+
+        bool run() override
+        {
+            onestring_interner table;
+            onestring fox = "The quick brown 🦊";
+
+            onestring_interner::handle a = table.intern(fox);
+            onestring_interner::handle b = table.intern("The quick brown 🦊");
+            onestring_interner::handle c = table.intern(onestring_view(fox).substr(0, 9));
+            PL_ASSERT_TRUE(a == b);
+            PL_ASSERT_TRUE(a != c);
+            PL_ASSERT_EQUAL(table.size(), 2u);
+
+            // The handle refers to the interner's copy, not the original.
+            PL_ASSERT_TRUE(a.c_str() != fox.c_str());
+            PL_ASSERT_EQUAL(strcmp(a.c_str(), fox.c_str()), 0);
+            PL_ASSERT_TRUE(a.view() == fox);
+            PL_ASSERT_TRUE(a.str() == fox);
+            PL_ASSERT_EQUAL(a.length(), fox.length());
+            PL_ASSERT_EQUAL(a.size(), fox.size() - 1);
+            PL_ASSERT_EQUAL(a.hash(), fox.hash());
+            PL_ASSERT_TRUE(c.view() == "The quick");
+
+            PL_ASSERT_TRUE(table.find("The quick") == c);
+            PL_ASSERT_FALSE(static_cast<bool>(table.find("The slow")));
+            PL_ASSERT_TRUE(onestring_interner::handle() == table.find("The slow"));
+            PL_ASSERT_EQUAL(table.size(), 2u);
+
+            // Empty text can be interned too.
+            onestring_interner::handle empty = table.intern("");
+            PL_ASSERT_TRUE(static_cast<bool>(empty));
+            PL_ASSERT_EQUAL(empty.size(), 0u);
+            PL_ASSERT_EQUAL(empty.c_str()[0], '\0');
+
+            // Handles must stay put as the table grows.
+            const char* before = a.c_str();
+            std::unordered_set<onestring_interner::handle> seen;
+            for (int i = 0; i < 5000; ++i)
+            {
+                seen.insert(table.intern(onestring(std::to_string(i))));
+            }
+            PL_ASSERT_EQUAL(seen.size(), 5000u);
+            PL_ASSERT_EQUAL(table.size(), 5003u);
+            PL_ASSERT_TRUE(a.c_str() == before);
+            PL_ASSERT_TRUE(table.intern(fox) == a);
+
+            // Text too long for one block of storage gets its own.
+            onestring huge;
+            for (int i = 0; i < 4000; ++i)
+            {
+                huge.append("lazy 🐶 ");
+            }
+            onestring_interner::handle h = table.intern(huge);
+            PL_ASSERT_TRUE(h.view() == huge);
+            PL_ASSERT_TRUE(table.find(huge) == h);
+
+            // Every thread must get the same handle for the same text.
+            onestring_interner shared;
+            onestring_interner::handle results[4][500];
+            std::thread threads[4];
+            for (int t = 0; t < 4; ++t)
+            {
+                threads[t] = std::thread([&shared, &results, t]()
+                {
+                    for (int i = 0; i < 500; ++i)
+                    {
+                        results[t][i] = shared.intern(onestring(std::to_string(i)));
+                    }
+                });
+            }
+            for (std::thread& thread : threads)
+            {
+                thread.join();
+            }
+            PL_ASSERT_EQUAL(shared.size(), 500u);
+            for (int t = 1; t < 4; ++t)
+            {
+                for (int i = 0; i < 500; ++i)
+                {
+                    PL_ASSERT_TRUE(results[t][i] == results[0][i]);
+                }
+            }
+            return true;
+        }
+};
+
+// P-tB4058*
+class TestStdString_InternRepeat : public Test
+{
+    protected:
+        std::unordered_set<std::string> table;
+        std::string keys[64];
+        size_t result;
+
+    public:
+        TestStdString_InternRepeat()
+        :result(0)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Intern Repeated Keys (std::string)";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Look up repeated keys in a std::unordered_set of std::string.";
+        }
+
+        bool pre() override
+        {
+            for (int i = 0; i < 64; ++i)
+            {
+                keys[i] = "telemetry.🦊." + std::to_string(i);
+                table.insert(keys[i]);
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            for (int i = 0; i < 64; ++i)
+            {
+                result += table.insert(keys[i]).first->size();
+            }
+            return true;
+        }
+};
+
+// P-tB4058
+class TestOnestring_InternRepeat : public Test
+{
+    protected:
+        onestring_interner table;
+        onestring keys[64];
+        size_t result;
+
+    public:
+        TestOnestring_InternRepeat()
+        :result(0)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Intern Repeated Keys";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Intern keys that have already been interned.";
+        }
+
+        bool pre() override
+        {
+            for (int i = 0; i < 64; ++i)
+            {
+                keys[i] = "telemetry.🦊." + std::to_string(i);
+                table.intern(keys[i]);
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            for (int i = 0; i < 64; ++i)
+            {
+                result += table.intern(keys[i]).size();
+            }
+            return true;
+        }
+};
+
+// P-tB4059
+class TestOnestring_RandomEdits : public Test
+{
+    protected:
+        // One character of each UTF-8 byte length.
+        const char* pattern[4] = {"a", "é", "⛰", "🐉"};
+
+        // A run of up to five characters of random widths.
+        std::vector<std::string> make_run(TestRandom& random)
+        {
+            std::vector<std::string> run;
+            for (size_t n = random.next(6); n > 0; --n)
+            {
+                run.push_back(pattern[random.next(4)]);
+            }
+            return run;
+        }
+
+        std::string join(const std::vector<std::string>& chars)
+        {
+            std::string joined;
+            for (const std::string& ch : chars)
+            {
+                joined += ch;
+            }
+            return joined;
+        }
+
+    public:
+        TestOnestring_RandomEdits(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Random Edits";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test inserting, erasing, and replacing runs of characters of random widths at random places in a long onestring, checking all of it after every edit.";
+        }
+
+        bool run() override
+        {
+            // A fixed sequence, so every run makes the same edits.
+            TestRandom random;
+
+            onestring test;
+            std::vector<std::string> expect;
+            for (size_t i = 0; i < 2000; ++i)
+            {
+                const char* ch = pattern[random.next(4)];
+                test.append(ch);
+                expect.push_back(ch);
+            }
+
+            for (int edit = 0; edit < 1500; ++edit)
+            {
+                size_t pos = random.next(expect.size() + 1);
+                size_t len = std::min(random.next(6), expect.size() - pos);
+                std::vector<std::string> run = make_run(random);
+                switch (edit % 3)
+                {
+                    case 0:
+                        test.insert(pos, join(run));
+                        expect.insert(expect.begin() + pos, run.begin(), run.end());
+                        break;
+                    case 1:
+                        test.erase(pos, len);
+                        expect.erase(expect.begin() + pos, expect.begin() + pos + len);
+                        break;
+                    default:
+                        test.replace(pos, len, join(run));
+                        expect.erase(expect.begin() + pos, expect.begin() + pos + len);
+                        expect.insert(expect.begin() + pos, run.begin(), run.end());
+                        break;
+                }
+
+                PL_ASSERT_EQUAL(test.length(), expect.size());
+                PL_ASSERT_EQUAL(test.c_str(), join(expect).c_str());
+                // The bytes are right; make sure the index agrees, far from
+                // the edit, at the end, and at the edit.
+                if (!expect.empty())
+                {
+                    size_t far = random.next(expect.size());
+                    PL_ASSERT_EQUAL(test.at(far), expect[far].c_str());
+                    size_t last = expect.size() - 1;
+                    PL_ASSERT_EQUAL(test.at(last), expect[last].c_str());
+                    if (pos < expect.size())
+                    {
+                        PL_ASSERT_EQUAL(test.at(pos), expect[pos].c_str());
+                    }
+                }
+            }
+
+            // Finally, check every character, back to front.
+            size_t i = expect.size();
+            while (i-- > 0)
+            {
+                PL_ASSERT_EQUAL(test.at(i), expect[i].c_str());
+            }
+            return true;
+        }
+};
+
+// P-tB4060*
+class TestStdString_EditLong : public Test
+{
+    protected:
+        std::string test;
+
+    public:
+        TestStdString_EditLong(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Random Edits in Long String (std::string)";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Insert, erase, and replace at random places in a 1 MB std::string.";
+        }
+
+        bool pre() override
+        {
+            for (int i = 0; i < 23000; ++i)
+            {
+                test.append("The quick brown 🦊 jumped over the lazy 🐶. ");
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            // std::string uses bytes instead of characters, but the same edits.
+            TestRandom random;
+
+            for (int i = 0; i < 8; ++i)
+            {
+                test.insert(random.next(test.size()), "🦊 fox");
+                test.erase(random.next(test.size() - 6), 6);
+                test.replace(random.next(test.size() - 3), 3, "🐶🐶🐶");
+            }
+            return true;
+        }
+};
+
+// P-tB4060
+class TestOnestring_EditLong : public Test
+{
+    protected:
+        onestring test;
+
+    public:
+        TestOnestring_EditLong(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Random Edits in Long String";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Insert, erase, and replace at random places in a 1 MB onestring.";
+        }
+
+        bool pre() override
+        {
+            for (int i = 0; i < 23000; ++i)
+            {
+                test.append("The quick brown 🦊 jumped over the lazy 🐶. ");
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            TestRandom random;
+
+            for (int i = 0; i < 8; ++i)
+            {
+                test.insert(random.next(test.length()), "🦊 fox");
+                test.erase(random.next(test.length() - 6), 6);
+                test.replace(random.next(test.length() - 3), 3, "🐶🐶🐶");
+            }
+            return true;
+        }
+};
+
+// P-tB4061
+class TestOnestringRope_Edit : public Test
+{
+    protected:
+        // One character of each UTF-8 byte length.
+        const char* pattern[4] = {"a", "é", "⛰", "🐉"};
+
+    public:
+        TestOnestringRope_Edit(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring Rope: Random Edits";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test inserting, erasing, and replacing at random places in a long onestring_rope, checking it against a onestring making the same edits.";
+        }
+
+        bool run() override
+        {
+            onestring expect;
+            for (size_t i = 0; i < 6000; ++i)
+            {
+                expect.append(pattern[i % 4]);
+            }
+            onestring_rope test(expect);
+            PL_ASSERT_EQUAL(test.length(), expect.length());
+            PL_ASSERT_EQUAL(test.size(), expect.size() - 1);
+
+            // A fixed sequence, so every run makes the same edits.
+            TestRandom random;
+
+            for (int edit = 0; edit < 600; ++edit)
+            {
+                size_t pos = random.next(expect.length());
+                onestring text;
+                for (size_t n = random.next(5); n > 0; --n)
+                {
+                    text.append(pattern[random.next(4)]);
+                }
+                size_t len = random.next(4);
+                switch (edit % 3)
+                {
+                    case 0:
+                        test.insert(pos, text);
+                        expect.insert(pos, text);
+                        break;
+                    case 1:
+                        test.erase(pos, len);
+                        expect.erase(pos, len);
+                        break;
+                    default:
+                        test.replace(pos, len, text);
+                        expect.replace(pos, len, text);
+                        break;
+                }
+
+                PL_ASSERT_EQUAL(test.length(), expect.length());
+                size_t far = random.next(expect.length());
+                PL_ASSERT_EQUAL(test.at(far), expect.at(far));
+                if (pos < expect.length())
+                {
+                    PL_ASSERT_EQUAL(test[pos], expect[pos]);
+                }
+            }
+
+            // Finally, check everything.
+            PL_ASSERT_TRUE(test.equals(expect));
+            PL_ASSERT_TRUE(test.str() == expect);
+
+            size_t i = 0;
+            for (onestring_rope::const_iterator it = test.begin(); it != test.end(); ++it)
+            {
+                PL_ASSERT_EQUAL(*it, expect[i++]);
+            }
+            PL_ASSERT_EQUAL(i, expect.length());
+
+            // And back again.
+            onestring_rope::const_iterator it = test.end();
+            while (i-- > 0)
+            {
+                --it;
+                PL_ASSERT_EQUAL(*it, expect[i]);
+            }
+            return true;
+        }
+};
+
+// P-tB4062
+class TestOnestringRope_Share : public Test
+{
+    public:
+        TestOnestringRope_Share(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring Rope: Sharing";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test copying, slicing, and joining onestring_ropes, which share their text.";
+        }
+
+        bool run() override
+        {
+            onestring_rope empty;
+            PL_ASSERT_TRUE(empty.empty());
+            PL_ASSERT_EQUAL(empty.length(), 0u);
+            PL_ASSERT_TRUE(empty.begin() == empty.end());
+            PL_ASSERT_TRUE(empty == onestring_view(""));
+
+            onestring_rope fox("The quick brown 🦊 jumped over the lazy 🐶.");
+            PL_ASSERT_EQUAL(fox.length(), 41u);
+            PL_ASSERT_EQUAL(fox.front(), 'T');
+            PL_ASSERT_EQUAL(fox.back(), '.');
+            PL_ASSERT_EQUAL(fox.at(16), "🦊");
+
+            // Copies are independent, though they share their text.
+            onestring_rope copy = fox;
+            copy.replace(16, 1, onestring_view("fox"));
+            PL_ASSERT_TRUE(fox == onestring_view("The quick brown 🦊 jumped over the lazy 🐶."));
+            PL_ASSERT_TRUE(copy == onestring_view("The quick brown fox jumped over the lazy 🐶."));
+            PL_ASSERT_TRUE(fox != copy);
+
+            PL_ASSERT_TRUE(fox.substr(16, 1) == onestring_view("🦊"));
+            PL_ASSERT_TRUE(fox.substr(39) == onestring_view("🐶."));
+            PL_ASSERT_TRUE(fox.substr(41).empty());
+
+            // Build a long rope by doubling, then check its parts.
+            onestring_rope big = fox;
+            for (int i = 0; i < 12; ++i)
+            {
+                big += big;
+            }
+            PL_ASSERT_EQUAL(big.length(), 41u * 4096u);
+            PL_ASSERT_TRUE(big.substr(41 * 1000, 41) == fox);
+            PL_ASSERT_EQUAL(big.at(41 * 4095 + 39), "🐶");
+
+            onestring_rope joined = fox + copy;
+            PL_ASSERT_TRUE(joined.substr(0, 41) == fox);
+            PL_ASSERT_TRUE(joined.substr(41) == copy);
+            PL_ASSERT_TRUE(static_cast<onestring>(joined) ==
+                           "The quick brown 🦊 jumped over the lazy 🐶.The quick brown fox jumped over the lazy 🐶.");
+
+            // Invalid UTF-8 is repaired, as it is in onestring.
+            onestring_rope bad(std::string("a\xFF" "b"));
+            PL_ASSERT_EQUAL(bad.length(), 3u);
+            PL_ASSERT_TRUE(bad.str() == onestring(std::string("a\xFF" "b")));
+
+            try
+            {
+                fox.insert(42, onestring_view("!"));
+                return false;
+            }
+            catch (std::out_of_range&) {}
+
+            fox.clear();
+            PL_ASSERT_TRUE(fox.empty());
+            PL_ASSERT_EQUAL(copy.length(), 43u);
+            return true;
+        }
+};
+
+// P-tB4063
+class TestOnestringRope_EditLong : public Test
+{
+    protected:
+        onestring_rope test;
+
+    public:
+        TestOnestringRope_EditLong(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring Rope: Random Edits in Long String";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Insert, erase, and replace at random places in a 1 MB onestring_rope.";
+        }
+
+        bool pre() override
+        {
+            onestring text;
+            for (int i = 0; i < 23000; ++i)
+            {
+                text.append("The quick brown 🦊 jumped over the lazy 🐶. ");
+            }
+            test = onestring_rope(text);
+            return true;
+        }
+
+        bool run() override
+        {
+            TestRandom random;
+
+            for (int i = 0; i < 8; ++i)
+            {
+                test.insert(random.next(test.length()), onestring_view("🦊 fox"));
+                test.erase(random.next(test.length() - 6), 6);
+                test.replace(random.next(test.length() - 3), 3, onestring_view("🐶🐶🐶"));
+            }
+            return true;
+        }
+};
+
+// P-tB4064
+class TestOnestring_Concat : public Test
+{
+    public:
+        TestOnestring_Concat(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Concat";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test building onestrings from mixed pieces with concat() and append_all().";
+        }
+
+        bool run() override
+        {
+            onestring fox = "🦊";
+            std::string dog = "🐶";
+            onechar dragon = "🐉";
+            onestring_view view("jumped");
+
+            onestring test = onestring::concat("The quick brown ", fox, ' ', view,
+                                               " over the lazy ", dog, '.');
+            PL_ASSERT_EQUAL(test, "The quick brown 🦊 jumped over the lazy 🐶.");
+            PL_ASSERT_EQUAL(test.length(), 41u);
+
+            // Numbers, bools, and onechars.
+            test = onestring::concat(dragon, -42, ' ', 7u, ' ', 0.5, ' ', true, ' ', false);
+            PL_ASSERT_EQUAL(test, "🐉-42 7 0.5 true false");
+            PL_ASSERT_EQUAL(test.length(), 21u);
+            PL_ASSERT_EQUAL(test.at(0), "🐉");
+
+            PL_ASSERT_EQUAL(onestring::concat(), "");
+            PL_ASSERT_TRUE(onestring::concat("", "").empty());
+
+            // Invalid UTF-8 is repaired, as it is by append().
+            test = onestring::concat("a", std::string("\xFF"), '\x80', "b");
+            PL_ASSERT_EQUAL(test, "a\xEF\xBF\xBD\xEF\xBF\xBD" "b");
+            PL_ASSERT_EQUAL(test.length(), 4u);
+
+            // A long result, which must go on the heap.
+            test = onestring::concat(fox, "0123456789012345678901234567890123456789", dog);
+            PL_ASSERT_EQUAL(test.length(), 42u);
+            PL_ASSERT_EQUAL(test.at(41), "🐶");
+            PL_ASSERT_EQUAL(test.capacity(), test.size() - 1);
+
+            // Appending to an existing string, including from itself.
+            test = "ab🐉";
+            test.append_all(test, 1, test);
+            PL_ASSERT_EQUAL(test, "ab🐉ab🐉1ab🐉");
+
+            onestring expect;
+            for (int i = 0; i < 500; ++i)
+            {
+                test.append_all(fox, i, ',');
+                expect.append(fox);
+                expect.append(std::to_string(i));
+                expect.append(',');
+            }
+            PL_ASSERT_EQUAL(test.substr(10), expect);
+            PL_ASSERT_EQUAL(test.at(test.length() - 5), "🦊");
+            return true;
+        }
+};
+
+// P-tB4065*
+class TestStdString_ConcatChain : public Test
+{
+    protected:
+        std::string name = "The quick brown 🦊 jumped over";
+        std::string place = "the lazy 🐶 by the riverbank";
+
+    public:
+        TestStdString_ConcatChain(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Concat Chain (std::string)";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Build a thousand std::strings from seven mixed pieces with +.";
+        }
+
+        bool run() override
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                std::string r = name + ' ' + place + " at " + std::to_string(i) +
+                                ":" + std::to_string(i * 7) + '.';
+                if (r.empty()) { return false; }
+            }
+            return true;
+        }
+};
+
+// P-tB4065
+class TestOnestring_ConcatChain : public Test
+{
+    protected:
+        onestring name = "The quick brown 🦊 jumped over";
+        onestring place = "the lazy 🐶 by the riverbank";
+
+    public:
+        TestOnestring_ConcatChain(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Concat Chain";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Build a thousand onestrings from seven mixed pieces with concat().";
+        }
+
+        bool run() override
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                onestring r = onestring::concat(name, ' ', place, " at ", i, ":", i * 7, '.');
+                if (r.empty()) { return false; }
+            }
+            return true;
+        }
+};
+
+// P-tB4066
+class TestOnestring_StartsEndsWith : public Test
+{
+    public:
+        TestOnestring_StartsEndsWith(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Starts With and Ends With";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test checking the start and end of onestrings and onestring_views.";
+        }
+
+        bool run() override
+        {
+            onestring test = "🦊 jumped over the lazy 🐶";
+            PL_ASSERT_TRUE(test.starts_with("🦊 jumped"));
+            PL_ASSERT_TRUE(test.starts_with(onechar("🦊")));
+            PL_ASSERT_TRUE(test.starts_with(std::string("🦊")));
+            PL_ASSERT_TRUE(test.starts_with(onestring()));
+            PL_ASSERT_TRUE(test.starts_with(test));
+            PL_ASSERT_FALSE(test.starts_with("🐶"));
+            PL_ASSERT_FALSE(test.starts_with(onestring("🦊 jumped over the lazy 🐶!")));
+
+            PL_ASSERT_TRUE(test.ends_with("lazy 🐶"));
+            PL_ASSERT_TRUE(test.ends_with(onechar("🐶")));
+            PL_ASSERT_TRUE(test.ends_with(onestring_view("🐶")));
+            PL_ASSERT_TRUE(test.ends_with(""));
+            PL_ASSERT_FALSE(test.ends_with('y'));
+            PL_ASSERT_FALSE(test.ends_with("!🦊 jumped over the lazy 🐶"));
+
+            // Part of a character is never a match.
+            PL_ASSERT_FALSE(test.starts_with("\xF0\x9F"));
+            PL_ASSERT_FALSE(test.starts_with('\xF0'));
+            PL_ASSERT_FALSE(test.ends_with("\x90\xB6"));
+
+            onestring letter = "a";
+            PL_ASSERT_TRUE(letter.starts_with('a'));
+            PL_ASSERT_TRUE(letter.ends_with('a'));
+
+            onestring_view view(test);
+            view.remove_prefix(2);
+            PL_ASSERT_TRUE(view.starts_with(onestring_view("jumped")));
+            PL_ASSERT_TRUE(view.ends_with(onestring_view("🐶")));
+            PL_ASSERT_FALSE(view.starts_with(onestring_view("🦊")));
+            PL_ASSERT_FALSE(view.ends_with(onestring_view("over")));
+            return true;
+        }
+};
+
+// P-tB4067*
+class TestStdString_Sort : public Test
+{
+    protected:
+        std::vector<std::string> words;
+
+    public:
+        TestStdString_Sort(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Sort (std::string)";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Sort five thousand std::strings of similar lengths, which share long prefixes.";
+        }
+
+        bool pre() override
+        {
+            const char* pattern[4] = {"a", "é", "⛰", "🐉"};
+            TestRandom random;
+            for (int i = 0; i < 5000; ++i)
+            {
+                std::string word = "The quick brown 🦊 jumped over the lazy 🐶 ";
+                for (int j = 0; j < 8; ++j)
+                {
+                    word += pattern[random.next(4)];
+                }
+                words.push_back(word);
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            std::vector<std::string> sorted = words;
+            std::sort(sorted.begin(), sorted.end());
+            return true;
+        }
+};
+
+// P-tB4067
+class TestOnestring_Sort : public Test
+{
+    protected:
+        std::vector<onestring> words;
+
+    public:
+        TestOnestring_Sort(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Sort";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Sort five thousand onestrings of similar lengths, which share long prefixes.";
+        }
+
+        bool pre() override
+        {
+            const char* pattern[4] = {"a", "é", "⛰", "🐉"};
+            TestRandom random;
+            for (int i = 0; i < 5000; ++i)
+            {
+                onestring word = "The quick brown 🦊 jumped over the lazy 🐶 ";
+                for (int j = 0; j < 8; ++j)
+                {
+                    word += pattern[random.next(4)];
+                }
+                words.push_back(word);
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            std::vector<onestring> sorted = words;
+            std::sort(sorted.begin(), sorted.end());
+            return true;
+        }
+};
+
+// P-tB4068
+class TestOnestringReader_Records : public Test
+{
+    public:
+        TestOnestringReader_Records(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring Reader: Records";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test splitting a stream into records, including records longer than the buffer and delimiters cut off by the end of it.";
+        }
+
+        bool run() override
+        {
+            // Lines, including an empty one, and a last one with no newline.
+            std::istringstream lines("The quick brown 🦊\n\njumped over the lazy 🐶");
+            onestring_reader reader(lines);
+            onestring_view line;
+            PL_ASSERT_TRUE(reader.next(line));
+            PL_ASSERT_TRUE(line == onestring_view("The quick brown 🦊"));
+            PL_ASSERT_EQUAL(line.length(), 17u);
+            PL_ASSERT_TRUE(reader.next(line));
+            PL_ASSERT_TRUE(line.empty());
+            PL_ASSERT_TRUE(reader.next(line));
+            PL_ASSERT_TRUE(line == onestring_view("jumped over the lazy 🐶"));
+            PL_ASSERT_FALSE(reader.next(line));
+            PL_ASSERT_EQUAL(reader.records(), 3u);
+
+            // A tiny buffer forces refills, growth, and split delimiters.
+            std::string text;
+            for (int i = 0; i < 200; ++i)
+            {
+                text.append(static_cast<size_t>(i % 13), 'a');
+                text.append("🐉");
+                text.append("🦊🐶");
+            }
+            std::istringstream records(text);
+            onestring_reader small(records, onestring_view("🦊🐶"), 5);
+            onestring record;
+            for (int i = 0; i < 200; ++i)
+            {
+                PL_ASSERT_TRUE(small.next(record));
+                PL_ASSERT_EQUAL(record.length(), static_cast<size_t>(i % 13) + 1);
+                PL_ASSERT_EQUAL(record.back(), "🐉");
+            }
+            PL_ASSERT_FALSE(small.next(record));
+
+            // Invalid UTF-8 is repaired, as it is in onestring.
+            std::istringstream bad("a\xFF" "b\nok\n");
+            onestring_reader repairs(bad);
+            PL_ASSERT_TRUE(repairs.next(line));
+            PL_ASSERT_TRUE(line == onestring_view("a\xEF\xBF\xBD" "b"));
+            PL_ASSERT_TRUE(repairs.next(line));
+            PL_ASSERT_TRUE(line == onestring_view("ok"));
+            PL_ASSERT_FALSE(repairs.next(line));
+
+            try
+            {
+                onestring_reader none(bad, onestring_view(""));
+                return false;
+            }
+            catch (std::invalid_argument&) {}
+            return true;
+        }
+};
+
+// P-tB4069*
+class TestOnestring_GetLine : public Test
+{
+    protected:
+        std::string text;
+
+    public:
+        TestOnestring_GetLine(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring Reader: Read Lines (onestring::getline)";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Read 1 MB of text, line by line, with onestring::getline() into a onestring.";
+        }
+
+        bool pre() override
+        {
+            for (int i = 0; i < 23000; ++i)
+            {
+                text.append("The quick brown 🦊 jumped over the lazy 🐶.\n");
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            std::istringstream in(text);
+            onestring line;
+            size_t total = 0;
+            while (onestring::getline(in, line))
+            {
+                total += line.length();
+            }
+            return (total > 0);
+        }
+};
+
+// P-tB4069
+class TestOnestringReader_ReadLines : public Test
+{
+    protected:
+        std::string text;
+
+    public:
+        TestOnestringReader_ReadLines(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring Reader: Read Lines";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Read 1 MB of text, line by line, with onestring_reader into a onestring_view.";
+        }
+
+        bool pre() override
+        {
+            for (int i = 0; i < 23000; ++i)
+            {
+                text.append("The quick brown 🦊 jumped over the lazy 🐶.\n");
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            std::istringstream in(text);
+            onestring_reader reader(in);
+            onestring_view line;
+            size_t total = 0;
+            while (reader.next(line))
+            {
+                total += line.length();
+            }
+            return (total > 0);
+        }
+};
+
+// P-tB4070
+class TestOnestring_Transcode : public Test
+{
+    public:
+        TestOnestring_Transcode(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Transcode";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test converting between onestring and UTF-16 and UTF-32, including surrogate pairs and invalid code units.";
+        }
+
+        bool run() override
+        {
+            // Long enough that the ASCII runs take the vectorized path.
+            onestring test = "The quick brown 🦊 jumped over the lazy 🐶, and the ё stayed put.";
+            std::u16string u16 = u"The quick brown 🦊 jumped over the lazy 🐶, and the ё stayed put.";
+            std::u32string u32 = U"The quick brown 🦊 jumped over the lazy 🐶, and the ё stayed put.";
+
+            PL_ASSERT_EQUAL(test.utf16_size(), u16.size());
+            PL_ASSERT_EQUAL(test.utf32_size(), u32.size());
+            PL_ASSERT_TRUE(test.to_utf16() == u16);
+            PL_ASSERT_TRUE(test.to_utf32() == u32);
+
+            onestring from16 = onestring::from_utf16(u16);
+            onestring from32 = onestring::from_utf32(u32);
+            PL_ASSERT_TRUE(static_cast<bool>(from16 == test));
+            PL_ASSERT_TRUE(static_cast<bool>(from32 == test));
+            PL_ASSERT_EQUAL(from16.length(), test.length());
+            PL_ASSERT_EQUAL(from32.length(), test.length());
+
+            // The raw buffer versions write no terminator.
+            char16_t units[8] = {u'x', u'x', u'x', u'x', u'x', u'x', u'x', u'x'};
+            onestring dragon = "a🐉";
+            PL_ASSERT_EQUAL(dragon.to_utf16(units), 3u);
+            PL_ASSERT_TRUE(units[0] == u'a' && units[1] == 0xD83D && units[2] == 0xDC09);
+            PL_ASSERT_TRUE(units[3] == u'x');
+
+            // Lone surrogates and out of range values become U+FFFD.
+            const char16_t lone[] = {u'a', 0xD800, u'b', 0xDC00};
+            PL_ASSERT_TRUE(static_cast<bool>(onestring::from_utf16(lone, 4) == "a�b�"));
+            const char32_t bad[] = {U'a', 0xD800, 0x110000, U'🐶'};
+            PL_ASSERT_TRUE(static_cast<bool>(onestring::from_utf32(bad, 4) == "a��🐶"));
+
+            onestring empty;
+            PL_ASSERT_TRUE(empty.to_utf16().empty());
+            PL_ASSERT_TRUE(onestring::from_utf32(U"").empty());
+            return true;
+        }
+};
+
+// P-tB4071*
+class TestOnestring_ToUTF16Chars : public Test
+{
+    protected:
+        onestring text;
+
+    public:
+        TestOnestring_ToUTF16Chars(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: To UTF-16 (per onechar)";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Convert 100 KB of text to UTF-16 one onechar at a time, walking it with a onestring_view.";
+        }
+
+        bool pre() override
+        {
+            for (int i = 0; i < 2300; ++i)
+            {
+                text.append("The quick brown 🦊 jumped over the lazy 🐶.\n");
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            std::u16string out;
+            onestring_view chars(text);
+            for (onestring_view::const_iterator it = chars.begin(); it != chars.end(); ++it)
+            {
+                const unsigned char* b = reinterpret_cast<const unsigned char*>((*it).c_str());
+                char32_t cp;
+                if (b[0] < 0x80) { cp = b[0]; }
+                else if (b[0] < 0xE0) { cp = ((b[0] & 0x1F) << 6) | (b[1] & 0x3F); }
+                else if (b[0] < 0xF0) { cp = ((b[0] & 0x0F) << 12) | ((b[1] & 0x3F) << 6) | (b[2] & 0x3F); }
+                else
+                {
+                    cp = ((b[0] & 0x07) << 18) | ((b[1] & 0x3F) << 12) |
+                         ((b[2] & 0x3F) << 6) | (b[3] & 0x3F);
+                }
+
+                if (cp < 0x10000)
+                {
+                    out.push_back(static_cast<char16_t>(cp));
+                }
+                else
+                {
+                    out.push_back(static_cast<char16_t>(0xD800 + ((cp - 0x10000) >> 10)));
+                    out.push_back(static_cast<char16_t>(0xDC00 + ((cp - 0x10000) & 0x3FF)));
+                }
+            }
+            return (out.size() > 0);
+        }
+};
+
+// P-tB4071
+class TestOnestring_ToUTF16 : public Test
+{
+    protected:
+        onestring text;
+
+    public:
+        TestOnestring_ToUTF16(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: To UTF-16";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Convert 100 KB of text to UTF-16 with onestring::to_utf16().";
+        }
+
+        bool pre() override
+        {
+            for (int i = 0; i < 2300; ++i)
+            {
+                text.append("The quick brown 🦊 jumped over the lazy 🐶.\n");
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            std::u16string out = text.to_utf16();
+            return (out.size() > 0);
+        }
+};
+
+// P-tB4072
+class TestOnestring_CaseMapping : public Test
+{
+    public:
+        TestOnestring_CaseMapping(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Case Mapping";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test mapping a onestring to lowercase and uppercase, in place and into a copy.";
+        }
+
+        bool run() override
+        {
+            // Long enough that the ASCII runs take the vectorized path.
+            onestring test = "The Quick Brown 🦊 Jumped Over The Lazy 🐶: ÀÉÎ, ΣΑΣ, ПРИВЕТ, ԱԲ, Ｆｏｏ, Ḁ.";
+            onestring lower = onestring::to_lower(test);
+            onestring upper = onestring::to_upper(test);
+            PL_ASSERT_TRUE(static_cast<bool>(lower == "the quick brown 🦊 jumped over the lazy 🐶: àéî, σασ, привет, աբ, ｆｏｏ, ḁ."));
+            PL_ASSERT_TRUE(static_cast<bool>(upper == "THE QUICK BROWN 🦊 JUMPED OVER THE LAZY 🐶: ÀÉÎ, ΣΑΣ, ПРИВЕТ, ԱԲ, ＦＯＯ, Ḁ."));
+            PL_ASSERT_EQUAL(lower.length(), test.length());
+
+            // The copies leave the original alone.
+            PL_ASSERT_TRUE(static_cast<bool>(test[1] == "h"));
+
+            // Mapping in place keeps indexes, and changes the hash.
+            size_t hash = test.hash();
+            test.to_upper();
+            PL_ASSERT_TRUE(static_cast<bool>(test == upper));
+            PL_ASSERT_TRUE(static_cast<bool>(test[42] == "À"));
+            PL_ASSERT_TRUE(test.hash() != hash);
+            test.to_lower();
+            PL_ASSERT_TRUE(static_cast<bool>(test == lower));
+            PL_ASSERT_TRUE(static_cast<bool>(test[42] == "à"));
+
+            // Final sigma and ÿ map up, but not back down to themselves.
+            onestring greek = "ς ÿ";
+            greek.to_upper();
+            PL_ASSERT_TRUE(static_cast<bool>(greek == "Σ Ÿ"));
+
+            // Characters which would change length in UTF-8 are left alone.
+            onestring dotless = "ı";
+            dotless.to_upper();
+            PL_ASSERT_TRUE(static_cast<bool>(dotless == "ı"));
+            return true;
+        }
+};
+
+// P-tB4073
+class TestOnestring_ICompare : public Test
+{
+    public:
+        TestOnestring_ICompare(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Case-Insensitive Compare";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test comparing onestrings and other types while ignoring case, with iequals() and icompare().";
+        }
+
+        bool run() override
+        {
+            onestring header = "Content-Type: Text/HTML; Charset=UTF-8";
+            PL_ASSERT_TRUE(header.iequals("content-type: text/html; charset=utf-8"));
+            PL_ASSERT_TRUE(header.iequals(std::string("CONTENT-TYPE: TEXT/HTML; CHARSET=UTF-8")));
+            PL_ASSERT_TRUE(header.iequals(onestring_view("Content-type: text/html; charset=utf-8")));
+            PL_ASSERT_FALSE(header.iequals("content-type: text/html; charset=utf-9"));
+            PL_ASSERT_FALSE(header.iequals("content-type"));
+            PL_ASSERT_EQUAL(header.icompare("CONTENT-TYPE: TEXT/HTML; CHARSET=UTF-8"), 0);
+
+            // Non-ASCII, including two sigmas which fold together.
+            onestring word = "ΟΔΥΣΣΕΥΣ";
+            PL_ASSERT_TRUE(word.iequals("οδυσσευς"));
+            PL_ASSERT_TRUE(word.iequals(onestring("Οδυσσευσ")));
+            PL_ASSERT_TRUE(onestring("Straße").iequals("STRAßE"));
+            PL_ASSERT_TRUE(onestring("Ä").iequals(onechar("ä")));
+            PL_ASSERT_TRUE(onestring("Q").iequals('q'));
+
+            // Order is by length, then by folded value, as with compare().
+            PL_ASSERT_LESS(onestring("APPLE").icompare("banana"), 0);
+            PL_ASSERT_GREATER(onestring("Cherry").icompare("BANANA"), 0);
+            PL_ASSERT_LESS(onestring("Fig").icompare("apple"), 0);
+            PL_ASSERT_LESS(onestring("ÄPFEL").icompare(onestring("äpfelx")), 0);
+            PL_ASSERT_GREATER(onestring("ЯБЛОКО").icompare(onestring("абрико")), 0);
+
+            // Views compare the same way.
+            onestring_view view("Ḁbc");
+            PL_ASSERT_TRUE(view.iequals(onestring_view("ḁBC")));
+            PL_ASSERT_EQUAL(view.icompare(onestring_view("ḀBC")), 0);
+            return true;
+        }
+};
+
+// P-tB4074*
+class TestStdString_IEqualsHeaders : public Test
+{
+    protected:
+        std::vector<onestring> headers;
+
+    public:
+        TestStdString_IEqualsHeaders(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Match Headers (std::string)";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Match 1000 header names against a lowercase one, by converting each to a std::string and lowering it.";
+        }
+
+        bool pre() override
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                headers.push_back((i % 2) ? "Content-Security-Policy-Report-Only" : "CONTENT-SECURITY-POLICY-REPORT-ONLY");
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            const std::string wanted = "content-security-policy-report-only";
+            size_t found = 0;
+            for (const onestring& header : headers)
+            {
+                std::string lower = header.c_str();
+                for (char& ch : lower)
+                {
+                    ch = static_cast<char>(tolower(static_cast<unsigned char>(ch)));
+                }
+                if (lower == wanted) { ++found; }
+            }
+            return (found == headers.size());
+        }
+};
+
+// P-tB4074
+class TestOnestring_IEqualsHeaders : public Test
+{
+    protected:
+        std::vector<onestring> headers;
+
+    public:
+        TestOnestring_IEqualsHeaders(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Match Headers";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Match 1000 header names against a lowercase one, with onestring::iequals().";
+        }
+
+        bool pre() override
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                headers.push_back((i % 2) ? "Content-Security-Policy-Report-Only" : "CONTENT-SECURITY-POLICY-REPORT-ONLY");
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            const onestring wanted = "content-security-policy-report-only";
+            size_t found = 0;
+            for (const onestring& header : headers)
+            {
+                if (header.iequals(wanted)) { ++found; }
+            }
+            return (found == headers.size());
+        }
+};
+
+// P-tB4075
+class TestOnestringTokenizer_Split : public Test
+{
+    public:
+        TestOnestringTokenizer_Split(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring Tokenizer: Split";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test splitting text into views by a delimiter, and by any of a set of characters, for onestring and std::string.";
+        }
+
+        bool run() override
+        {
+            // A multi-character delimiter, with an empty token in the middle.
+            onestring text = "🦊::🐶::::The quick brown fox";
+            onestring_tokenizer pairs(text, onestring_view("::"));
+            onestring_view token;
+            PL_ASSERT_TRUE(pairs.next(token));
+            PL_ASSERT_TRUE(token == onestring_view("🦊"));
+            PL_ASSERT_EQUAL(token.length(), 1u);
+            PL_ASSERT_TRUE(pairs.next(token));
+            PL_ASSERT_TRUE(token == onestring_view("🐶"));
+            PL_ASSERT_TRUE(pairs.next(token));
+            PL_ASSERT_TRUE(token.empty());
+            PL_ASSERT_TRUE(pairs.next(token));
+            PL_ASSERT_TRUE(token == onestring_view("The quick brown fox"));
+            PL_ASSERT_FALSE(pairs.next(token));
+            PL_ASSERT_EQUAL(pairs.tokens(), 4u);
+
+            // Tokens point into the text; nothing is copied.
+            onestring_tokenizer words(text, onestring_view(" "));
+            PL_ASSERT_TRUE(words.next(token));
+            PL_ASSERT_TRUE(token.data() == text.c_str());
+
+            // Any of a set of characters, including non-ASCII ones, skipping
+            // the empty tokens between delimiters in a row.
+            onestring mixed = "one, two;; three🐉four,";
+            onestring_tokenizer any(mixed, onestring_view(",; 🐉"), true, false);
+            std::vector<onestring> found;
+            for (const onestring_view& word : any)
+            {
+                found.push_back(onestring(word));
+            }
+            PL_ASSERT_EQUAL(found.size(), 4u);
+            PL_ASSERT_TRUE(static_cast<bool>(found[0] == "one"));
+            PL_ASSERT_TRUE(static_cast<bool>(found[1] == "two"));
+            PL_ASSERT_TRUE(static_cast<bool>(found[2] == "three"));
+            PL_ASSERT_TRUE(static_cast<bool>(found[3] == "four"));
+
+            // Empty text is one empty token, unless empty tokens are skipped.
+            onestring empty;
+            onestring_tokenizer none(empty, onestring_view(","));
+            PL_ASSERT_TRUE(none.next(token));
+            PL_ASSERT_TRUE(token.empty());
+            PL_ASSERT_FALSE(none.next(token));
+            onestring_tokenizer skipped(empty, onestring_view(","), false, false);
+            PL_ASSERT_FALSE(skipped.next(token));
+
+            // The same for std::string, with a callback.
+            std::vector<std::string_view> parts;
+            size_t count = stdutils::stdtokenize("a, b,, c", ", ",
+                [&parts](std::string_view part) { parts.push_back(part); });
+            PL_ASSERT_EQUAL(count, 3u);
+            PL_ASSERT_TRUE(parts[0] == "a" && parts[1] == "b," && parts[2] == "c");
+            parts.clear();
+            stdutils::stdtokenize("a, b,, c", ", ",
+                [&parts](std::string_view part) { parts.push_back(part); }, true);
+            PL_ASSERT_EQUAL(parts.size(), 6u);
+            PL_ASSERT_TRUE(parts[2] == "b" && parts[3].empty() && parts[5] == "c");
+
+            std::vector<std::string> split;
+            stdutils::stdsplit("exit now  please", " ", split);
+            PL_ASSERT_EQUAL(split.size(), 4u);
+            PL_ASSERT_TRUE(split[0] == "exit" && split[2].empty() && split[3] == "please");
+
+            try
+            {
+                onestring_tokenizer bad(text, onestring_view(""));
+                return false;
+            }
+            catch (std::invalid_argument&) {}
+            return true;
+        }
+};
+
+// P-tB4076*
+class TestStdutils_StdSplit : public Test
+{
+    protected:
+        std::string text;
+
+    public:
+        TestStdutils_StdSplit(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring Tokenizer: Split Fields (stdutils::stdsplit)";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Split 2000 comma-separated fields into a vector with stdutils::stdsplit().";
+        }
+
+        bool pre() override
+        {
+            for (int i = 0; i < 2000; ++i)
+            {
+                text.append((i % 2) ? "🦊 quick brown, " : "lazy 🐶 dog, ");
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            std::vector<std::string> fields;
+            stdutils::stdsplit(text, ", ", fields);
+            return (fields.size() == 2001);
+        }
+};
+
+// P-tB4076
+class TestOnestringTokenizer_SplitFields : public Test
+{
+    protected:
+        onestring text;
+
+    public:
+        TestOnestringTokenizer_SplitFields(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring Tokenizer: Split Fields";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Split 2000 comma-separated fields into views with onestring_tokenizer.";
+        }
+
+        bool pre() override
+        {
+            for (int i = 0; i < 2000; ++i)
+            {
+                text.append((i % 2) ? "🦊 quick brown, " : "lazy 🐶 dog, ");
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            onestring_tokenizer fields(text, onestring_view(", "));
+            onestring_view field;
+            while (fields.next(field)) {}
+            return (fields.tokens() == 2001);
+        }
+};
+
+// P-tB4077
+class TestOnestring_MemoryResource : public Test
+{
+    protected:
+        /// A memory resource which counts what it hands out.
+        class counting_resource : public std::pmr::memory_resource
+        {
+            public:
+                size_t live = 0;
+                size_t total = 0;
+
+            protected:
+                void* do_allocate(size_t bytes, size_t align) override
+                {
+                    ++live;
+                    ++total;
+                    return std::pmr::new_delete_resource()->allocate(bytes, align);
+                }
+
+                void do_deallocate(void* ptr, size_t bytes, size_t align) override
+                {
+                    --live;
+                    std::pmr::new_delete_resource()->deallocate(ptr, bytes, align);
+                }
+
+                bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+                {
+                    return (this == &other);
+                }
+        };
+
+    public:
+        TestOnestring_MemoryResource(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Memory Resource";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test that a onestring with a memory resource allocates its text and index from it, and that copies, moves, and swaps keep memory with the right resource.";
+        }
+
+        bool run() override
+        {
+            counting_resource counter;
+            {
+                onestring text(&counter);
+                PL_ASSERT_TRUE(text.resource() == &counter);
+
+                // Short text is inline, and needs no memory at all.
+                text = "🦊";
+                PL_ASSERT_EQUAL(counter.total, 0u);
+
+                // Longer text, and its character index, come from the resource.
+                for (int i = 0; i < 40; ++i)
+                {
+                    text.append("The quick brown 🦊 jumped over the lazy 🐶. ");
+                }
+                PL_ASSERT_TRUE(static_cast<bool>(text[1006] == "🐶"));
+                PL_ASSERT_GREATER_EQUAL(counter.live, 2u);
+
+                // A copy uses the heap.
+                onestring copy(text);
+                PL_ASSERT_TRUE(copy.resource() == nullptr);
+                PL_ASSERT_TRUE(static_cast<bool>(copy == text));
+
+                // Moving into a string with another resource copies the text.
+                size_t before = counter.total;
+                onestring heap;
+                heap = std::move(text);
+                PL_ASSERT_TRUE(heap.resource() == nullptr);
+                PL_ASSERT_TRUE(static_cast<bool>(heap == copy));
+                PL_ASSERT_TRUE(text.empty());
+                PL_ASSERT_EQUAL(counter.total, before);
+
+                // Moving into a string with the same resource takes the text.
+                text = copy;
+                onestring same(&counter);
+                before = counter.total;
+                same = std::move(text);
+                PL_ASSERT_EQUAL(counter.total, before);
+                PL_ASSERT_TRUE(static_cast<bool>(same == copy));
+
+                // A moved-to string keeps the resource it was moved from.
+                onestring moved(std::move(same));
+                PL_ASSERT_TRUE(moved.resource() == &counter);
+
+                // Swapping exchanges the resources along with the text.
+                onestring other = "short";
+                moved.swap(other);
+                PL_ASSERT_TRUE(other.resource() == &counter);
+                PL_ASSERT_TRUE(moved.resource() == nullptr);
+                PL_ASSERT_TRUE(static_cast<bool>(other == copy));
+
+                // Appending a string to itself works on a copy in the resource.
+                other.append_all(other, "!");
+                PL_ASSERT_EQUAL(other.length(), copy.length() * 2 + 1);
+
+                // So does inserting it into itself, without growing.
+                other.reserve(other.size() * 3);
+                before = counter.total;
+                size_t live = counter.live;
+                other.insert(0, other);
+                PL_ASSERT_EQUAL(other.length(), copy.length() * 4 + 2);
+                PL_ASSERT_EQUAL(counter.total, before + 1);
+                PL_ASSERT_EQUAL(counter.live, live);
+            }
+            // Everything went back to the resource.
+            PL_ASSERT_EQUAL(counter.live, 0u);
+            return true;
+        }
+};
+
+// P-tB4078*
+class TestOnestring_HeapRequest : public Test
+{
+    protected:
+        std::vector<onestring_view> words;
+
+    public:
+        TestOnestring_HeapRequest(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Request-Scoped Strings (heap)";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Build 200 temporary onestrings of 40 to 60 bytes, allocating from the heap.";
+        }
+
+        bool pre() override
+        {
+            words.push_back(onestring_view("The quick brown 🦊 "));
+            words.push_back(onestring_view("jumped over the lazy 🐶, "));
+            words.push_back(onestring_view("Content-Type: text/html; "));
+            return true;
+        }
+
+        bool run() override
+        {
+            size_t total = 0;
+            for (int i = 0; i < 200; ++i)
+            {
+                onestring temp;
+                temp.append_all(words[i % 3], words[(i + 1) % 3], i);
+                total += temp.length();
+            }
+            return (total > 0);
+        }
+};
+
+// P-tB4078
+class TestOnestring_ArenaRequest : public TestOnestring_HeapRequest
+{
+    protected:
+        std::vector<char> buffer;
+
+    public:
+        TestOnestring_ArenaRequest(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Request-Scoped Strings (arena)";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Build 200 temporary onestrings of 40 to 60 bytes, allocating from a std::pmr::monotonic_buffer_resource.";
+        }
+
+        bool pre() override
+        {
+            buffer.resize(65536);
+            return TestOnestring_HeapRequest::pre();
+        }
+
+        bool run() override
+        {
+            // Everything is released at once, when the arena goes.
+            std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+            size_t total = 0;
+            for (int i = 0; i < 200; ++i)
+            {
+                onestring temp(&arena);
+                temp.append_all(words[i % 3], words[(i + 1) % 3], i);
+                total += temp.length();
+            }
+            return (total > 0);
+        }
+};
+
+// P-tB4079
+class TestOnestring_Format : public Test
+{
+    public:
+        TestOnestring_Format(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Format";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test creating onestrings from format strings, with fields for numbers, text, and other values.";
+        }
+
+        bool run() override
+        {
+            onestring fox = "🦊";
+            onestring test = onestring::format(PAWLIB_FORMAT("The {} {} jumped {} times, {}% of the way. {}"),
+                                               "quick", fox, 42, 99.5, true);
+            PL_ASSERT_TRUE(static_cast<bool>(test == "The quick 🦊 jumped 42 times, 99.5% of the way. true"));
+            PL_ASSERT_EQUAL(test.length(), 51u);
+
+            // Every kind of value, including negative and 64-bit numbers.
+            test = onestring::format(PAWLIB_FORMAT("{}|{}|{}|{}|{}|{}|{}"), 'c', onechar("🐶"), std::string("str"),
+                                     onestring_view("view"), -7, 18446744073709551615ull, -0.25f);
+            PL_ASSERT_TRUE(static_cast<bool>(test == "c|🐶|str|view|-7|18446744073709551615|-0.25"));
+
+            // Doubled braces are literal braces.
+            test = onestring::format(PAWLIB_FORMAT("{{🐉}} = {{{}}}"), 3);
+            PL_ASSERT_TRUE(static_cast<bool>(test == "{🐉} = {3}"));
+            PL_ASSERT_EQUAL(test.length(), 9u);
+
+            // No fields at all, and an empty format.
+            PL_ASSERT_TRUE(static_cast<bool>(onestring::format(PAWLIB_FORMAT("plain")) == "plain"));
+            PL_ASSERT_TRUE(onestring::format(PAWLIB_FORMAT("")).empty());
+
+            // A constexpr format string is checked at compile time too.
+            constexpr onestring::format_string<2> pair("({}, {})");
+            PL_ASSERT_TRUE(static_cast<bool>(onestring::format(pair, 1, 2) == "(1, 2)"));
+            static_assert(onestring::count_fields("{} {{}} {}", 10) == 2);
+            static_assert(onestring::count_fields("{ }", 3) == onestring::npos);
+            constexpr auto checked = PAWLIB_FORMAT("{}, {{}}, {}");
+            static_assert(std::is_same_v<decltype(checked), const onestring::format_string<2>>);
+
+#if defined(__cpp_consteval)
+            // With consteval, a string literal is checked as is.
+            PL_ASSERT_TRUE(static_cast<bool>(onestring::format("{}!", 1) == "1!"));
+#endif
+            return true;
+        }
+};
+
+// P-tB4080*
+class TestOnestring_FormatSnprintf : public Test
+{
+    public:
+        TestOnestring_FormatSnprintf(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Format (snprintf)";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Format a message with an integer, a float, and text 100 times, with snprintf() into a buffer.";
+        }
+
+        bool run() override
+        {
+            char buffer[128];
+            size_t total = 0;
+            for (int i = 0; i < 100; ++i)
+            {
+                total += snprintf(buffer, sizeof(buffer), "request %d from %s took %g ms",
+                                  i * 7919, "fox.example.com", i * 0.5);
+            }
+            return (total > 0);
+        }
+};
+
+// P-tB4080
+class TestOnestring_FormatMessage : public Test
+{
+    public:
+        TestOnestring_FormatMessage(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Format";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Format a message with an integer, a float, and text 100 times, with onestring::format().";
+        }
+
+        bool run() override
+        {
+            size_t total = 0;
+            for (int i = 0; i < 100; ++i)
+            {
+                onestring message = onestring::format(PAWLIB_FORMAT("request {} from {} took {} ms"),
+                                                      i * 7919, "fox.example.com", i * 0.5);
+                total += message.size();
+            }
+            return (total > 0);
+        }
+};
+
+// P-tB4081
+class TestOnestring_IndexMixedWidths : public Test
+{
+    public:
+        TestOnestring_IndexMixedWidths(){}
+
+        testdoc_t get_title() override
+        {
+            return "Onestring: Index Mixed Widths";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Test finding characters past the first index entry in a onestring whose character widths follow no pattern.";
+        }
+
+        bool run() override
+        {
+            /* The last whole block of 32 bytes ends in the middle of a
+             * character, one character short of the first index entry, so
+             * indexing must not assume a character starts there. */
+            const char* text = "🐉aé🐉⛰⛰⛰🐉🐉🐉🐉a⛰⛰🐉⛰🐉é🐉aé⛰🐉🐉é⛰⛰🐉🐉éé🐉🐉";
+
+            onestring test = text;
+            PL_ASSERT_EQUAL(test.length(), 33u);
+            PL_ASSERT_EQUAL(test.at(29), "é");
+            PL_ASSERT_EQUAL(test.at(32), "🐉");
+            PL_ASSERT_EQUAL(test.substr(29).c_str(), "éé🐉🐉");
+
+            test.replace(15, 17, "\n⛰");
+            PL_ASSERT_EQUAL(test.c_str(), "🐉aé🐉⛰⛰⛰🐉🐉🐉🐉a⛰⛰🐉\n⛰🐉");
+            return true;
+        }
+};
+
 class TestSuite_Onestring : public TestSuite
 {
     public:
@@ -0,0 +1,167 @@
+/** Onestring Tokenizer [PawLIB]
+  * Version: 0.4
+  *
+  * Onestring_tokenizer splits text into tokens lazily, in one pass, without
+  * allocating. Each token is handed out as a onestring_view into the
+  * original text. Tokens may be separated by a delimiter of any length,
+  * or by any one of a set of characters.
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2016-2019 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_ONESTRING_TOKENIZER_HPP
+#define PAWLIB_ONESTRING_TOKENIZER_HPP
+
+#include <cstddef>
+#include <iterator>
+
+#include "pawlib/onestring.hpp"
+#include "pawlib/onestring_view.hpp"
+
+class onestring_tokenizer
+{
+    public:
+        /** An iterator over the remaining tokens, for use with range-based
+         * for loops. Advancing it advances the tokenizer, so there is only
+         * ever one pass. */
+        class const_iterator
+        {
+            friend onestring_tokenizer;
+            private:
+                /// The tokenizer, or nullptr once there are no more tokens.
+                onestring_tokenizer* _tokenizer;
+
+                /// The current token.
+                onestring_view _token;
+
+                explicit const_iterator(onestring_tokenizer* tokenizer)
+                :_tokenizer(tokenizer)
+                {
+                    ++(*this);
+                }
+
+            public:
+                typedef std::input_iterator_tag iterator_category;
+                typedef onestring_view value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef const onestring_view* pointer;
+                typedef const onestring_view& reference;
+
+                const_iterator()
+                :_tokenizer(nullptr)
+                {}
+
+                const_iterator& operator++()
+                {
+                    if (this->_tokenizer != nullptr && !this->_tokenizer->next(this->_token))
+                    {
+                        this->_tokenizer = nullptr;
+                    }
+                    return *this;
+                }
+
+                const onestring_view& operator*() const { return this->_token; }
+                const onestring_view* operator->() const { return &(this->_token); }
+
+                bool operator==(const const_iterator& rhs) const { return this->_tokenizer == rhs._tokenizer; }
+                bool operator!=(const const_iterator& rhs) const { return this->_tokenizer != rhs._tokenizer; }
+        };
+
+    private:
+        /// The text being split. It is never copied.
+        onestring_view _text;
+
+        /// The delimiter, or the set of characters to split on.
+        onestring_view _delim;
+
+        /// Whether to split on any one character of _delim.
+        bool _any;
+
+        /// Whether to hand out empty tokens.
+        bool _keep_empty;
+
+        /// Which lead bytes are in _delim, when splitting on any character.
+        bool _marked[256];
+
+        /// The byte offset of the start of the next token.
+        size_t _start;
+
+        /// Whether the last token has been handed out.
+        bool _done;
+
+        /// The number of tokens handed out so far.
+        size_t _tokens;
+
+        /** Find the end of the next token.
+             * \param [out] the number of bytes to skip past the token
+             * \return the byte offset of the end of the token */
+        size_t find_token(size_t& skip) const;
+
+    public:
+        /** Create a tokenizer. Neither the text nor the delimiter is
+             * copied, so both must outlive the tokenizer.
+             * \param the text to split
+             * \param the delimiter between tokens, which may be more than one
+             * character, such as "\r\n". If any_of is true, the tokens are
+             * split on any one of its characters instead.
+             * \param whether to split on any one character of the delimiter
+             * \param whether to hand out empty tokens, such as the one
+             * between two delimiters in a row; default true */
+        onestring_tokenizer(const onestring_view& text, const onestring_view& delim,
+                            bool any_of = false, bool keep_empty = true);
+
+        /** Get the next token, as a view into the text.
+             * \param [out] the view to point at the token
+             * \return true if there was another token, else false */
+        bool next(onestring_view& token);
+
+        /** Get the number of tokens handed out so far.
+             * \return the number of tokens */
+        size_t tokens() const { return this->_tokens; }
+
+        /** Get an iterator at the next token.
+             * \return the iterator */
+        const_iterator begin() { return const_iterator(this); }
+
+        /** Get an iterator past the last token.
+             * \return the iterator */
+        const_iterator end() { return const_iterator(); }
+};
+
+#endif // PAWLIB_ONESTRING_TOKENIZER_HPP
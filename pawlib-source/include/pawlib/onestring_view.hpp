@@ -0,0 +1,425 @@
+/** Onestring View [PawLIB]
+  * Version: 0.4
+  *
+  * Onestring_view is a read-only view of UTF-8 text owned by something else,
+  * such as a onestring, a std::string, or a c-string. It offers the same
+  * read-only functions as onestring, but never copies or allocates, so it is
+  * ideal for parsing and tokenizing.
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2016-2019 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_ONESTRING_VIEW_HPP
+#define PAWLIB_ONESTRING_VIEW_HPP
+
+#include <cstring>
+#include <functional> // std::hash
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+#include "pawlib/onechar.hpp"
+
+class onestring;
+class onestring_interner;
+class onestring_reader;
+class onestring_rope;
+class onestring_tokenizer;
+
+class onestring_view
+{
+    friend onestring;
+    friend onestring_interner;
+    friend onestring_reader;
+    friend onestring_rope;
+    friend onestring_tokenizer;
+
+    public:
+        /// The greatest possible value for an element.
+        inline static const size_t npos = -1;
+
+        /** An iterator over the characters in a onestring_view, which
+         * yields each one as a onechar. */
+        class const_iterator
+        {
+            friend onestring_view;
+            private:
+                /// The first byte of the character.
+                const char* ptr;
+
+                explicit const_iterator(const char* at)
+                :ptr(at)
+                {}
+
+            public:
+                typedef std::bidirectional_iterator_tag iterator_category;
+                typedef onechar value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef const onechar* pointer;
+                typedef onechar reference;
+
+                const_iterator()
+                :ptr(nullptr)
+                {}
+
+                onechar operator*() const { return onechar(ptr); }
+
+                const_iterator& operator++()
+                {
+                    ptr += onechar::evaluateLength(ptr);
+                    return *this;
+                }
+
+                const_iterator operator++(int)
+                {
+                    const_iterator r(*this);
+                    ++(*this);
+                    return r;
+                }
+
+                const_iterator& operator--()
+                {
+                    // Step back over the continuation bytes.
+                    do { --ptr; } while ((*ptr & 0xC0) == 0x80);
+                    return *this;
+                }
+
+                const_iterator operator--(int)
+                {
+                    const_iterator r(*this);
+                    --(*this);
+                    return r;
+                }
+
+                bool operator==(const const_iterator& rhs) const { return ptr == rhs.ptr; }
+                bool operator!=(const const_iterator& rhs) const { return ptr != rhs.ptr; }
+        };
+
+        typedef const_iterator iterator;
+
+    private:
+        /// The first byte of the text.
+        const char* _bytes;
+
+        /// The number of bytes in the text.
+        size_t _size;
+
+        /// The number of Unicode characters in the text.
+        size_t _elements;
+
+        /** Create a view of text that is already known to be valid.
+         * \param the UTF-8 text
+         * \param the number of bytes in the text
+         * \param the number of characters in the text */
+        onestring_view(const char* bytes, size_t n, size_t chars)
+        :_bytes(bytes), _size(n), _elements(chars)
+        {}
+
+        /** Find the byte offset of a character.
+             * Walks the text, unless it is ASCII-only.
+             * WARNING: Does not check that the index is in range.
+             * \param the index of the character, or the length of the
+             * view to find the end
+             * \return the offset of the character's first byte */
+        size_t offset_of(size_t pos) const;
+
+        /** The implementation of find_first_of() and find_first_not_of().
+             * \param the set of characters
+             * \param the index of the first character to search from
+             * \param true to find a character in the set, false to find
+             * one not in the set
+             * \return the index of the character found, or npos */
+        size_t find_of(const onestring_view& set, size_t pos, bool match) const;
+
+        /** The implementation of find_last_of() and find_last_not_of().
+             * \param the set of characters
+             * \param the index of the last character to search from
+             * \param true to find a character in the set, false to find
+             * one not in the set
+             * \return the index of the character found, or npos */
+        size_t rfind_of(const onestring_view& set, size_t pos, bool match) const;
+
+    public:
+        /*******************************************
+        * Constructors
+        *******************************************/
+
+        /**Default Constructor, for an empty view*/
+        onestring_view()
+        :_bytes(""), _size(0), _elements(0)
+        {}
+
+        /**Create a view of a c-string.
+        * The text must be valid UTF-8, or std::invalid_argument is thrown.
+        * \param the c-string to view */
+        // cppcheck-suppress noExplicitConstructor
+        onestring_view(const char* cstr);
+
+        /**Create a view of part of a c-string, or any other UTF-8 text.
+        * The text must be valid UTF-8, or std::invalid_argument is thrown.
+        * \param the text to view
+        * \param the number of bytes to view */
+        onestring_view(const char* bytes, size_t n);
+
+        /**Create a view of a std::string.
+        * The text must be valid UTF-8, or std::invalid_argument is thrown.
+        * \param the string to view */
+        // cppcheck-suppress noExplicitConstructor
+        onestring_view(const std::string& str);
+
+        /**Create a view of a onestring. A onestring is always valid UTF-8,
+        * so this is never checked.
+        * \param the onestring to view */
+        // cppcheck-suppress noExplicitConstructor
+        onestring_view(const onestring& ostr);
+
+        onestring_view(const onestring_view&) = default;
+        onestring_view& operator=(const onestring_view&) = default;
+
+        /* A view never owns its text. It is only valid as long as the text
+         * it views is neither changed nor destroyed. */
+
+        /*******************************************
+        * Accessors
+        *******************************************/
+
+        /** Gets the onechar at a given position
+             * \param the index of the onechar to return
+             * \return a copy of the corresponding onechar */
+        onechar at(size_t pos) const;
+
+        /** Gets the last onechar in the view.
+             * If the view is empty, this has undefined behavior.
+             * \return a copy of the last onechar in the view */
+        onechar back() const;
+
+        /** Gets an iterator to the first character in the view.
+             * \return the iterator */
+        const_iterator begin() const { return const_iterator(_bytes); }
+
+        /** Gets the text being viewed.
+             * WARNING: This is NOT null-terminated, unless the text being
+             * viewed happens to be terminated right after the view ends.
+             * \return a pointer to the first byte */
+        const char* data() const { return _bytes; }
+
+        /**Checks to see if the view contains any characters
+         * \returns true if empty, else false */
+        bool empty() const { return _elements == 0; }
+
+        /** Gets an iterator just past the last character in the view.
+             * \return the iterator */
+        const_iterator end() const { return const_iterator(_bytes + _size); }
+
+        /** Gets the first onechar in the view.
+             * If the view is empty, this has undefined behavior.
+             * \return a copy of the first onechar in the view */
+        onechar front() const;
+
+        /** Gets the hash of the text in the view. This is the same as the
+             * hash of a onestring with the same text and seed, but unlike a
+             * onestring, a view never keeps its hash.
+             * \param the seed, default 0
+             * \return the hash */
+        size_t hash(size_t seed = 0) const;
+
+        /**Gets the number of Unicode characters in the view
+         * \return the number of characters */
+        size_t length() const { return _elements; }
+
+        /**Gets the number of bytes in the view. Unlike onestring::size(),
+         * there is no null terminator to count.
+         * \return the number of bytes */
+        size_t size() const { return _size; }
+
+        /**Creates a view of part of this view, without copying.
+         * \param the position of the first character to view
+         * \param the number of characters to view, optional.
+         * \return the new view */
+        onestring_view substr(size_t pos = 0, size_t len = npos) const;
+
+        /*******************************************
+        * Modifiers
+        ********************************************/
+
+        /** Shrinks the view by moving its start forward.
+             * The text being viewed is not changed.
+             * \param the number of characters to remove from the front */
+        void remove_prefix(size_t len);
+
+        /** Shrinks the view by moving its end backward.
+             * The text being viewed is not changed.
+             * \param the number of characters to remove from the back */
+        void remove_suffix(size_t len);
+
+        /** Switches the text viewed by this view with another.
+             * \param the view to swap with */
+        void swap(onestring_view& view);
+
+        /*******************************************
+        * Comparison
+        ********************************************/
+
+        /** Compares the view against another.
+             * \return an integer representing the result.
+             * Returns a negative integer IF this view is shorter
+             * OR the same length and lower in value
+             * Returns zero if the values are the same
+             * Returns a positive integer IF this view is longer
+             * OR the same length and higher in value */
+        int compare(const onestring_view&) const;
+
+        /** Tests if the view is equivalent to another.
+             * \param the view to compare against
+             * \return true if equal, else false */
+        bool equals(const onestring_view&) const;
+
+        /** Compares the view against another, ignoring case.
+             * See onestring::icompare().
+             * \param the view to compare against
+             * \return an integer representing the result, as with compare() */
+        int icompare(const onestring_view&) const;
+
+        /** Tests if the view is equivalent to another, ignoring case.
+             * \param the view to compare against
+             * \return true if equal, else false */
+        bool iequals(const onestring_view&) const;
+
+        /*******************************************
+        * Search
+        ********************************************/
+
+        /* As with onestring, all searches work on character indexes. */
+
+        /** Finds the first occurrence of the text in the view,
+             * at or after the given position.
+             * \param the text to search for
+             * \param the index of the first character to search from, default 0
+             * \return the index of the first character of the match, or npos */
+        size_t find(const onestring_view&, size_t pos = 0) const;
+
+        /** Finds the last occurrence of the text in the view,
+             * starting at or before the given position.
+             * \param the text to search for
+             * \param the index of the last character a match may start at,
+             * default npos (the whole view)
+             * \return the index of the first character of the match, or npos */
+        size_t rfind(const onestring_view&, size_t pos = npos) const;
+
+        /** Finds the first character in the view, at or after the given
+             * position, that matches any of the characters in the text.
+             * \param the characters to search for
+             * \param the index of the first character to search from, default 0
+             * \return the index of the character found, or npos */
+        size_t find_first_of(const onestring_view&, size_t pos = 0) const;
+
+        /** Finds the first character in the view, at or after the given
+             * position, that matches none of the characters in the text.
+             * \param the characters to skip
+             * \param the index of the first character to search from, default 0
+             * \return the index of the character found, or npos */
+        size_t find_first_not_of(const onestring_view&, size_t pos = 0) const;
+
+        /** Finds the last character in the view, at or before the given
+             * position, that matches any of the characters in the text.
+             * \param the characters to search for
+             * \param the index of the last character to search from,
+             * default npos (the whole view)
+             * \return the index of the character found, or npos */
+        size_t find_last_of(const onestring_view&, size_t pos = npos) const;
+
+        /** Finds the last character in the view, at or before the given
+             * position, that matches none of the characters in the text.
+             * \param the characters to skip
+             * \param the index of the last character to search from,
+             * default npos (the whole view)
+             * \return the index of the character found, or npos */
+        size_t find_last_not_of(const onestring_view&, size_t pos = npos) const;
+
+        /** Counts the non-overlapping occurrences of the text in the view.
+             * \param the text to search for
+             * \return the number of occurrences */
+        size_t count(const onestring_view&) const;
+
+        /** Checks whether the text occurs anywhere in the view.
+             * \param the text to search for
+             * \return true if found, else false */
+        bool contains(const onestring_view&) const;
+
+        /** Checks whether the view starts with the text.
+             * \param the text to look for
+             * \return true if the view starts with it, else false */
+        bool starts_with(const onestring_view&) const;
+
+        /** Checks whether the view ends with the text.
+             * \param the text to look for
+             * \return true if the view ends with it, else false */
+        bool ends_with(const onestring_view&) const;
+
+        /*******************************************
+        * Operators
+        ********************************************/
+
+        onechar operator[](size_t pos) const { return at(pos); }
+
+        friend bool operator==(const onestring_view& lhs, const onestring_view& rhs) { return lhs.equals(rhs); }
+        friend bool operator!=(const onestring_view& lhs, const onestring_view& rhs) { return !lhs.equals(rhs); }
+        friend bool operator<(const onestring_view& lhs, const onestring_view& rhs) { return (lhs.compare(rhs) < 0); }
+        friend bool operator<=(const onestring_view& lhs, const onestring_view& rhs) { return (lhs.compare(rhs) <= 0); }
+        friend bool operator>(const onestring_view& lhs, const onestring_view& rhs) { return (lhs.compare(rhs) > 0); }
+        friend bool operator>=(const onestring_view& lhs, const onestring_view& rhs) { return (lhs.compare(rhs) >= 0); }
+
+        friend std::ostream& operator<<(std::ostream& os, const onestring_view& view)
+        {
+            os.write(view._bytes, view._size);
+            return os;
+        }
+};
+
+namespace std
+{
+    /// Allows onestring_view to be used as a key in unordered containers.
+    template<>
+    struct hash<onestring_view>
+    {
+        size_t operator()(const onestring_view& view) const { return view.hash(); }
+    };
+}
+
+#endif // PAWLIB_ONESTRING_VIEW_HPP
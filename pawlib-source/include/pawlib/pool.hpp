@@ -49,9 +49,12 @@
 #include <cstdint>
 #include <exception>
 #include <iostream>
+#include <new>
+#include <utility>
 
 #include "pawlib/constants.hpp"
 #include "pawlib/flex_stack.hpp"
+#include "pawlib/iochannel.hpp"
 
 //Signals and callbacks.
 #include "cpgf/gcallbacklist.h"
@@ -59,8 +62,8 @@
 /** INVALID_INDEX (from pawlib/constants.hpp) indicates an invalid pool
      * index, such as when the pool is full. */
 
-template<typename T> class pool_ref;
-template<typename T> class pool_obj;
+template<typename T, bool padded = false> class pool_ref;
+template<typename T, bool padded = false> class pool_obj;
 
 class e_pool_full : public std::exception
 {
@@ -94,74 +97,335 @@ class e_pool_reinit : public std::exception
     }
 };
 
-/** A ready-to-use object Pool. Dynamic allocation is front-loaded.*/
-template<typename T>
+/** A snapshot of a Pool's occupancy and usage counters.
+ * The capacity and live count are always available. The remaining
+ * counters are only gathered while statistics are enabled on the pool. */
+struct pool_stats
+{
+    /// The maximum number of objects in the pool.
+    uint32_t capacity;
+    /// The number of objects currently live in the pool.
+    uint32_t live;
+    /// The largest number of objects ever live at once.
+    uint32_t high_water;
+    /// The total number of objects created.
+    uint64_t creates;
+    /// The total number of objects destroyed.
+    uint64_t destroys;
+    /// The number of objects that could not be created because the pool was full.
+    uint64_t failed;
+    /// The number of invalid references returned from a full, failsafe pool.
+    uint64_t failsafe_invalid;
+
+    pool_stats()
+    :capacity(0), live(0), high_water(0), creates(0), destroys(0),
+     failed(0), failsafe_invalid(0)
+    {}
+};
+
+/** Output a human-readable report of pool statistics.
+ * \param the IOChannel to output to
+ * \param the pool statistics to report
+ * \return the IOChannel, for chaining */
+inline iochannel& operator<<(iochannel& io, const pool_stats& stats)
+{
+    io << "Pool: " << stats.live << "/" << stats.capacity << " live, "
+       << stats.high_water << " peak" << IOCtrl::n
+       << "  creates: " << stats.creates
+       << ", destroys: " << stats.destroys << IOCtrl::n
+       << "  failed: " << stats.failed
+       << ", failsafe invalid: " << stats.failsafe_invalid;
+    return io;
+}
+
+/** A ready-to-use object Pool. Dynamic allocation is front-loaded.
+ * \param the type of object to store
+ * \param whether to pad each object out to its own cache line, so objects
+ * used by different threads never share one (default false, which packs
+ * objects together for faster iteration)
+ */
+template<typename T, bool padded = false>
 class Pool
 {
     private:
         // A pool reference must be able to access Pool's private functions.
-        friend class pool_ref<T>;
+        friend class pool_ref<T, padded>;
 
         // Define our pool reference type.
-        typedef pool_ref<T> poolref_t;
+        typedef pool_ref<T, padded> poolref_t;
         // Define our pool object type.
-        typedef pool_obj<T> poolobj_t;
+        typedef pool_obj<T, padded> poolobj_t;
         typedef cpgf::GCallbackList<void ()> poolobjsignal_t;
 
         /// The pointer to the beginning of our pool's chunk of memory.
         poolobj_t* pool_root;
         /// The maximum number of objects in the pool.
         uint32_t pool_size;
-
-        /* The stack of available indexes. */
+        /// The number of objects currently live in the pool.
+        uint32_t pool_live;
+
+        /** The number of handles. Pool references hold a handle rather than
+         * the object's position in the pool, so objects can be moved (see
+         * compact()) without touching their references. This is the size
+         * the pool was created with, even if it has since been shrunk. */
+        uint32_t handle_count;
+        /// The position in the pool of the object each handle refers to.
+        uint32_t* handle_slot;
+        /// The handle referring to the object at each position in the pool.
+        uint32_t* slot_handle;
+        /// The signal for invalidating the references to each handle.
+        poolobjsignal_t* handle_signal;
+
+        /* The stack of available handles. */
         FlexStack<uint32_t> index_available;
 
         /// If failsafe is on, we'll ignore create and access failures.
         bool failsafe;
 
+        /** The occupancy bitmap, with one bit per object in the pool.
+         * A set bit marks a live object. */
+        uint64_t* pool_occupied;
+        /// The number of 64-bit words in the occupancy bitmap.
+        uint32_t pool_occupied_words;
+        /** No word in the occupancy bitmap before this one has any open
+         * positions, so searches for an open position can start here. */
+        uint32_t pool_open_word;
+
+        /// If stats tracking is on, we'll count creates, destroys, and failures.
+        bool track_stats;
+        /// The usage counters, only updated while track_stats is on.
+        pool_stats counters;
+
         void populate_stack()
         {
-            for(uint32_t i = 0; i < pool_size; ++i)
+            for(uint32_t i = 0; i < handle_count; ++i)
             {
                 index_available.push(i);
             }
         }
 
-        /** Find the next open position in the pool.
+        /** Find the lowest open position in the pool.
          * Return INVALID_INDEX if none found. */
         uint32_t find_open()
         {
-            // Check for available indexes...
-            try
+            // If the pool is full...
+            if(pool_live == pool_size)
+            {
+                return INVALID_INDEX;
+            }
+            /* There is an open position, so we will find it before we
+                * run out of words. */
+            while(pool_occupied[pool_open_word] == ~UINT64_C(0))
+            {
+                ++pool_open_word;
+            }
+            return (pool_open_word << 6) +
+                __builtin_ctzll(~pool_occupied[pool_open_word]);
+        }
+
+        /** Assign a handle to a newly initialized object, and mark it as live.
+         * There is always a handle available if there was an open position.
+         * \param the position of the object in the pool
+         * \return the handle for the object */
+        uint32_t bind(uint32_t loc)
+        {
+            uint32_t handle = index_available.pop();
+            handle_slot[handle] = loc;
+            slot_handle[loc] = handle;
+            mark_live(loc);
+            ++pool_live;
+            return handle;
+        }
+
+        poolobjsignal_t* object_signal(uint32_t handle)
+        {
+            return &(handle_signal[handle]);
+        }
+
+        /** Mark the object at the given index as live in the occupancy
+         * bitmap.
+         * \param the index of the object */
+        void mark_live(uint32_t loc)
+        {
+            pool_occupied[loc >> 6] |= (UINT64_C(1) << (loc & 63));
+        }
+
+        /** Mark the object at the given index as dead in the occupancy
+         * bitmap.
+         * \param the index of the object */
+        void mark_dead(uint32_t loc)
+        {
+            pool_occupied[loc >> 6] &= ~(UINT64_C(1) << (loc & 63));
+            if((loc >> 6) < pool_open_word)
+            {
+                pool_open_word = loc >> 6;
+            }
+        }
+
+        /** Find the highest live position in the pool, searching down
+         * from the given word of the occupancy bitmap.
+         * \param the word to start searching from, which is updated to
+         * the word the live position was found in
+         * \return the position of the live object, or INVALID_INDEX if
+         * there are none */
+        uint32_t find_last_live(uint32_t& word)
+        {
+            while(word > 0 && pool_occupied[word] == 0)
             {
-                // Use the latest one.
-                return index_available.pop();
+                --word;
             }
-            // If our stack was empty...
-            catch(std::out_of_range&)
+            if(pool_occupied_words == 0 || pool_occupied[word] == 0)
             {
-                // The pool is full.
                 return INVALID_INDEX;
             }
+            return (word << 6) + 63 - __builtin_clzll(pool_occupied[word]);
+        }
+
+        /** Move a live object to an open position, and point its handle
+         * at the new position. Its references are unaffected.
+         * \param the position of the live object
+         * \param the open position to move it to */
+        void relocate(uint32_t from, uint32_t to)
+        {
+            pool_root[to].init(std::move(pool_root[from].object));
+            pool_root[from].deinit();
+
+            uint32_t handle = slot_handle[from];
+            handle_slot[handle] = to;
+            slot_handle[to] = handle;
+
+            mark_live(to);
+            mark_dead(from);
+        }
+
+        /** Count newly created objects, and update the high-water mark.
+         * \param the number of objects just created */
+        void count_created(uint32_t n)
+        {
+            if(track_stats)
+            {
+                counters.creates += n;
+                if(pool_live > counters.high_water)
+                {
+                    counters.high_water = pool_live;
+                }
+            }
+        }
+
+        /** Count objects that could not be created because the pool is full.
+         * \param the number of objects that could not be created
+         * \param whether invalid references were handed back (failsafe) */
+        void count_failed(uint32_t n, bool returned_invalid)
+        {
+            if(track_stats)
+            {
+                counters.failed += n;
+                if(returned_invalid)
+                {
+                    counters.failsafe_invalid += n;
+                }
+            }
+        }
+
+        /** Check that a reference can be used with this pool, and throw
+         * the appropriate exception if it cannot.
+         * \param the pool reference to validate */
+        void validate_ref(poolref_t& rf)
+        {
+            // If the reference does not belong to the pool.
+            if(rf.pool_ptr != this)
+            {
+                // Throw a foreign reference error.
+                throw e_pool_foreign_ref();
+            }
+            /* Else if the reference points to an invalid index (such as when
+                * the reference was returned from an create() on a full, failsafe
+                * pool. */
+            else if(rf.getIndex() == INVALID_INDEX)
+            {
+                throw e_pool_invalid_ref();
+            }
+        }
+
+        /** Deinitialize the object with the given handle, and mark its
+         * space as available. Does NOT validate the handle.
+         * \param the handle of the object to deinitialize */
+        void release(uint32_t handle)
+        {
+            try
+            {
+                /* Mark this handle as up for grabs. We must do this now,
+                * before the reference is invalidated. */
+                index_available.push(handle);
+            }
+            catch(std::length_error&)
+            {
+                // Just don't bother pushing.
+            }
+
+            // Order all the references to invalidate.
+            handle_signal[handle].dispatch();
+            /* Remove all the handle's callbacks. This is a backup in
+                * case a disconnect() from a reference doesn't work right.
+                * BUG T1086: In some situations, references were not
+                * disconnecting themselves from the object. Thus, if the
+                * object was recycled, sometimes old signals would persist.
+                * To get around this, we just have the object remove its
+                * own signals.
+                * REVISED 13 AUG: CallbackList now provides clear()
+                */
+            handle_signal[handle].clear();
+
+            // Deinitialize the object.
+            uint32_t loc = handle_slot[handle];
+            pool_root[loc].deinit();
+            mark_dead(loc);
+            --pool_live;
+            if(track_stats)
+            {
+                ++counters.destroys;
+            }
         }
 
-        poolobjsignal_t* object_signal(uint32_t loc)
+        /** Reserve space for multiple objects in the pool.
+         * \param the number of objects we want to create
+         * \return the number of objects we have room for, which is less
+         * than requested only in failsafe mode
+         */
+        uint32_t reserve_n(uint32_t n)
         {
-            return &(pool_root[loc].signal_deinit);
+            uint32_t available = pool_size - pool_live;
+            if(available < n)
+            {
+                // If we're not in failsafe mode, create nothing.
+                if(!failsafe)
+                {
+                    count_failed(n, false);
+                    throw e_pool_full();
+                }
+                count_failed(n - available, true);
+                return available;
+            }
+            return n;
         }
 
     public:
         /** Define an empty Pool. */
         Pool()
-        :pool_size(0), failsafe(false), pool_root(nullptr)
+        :pool_root(nullptr), pool_size(0), pool_live(0), handle_count(0),
+         handle_slot(nullptr), slot_handle(nullptr), handle_signal(nullptr),
+         failsafe(false), pool_occupied(nullptr), pool_occupied_words(0),
+         pool_open_word(0), track_stats(false)
         {}
 
         /** Define a new Pool of size n.
              * \param the maximum number of objects in the pool
              * \param whether to throw an exception on create() if pool is full
+             * \param whether to gather usage statistics (see stats())
              */
-        Pool(const uint32_t n, bool fs=false)
-        :pool_size(n), failsafe(fs)
+        Pool(const uint32_t n, bool fs=false, bool st=false)
+        :pool_size(n), pool_live(0), failsafe(fs), pool_open_word(0),
+         track_stats(st)
         {
             /* If the specified size is also the maximum valid integer,
                 * which we reserved for our invalid index marker, use one less.
@@ -175,6 +439,16 @@ class Pool
             // We dynamically allocate all the space up front.
             pool_root = new poolobj_t[pool_size];
 
+            // Allocate the handle table.
+            handle_count = pool_size;
+            handle_slot = new uint32_t[handle_count];
+            slot_handle = new uint32_t[pool_size];
+            handle_signal = new poolobjsignal_t[handle_count];
+
+            // Allocate the occupancy bitmap, with every object marked dead.
+            pool_occupied_words = (pool_size >> 6) + ((pool_size & 63) ? 1 : 0);
+            pool_occupied = new uint64_t[pool_occupied_words]();
+
             populate_stack();
         }
 
@@ -193,6 +467,7 @@ class Pool
             // If the pool is full...
             if(loc == INVALID_INDEX)
             {
+                count_failed(1, failsafe);
                 // If we're in failsafe mode...
                 if(failsafe)
                 {
@@ -205,9 +480,11 @@ class Pool
 
             // Initiate the object.
             pool_root[loc].init();
+            uint32_t handle = bind(loc);
+            count_created(1);
 
             // Define and return a new pool reference.
-            return poolref_t(this, loc, object_signal(loc));
+            return poolref_t(this, handle, object_signal(handle));
         }
 
         /** Create a new object in our pool, using either
@@ -224,6 +501,7 @@ class Pool
             // If the pool is full...
             if(loc == INVALID_INDEX)
             {
+                count_failed(1, failsafe);
                 // If we're in failsafe mode...
                 if(failsafe)
                 {
@@ -237,9 +515,11 @@ class Pool
             /* Initiate that object using the passed object (i.e. from the
                 * constructor). */
             pool_root[loc].init(cpy);
+            uint32_t handle = bind(loc);
+            count_created(1);
 
             // Define and return a new pool reference.
-            return poolref_t(this, loc, object_signal(loc));
+            return poolref_t(this, handle, object_signal(handle));
         }
 
         /** Provides direct access to an object in the pool via its reference.
@@ -248,24 +528,10 @@ class Pool
              */
         T& access(poolref_t& rf)
         {
-            // If the reference does not belong to the pool.
-            if(rf.pool_ptr != this)
-            {
-                // Throw a foreign reference error.
-                throw e_pool_foreign_ref();
-            }
-            /* Else if the reference points to an invalid index (such as when
-                * the reference was returned from an create() on a full, failsafe
-                * pool. */
-            else if(rf.getIndex() == INVALID_INDEX)
-            {
-                throw e_pool_invalid_ref();
-            }
+            // Throw if the reference is foreign or invalid.
+            validate_ref(rf);
             // Otherwise, we're good - return the stored object.
-            else
-            {
-                return pool_root[rf.getIndex()].object;
-            }
+            return pool_root[handle_slot[rf.getIndex()]].object;
         }
 
         /** Deinitialize the object in the pool at the given reference.
@@ -273,40 +539,231 @@ class Pool
              */
         void destroy(poolref_t& rf)
         {
-            // If the reference does not belong to the pool.
-            if(rf.pool_ptr != this)
+            // Throw if the reference is foreign or invalid.
+            validate_ref(rf);
+            // Otherwise, we're good - deinitialize the object.
+            release(rf.getIndex());
+        }
+
+        /** Create several new objects in our pool at once, using the
+         * object's default constructor.
+         * If the pool doesn't have room for all of them, no objects are
+         * created and e_pool_full is thrown. In failsafe mode, as many
+         * objects as will fit are created instead, and the rest of the
+         * references are made invalid.
+         * \param the number of objects to create
+         * \param an array of at least that many pool references, which
+         * will be assigned the references to the new objects
+         * \return the number of objects created
+         */
+        uint32_t create_n(uint32_t n, poolref_t* refs)
+        {
+            uint32_t count = reserve_n(n);
+            for(uint32_t i = 0; i < count; ++i)
             {
-                // Throw a foreign reference error.
-                throw e_pool_foreign_ref();
+                uint32_t loc = find_open();
+                pool_root[loc].init();
+                refs[i].connect(this, bind(loc));
             }
-            /* Else if the reference points to an invalid index (such as when
-                * the reference was returned from an create() on a full, failsafe
-                * pool. */
-            else if(rf.getIndex() == INVALID_INDEX)
+            count_created(count);
+            // Any references we couldn't fill (failsafe only) are invalid.
+            for(uint32_t i = count; i < n; ++i)
             {
-                throw e_pool_invalid_ref();
+                refs[i].connect(this, INVALID_INDEX);
             }
-            // Otherwise, we're good - deinitialize the object.
-            else
+            return count;
+        }
+
+        /** Create several new objects in our pool at once, using the
+         * object's copy constructor.
+         * If the pool doesn't have room for all of them, no objects are
+         * created and e_pool_full is thrown. In failsafe mode, as many
+         * objects as will fit are created instead, and the rest of the
+         * references are made invalid.
+         * \param the number of objects to create
+         * \param an array of at least that many pool references, which
+         * will be assigned the references to the new objects
+         * \param the object to copy each new object from
+         * \return the number of objects created
+         */
+        uint32_t create_n(uint32_t n, poolref_t* refs, const T& cpy)
+        {
+            uint32_t count = reserve_n(n);
+            for(uint32_t i = 0; i < count; ++i)
+            {
+                uint32_t loc = find_open();
+                pool_root[loc].init(cpy);
+                refs[i].connect(this, bind(loc));
+            }
+            count_created(count);
+            // Any references we couldn't fill (failsafe only) are invalid.
+            for(uint32_t i = count; i < n; ++i)
+            {
+                refs[i].connect(this, INVALID_INDEX);
+            }
+            return count;
+        }
+
+        /** Deinitialize several objects in the pool at once.
+         * All of the references are validated before anything is
+         * destroyed, so if any one is foreign or invalid, the appropriate
+         * exception is thrown and no objects are destroyed. References
+         * to an object that appears more than once are only destroyed once.
+         * \param the number of references
+         * \param an array of pool references to the objects to destroy
+         * \return the number of objects destroyed
+         */
+        uint32_t destroy_n(uint32_t n, poolref_t* refs)
+        {
+            for(uint32_t i = 0; i < n; ++i)
             {
-                try
+                validate_ref(refs[i]);
+            }
+
+            uint32_t count = 0;
+            for(uint32_t i = 0; i < n; ++i)
+            {
+                /* An earlier reference to the same object may have already
+                 * destroyed it, and thereby invalidated this one. */
+                if(refs[i].getIndex() != INVALID_INDEX)
                 {
-                    /* Mark this index as up for grabs. We must do this now,
-                    * before the reference is invalidated. */
-                    index_available.push(rf.getIndex());
+                    release(refs[i].getIndex());
+                    ++count;
                 }
-                catch(std::length_error&)
+            }
+            return count;
+        }
+
+        /** Move live objects toward the front of the pool, so that they
+         * occupy a dense block at the start of its memory. Each call moves
+         * at most n objects, so compaction can be spread out over time.
+         * Pool references remain valid, and still refer to the same objects.
+         * Objects must be move-constructible.
+         * \param the maximum number of objects to move, or INVALID_INDEX
+         * (the default) to compact the pool completely
+         * \return the number of objects moved, which is 0 if the pool was
+         * already compact
+         */
+        uint32_t compact(uint32_t n = INVALID_INDEX)
+        {
+            uint32_t moved = 0;
+            uint32_t word = (pool_occupied_words > 0) ? pool_occupied_words - 1 : 0;
+            while(moved < n)
+            {
+                uint32_t to = find_open();
+                /* If the lowest open position is past the end of the live
+                    * objects, they're already packed together. */
+                if(to == INVALID_INDEX || to >= pool_live)
                 {
-                    // Just don't bother pushing.
+                    break;
                 }
+                // There is some live object after the open position.
+                relocate(find_last_live(word), to);
+                ++moved;
+            }
+            return moved;
+        }
+
+        /** Compact the pool completely, and then reduce its maximum size,
+         * freeing the memory for the rest. The maximum size is never reduced
+         * below the number of live objects.
+         * \param the new maximum number of objects in the pool
+         * \return the new maximum number of objects in the pool
+         */
+        uint32_t shrink(uint32_t n = 0)
+        {
+            if(n < pool_live)
+            {
+                n = pool_live;
+            }
+            if(n >= pool_size)
+            {
+                return pool_size;
+            }
 
-                // Deinitialize the object.
-                pool_root[rf.getIndex()].deinit();
-                /* References are invalidated via the signal dispatched from
-                    * pool_obj<T>::deinit(). */
+            compact();
+
+            /* Move the live objects, which are now at the front, to a new
+                * pool. Allocating the slots doesn't construct any objects. */
+            poolobj_t* new_root = new poolobj_t[n];
+            uint32_t* new_slot_handle = new uint32_t[n];
+            for(uint32_t i = 0; i < pool_live; ++i)
+            {
+                new_root[i].init(std::move(pool_root[i].object));
+                pool_root[i].deinit();
+                new_slot_handle[i] = slot_handle[i];
+            }
+            delete[] pool_root;
+            delete[] slot_handle;
+            pool_root = new_root;
+            slot_handle = new_slot_handle;
+
+            // Rebuild the occupancy bitmap for the smaller pool.
+            delete[] pool_occupied;
+            pool_size = n;
+            pool_occupied_words = (pool_size >> 6) + ((pool_size & 63) ? 1 : 0);
+            pool_occupied = new uint64_t[pool_occupied_words]();
+            pool_open_word = 0;
+            for(uint32_t i = 0; i < pool_live; ++i)
+            {
+                mark_live(i);
+            }
+
+            return pool_size;
+        }
+
+        /** Call a function on every live object in the pool.
+         * Objects are visited in the order they are stored in memory,
+         * by walking the occupancy bitmap, so no pool references are
+         * needed. Objects must NOT be created or destroyed in this pool
+         * from within the function.
+         * \param the function or functor to call, which must accept a T&
+         */
+        template<typename F>
+        void for_each_live(F func)
+        {
+            for(uint32_t w = 0; w < pool_occupied_words; ++w)
+            {
+                uint64_t word = pool_occupied[w];
+                const uint32_t base = w << 6;
+                // Visit each set bit in the word, lowest first.
+                while(word != 0)
+                {
+                    func(pool_root[base + __builtin_ctzll(word)].object);
+                    // Clear the lowest set bit.
+                    word &= (word - 1);
+                }
             }
         }
 
+        /** Turn usage statistics on or off. Counters gathered so far are
+         * kept; use reset_stats() to clear them.
+         * \param whether to gather usage statistics */
+        void set_stats(bool st)
+        {
+            track_stats = st;
+        }
+
+        /** Clear all usage counters. The high-water mark is reset to the
+         * number of objects currently live. */
+        void reset_stats()
+        {
+            counters = pool_stats();
+            counters.high_water = pool_live;
+        }
+
+        /** Take a snapshot of the pool's occupancy and usage statistics.
+         * The capacity and live count are always accurate; the other
+         * counters only reflect activity while statistics were enabled.
+         * \return a copy of the pool statistics */
+        pool_stats stats()
+        {
+            pool_stats snapshot = counters;
+            snapshot.capacity = pool_size;
+            snapshot.live = pool_live;
+            return snapshot;
+        }
+
         /** Returns the size of the pool in bytes. Does not count the
              * pool's internal metadata, which is negligible in size.*/
         uint32_t size()
@@ -318,22 +775,44 @@ class Pool
 
         ~Pool()
         {
+            /* Invalidate all the references to objects that are still live,
+                * and destroy those objects. */
+            for(uint32_t w = 0; w < pool_occupied_words; ++w)
+            {
+                uint64_t word = pool_occupied[w];
+                const uint32_t base = w << 6;
+                while(word != 0)
+                {
+                    const uint32_t loc = base + __builtin_ctzll(word);
+                    poolobjsignal_t* signal = object_signal(slot_handle[loc]);
+                    signal->dispatch();
+                    signal->clear();
+                    pool_root[loc].deinit();
+                    word &= (word - 1);
+                }
+            }
+
             // Deallocate and destroy the entire pool.
+            delete[] pool_occupied;
+            delete[] handle_signal;
+            delete[] slot_handle;
+            delete[] handle_slot;
             delete[] pool_root;
         }
+
 };
 
 /** References an object in a Pool. Should always be used as a constant.*/
-template<typename T>
+template<typename T, bool padded>
 class pool_ref
 {
     // The Pool class must be able to access private members in the reference.
-    friend class Pool<T>;
+    friend class Pool<T, padded>;
     private:
         // Define our pool object type.
-        typedef pool_obj<T> poolobj_t;
+        typedef pool_obj<T, padded> poolobj_t;
         // Define our pool type.
-        typedef Pool<T> pool_t;
+        typedef Pool<T, padded> pool_t;
         typedef cpgf::GCallbackList<void ()> poolobjsignal_t;
 
         /** We store the pointer to the pool, first to validate that the
@@ -341,7 +820,7 @@ class pool_ref
          * to get an object's destroy signal. */
         pool_t* pool_ptr;
 
-        /** The index of the referenced object in the pool. Although it is
+        /** The handle of the referenced object in the pool. Although it is
              * possible to access and modify this directly from a friend class
              * (such as Pool), the getIndex() and invalidate() functions should
              * be used instead. */
@@ -350,13 +829,13 @@ class pool_ref
         /** Create a new pool reference. Intended to only be called from within
              * the pool class.
              * \param the pointer to the pool class
-             * \param the index of the referenced object in the pool
+             * \param the handle of the referenced object in the pool
              * \param the object destroy signal to connect to
              */
         pool_ref(pool_t* pool, uint32_t i, poolobjsignal_t* signal)
         :pool_ptr(pool), index(i)
         {
-            signal->add(cpgf::makeCallback(this, &pool_ref<T>::invalidate));
+            signal->add(cpgf::makeCallback(this, &pool_ref::invalidate));
         }
 
         /** Sets the reference's index to INVALID. */
@@ -373,7 +852,24 @@ class pool_ref
         {
             if(pool_ptr != nullptr && index != INVALID_INDEX)
             {
-                pool_ptr->object_signal(index)->remove(cpgf::makeCallback(this, &pool_ref<T>::invalidate));
+                pool_ptr->object_signal(index)->remove(cpgf::makeCallback(this, &pool_ref::invalidate));
+            }
+        }
+
+        /** Point this reference at a (possibly different) object,
+             * disconnecting from the old one first.
+             * \param the pointer to the pool class
+             * \param the handle of the referenced object in the pool,
+             * or INVALID_INDEX to make the reference invalid
+             */
+        void connect(pool_t* pool, uint32_t i)
+        {
+            disconnect();
+            pool_ptr = pool;
+            index = i;
+            if(index != INVALID_INDEX)
+            {
+                pool_ptr->object_signal(index)->add(cpgf::makeCallback(this, &pool_ref::invalidate));
             }
         }
 
@@ -404,23 +900,23 @@ class pool_ref
         /** Copy constructor.
              * \param the reference to copy
              */
-        pool_ref(const pool_ref<T>& cpy)
+        pool_ref(const pool_ref& cpy)
         :pool_ptr(cpy.pool_ptr), index(cpy.index)
         {
             if(pool_ptr && index != INVALID_INDEX)
             {
-                pool_ptr->object_signal(index)->add(cpgf::makeCallback(this, &pool_ref<T>::invalidate));
+                pool_ptr->object_signal(index)->add(cpgf::makeCallback(this, &pool_ref::invalidate));
             }
         }
 
-        void operator=(const pool_ref<T>& cpy)
+        void operator=(const pool_ref& cpy)
         {
             disconnect();
             pool_ptr = cpy.pool_ptr;
             index = cpy.index;
             if(index != INVALID_INDEX)
             {
-                pool_ptr->object_signal(index)->add(cpgf::makeCallback(this, &pool_ref<T>::invalidate));
+                pool_ptr->object_signal(index)->add(cpgf::makeCallback(this, &pool_ref::invalidate));
             }
         }
 
@@ -434,47 +930,42 @@ class pool_ref
             return (index == INVALID_INDEX);
         }
 
-        ~pool_ref(){}
+        /** Disconnect from the object, so that its signal never calls back
+             * into a reference that no longer exists. */
+        ~pool_ref()
+        {
+            disconnect();
+        }
 };
 
-/** An object in a Pool. Should NOT be used directly. */
-template<typename T>
-class pool_obj
+/** An object in a Pool. Should NOT be used directly.
+ * Whether the object is live is tracked by the Pool's occupancy bitmap, so
+ * the slot holds nothing but raw storage for the object, which is only
+ * constructed by init() and destroyed by deinit(). With the padded layout,
+ * each slot is also aligned to (and so fills) at least one cache line. */
+template<typename T, bool padded>
+class alignas((padded && CACHE_LINE_SIZE > alignof(T)) ? CACHE_LINE_SIZE : alignof(T))
+pool_obj
 {
-    friend class Pool<T>;
+    friend class Pool<T, padded>;
     private:
-        pool_obj<T>()
-        :live(false)
+        /// Leaves the storage uninitialized; the object is not constructed.
+        pool_obj()
         {}
 
-        /* NOTE: The presence of 'live' adds a maximum of 8 bytes over the base
-            * type T, due to padding. */
-
-        typedef cpgf::GCallbackList<void ()> poolobjsignal_t;
-        poolobjsignal_t signal_deinit;
-
-        /// Marks whether the object is initialized or not.
-        bool live;
-
-        /// The object itself.
-        T object;
+        union
+        {
+            /// The object itself, only alive between init() and deinit().
+            T object;
+        };
 
         /** Initialize the object using its default constructor.
              * (Yes, this IS used, despite what the linters think.) */
         //cppcheck-suppress unusedPrivateFunction
         void init()
         {
-            // If the object is already live...
-            if(live)
-            {
-                // Throw an error.
-                throw e_pool_reinit();
-            }
-
-            // Mark the object as live.
-            live = true;
             // Use the object's default constructor.
-            object = T();
+            new (&object) T();
         }
 
         /** Initialize the object using its copy constructor.
@@ -483,50 +974,37 @@ class pool_obj
         //cppcheck-suppress unusedPrivateFunction
         void init(const T& cpy)
         {
-            // If the object is already live...
-            if(live)
-            {
-                // Throw an error.
-                throw e_pool_reinit();
-            }
-
-            // Mark the object as live.
-            live = true;
             // Use the object's copy constructor.
-            object = T(cpy);
+            new (&object) T(cpy);
+        }
+
+        /** Initialize the object by moving another object into it.
+             * \param the object to move into the new object
+             */
+        //cppcheck-suppress unusedPrivateFunction
+        void init(T&& mv)
+        {
+            // Use the object's move constructor.
+            new (&object) T(std::move(mv));
         }
 
         /** Deinitialize the object. */
         //cppcheck-suppress unusedPrivateFunction
         void deinit()
         {
-            // Order all the references to invalidate.
-            signal_deinit.dispatch();
+            /* The references are invalidated by Pool, since they are
+                * connected to the object's handle rather than the object. */
 
             // Explicitly call the object's destructor.
             object.~T();
-
-            // Mark the object as uninitialized (not live).
-            live = false;
-
-            /* Remove all the object's callbacks. This is a backup in
-                * case a disconnect() from a reference doesn't work right.
-                * BUG T1086: In some situations, references were not
-                * disconnecting themselves from the object. Thus, if the
-                * object was recycled, sometimes old signals would persist.
-                * To get around this, we just have the object remove its
-                * own signals.
-                * REVISED 13 AUG: CallbackList now provides clear()
-                */
-            signal_deinit.clear();
-
         }
 
     public:
         /* Our constructors are all private, to prevent instantiation
             * of pool_obj outside of the friend Pool class.*/
 
-        /// Destructor
+        /** Destructor. Does not destroy the object, which Pool must
+         * deinitialize first if it is live. */
         ~pool_obj(){}
 };
 
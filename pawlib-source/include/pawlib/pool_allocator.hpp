@@ -0,0 +1,244 @@
+/** Pool Allocator [PawLIB]
+  * Version: 1.0
+  *
+  * A fixed-size-block variant of Pool, and an allocator adapter over it
+  * that node-based containers (such as std::list and std::map) can use
+  * for pool-speed allocation.
+  *
+  * Author(s): Jason C. McDonald
+  */
+
+/* LICENSE (BSD-3-Clause)
+ * Copyright (c) 2016-2019 MousePaw Media.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * CONTRIBUTING
+ * See https://www.mousepawmedia.com/developers for information
+ * on how to contribute to our projects.
+ */
+
+#ifndef PAWLIB_POOL_ALLOCATOR_HPP
+#define PAWLIB_POOL_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+
+#include "pawlib/pool.hpp"
+
+/** A pool of fixed-size, uninitialized blocks of memory. Unlike Pool,
+ * BlockPool knows nothing about the type stored in it, and hands out raw
+ * memory instead of references. Free blocks are kept in an intrusive free
+ * list, so allocation and deallocation are both O(1). */
+class BlockPool
+{
+    private:
+        /// Every free block stores a pointer to the next free block.
+        struct free_block
+        {
+            free_block* next;
+        };
+
+        /** Every chunk of blocks begins with a pointer to the previously
+         * allocated chunk, so we can release them all later. */
+        struct chunk_header
+        {
+            chunk_header* prev;
+        };
+
+        /// The size of the chunk header, padded to maintain alignment.
+        static const size_t HEADER_SIZE =
+            ((sizeof(chunk_header) + alignof(std::max_align_t) - 1)
+            / alignof(std::max_align_t)) * alignof(std::max_align_t);
+
+        /// The size of each block in bytes.
+        size_t _block_size;
+
+        /// The total number of blocks in the pool.
+        uint32_t _capacity;
+
+        /// Whether to allocate another chunk when the pool is full.
+        bool _grow;
+
+        /// The head of the free list.
+        free_block* free_list;
+
+        /// The most recently allocated chunk.
+        chunk_header* chunks;
+
+        /** Allocate a new chunk of blocks and add them to the free list.
+             * \param the number of blocks in the chunk */
+        void add_chunk(uint32_t blocks);
+
+    public:
+        /** Define a new BlockPool.
+             * \param the size of each block in bytes. This is rounded up to
+             * maintain alignment, and to fit a pointer.
+             * \param the number of blocks to allocate up front
+             * \param whether to allocate more blocks when the pool is full.
+             * If false, allocate() throws e_pool_full instead. */
+        explicit BlockPool(size_t block_size, uint32_t blocks = 64, bool grow = true);
+
+        // Copy constructor and copy assignment don't make sense for BlockPool!
+        BlockPool(const BlockPool&) = delete;
+        BlockPool& operator=(const BlockPool&) = delete;
+
+        /** Get an uninitialized block from the pool.
+             * \return a pointer to the block */
+        void* allocate()
+        {
+            if(free_list == nullptr)
+            {
+                if(!_grow)
+                {
+                    throw e_pool_full();
+                }
+                // Each new chunk doubles the capacity of the pool.
+                add_chunk(_capacity > 0 ? _capacity : 1);
+            }
+            free_block* block = free_list;
+            free_list = block->next;
+            return block;
+        }
+
+        /** Return a block to the pool. The block MUST have come from this
+             * pool, and must not be used again afterwards.
+             * \param a pointer to the block */
+        void deallocate(void* ptr)
+        {
+            free_block* block = static_cast<free_block*>(ptr);
+            block->next = free_list;
+            free_list = block;
+        }
+
+        /** Returns the size of each block in bytes, after rounding. */
+        size_t block_size() const { return _block_size; }
+
+        /** Returns the total number of blocks in the pool, used or not. */
+        uint32_t capacity() const { return _capacity; }
+
+        /** Releases all of the pool's memory. Any blocks still in use
+             * become invalid. */
+        ~BlockPool();
+};
+
+/** An allocator for use with standard-compatible containers, which gets
+ * single objects from a BlockPool shared by all pool_allocators of the
+ * same type. Requests for more than one object at a time (such as array
+ * storage) fall back to the global heap, so this is best suited to
+ * node-based containers like std::list and std::map. Types aligned more
+ * strictly than std::max_align_t also come from the global heap, with
+ * their alignment respected.
+ * Each shared pool is guarded by its own lock, so containers using it
+ * can safely be used on different threads. (As with the standard
+ * allocator, a single container still isn't thread-safe by itself.) */
+template<typename T>
+class pool_allocator
+{
+    public:
+        typedef T value_type;
+
+        template<typename U>
+        struct rebind
+        {
+            typedef pool_allocator<U> other;
+        };
+
+        pool_allocator() noexcept {}
+
+        template<typename U>
+        // cppcheck-suppress noExplicitConstructor
+        pool_allocator(const pool_allocator<U>&) noexcept {}
+
+        /** Returns the BlockPool shared by all pool_allocators of this type.
+             * The pool is intentionally never destroyed, so that containers
+             * with static storage duration can safely deallocate into it
+             * during program exit. Lock block_pool_lock() while using it. */
+        static BlockPool& block_pool()
+        {
+            static BlockPool* pool = new BlockPool(sizeof(T));
+            return *pool;
+        }
+
+        /** Returns the lock guarding block_pool(). Like the pool, it is
+             * never destroyed. */
+        static std::mutex& block_pool_lock()
+        {
+            static std::mutex* lock = new std::mutex();
+            return *lock;
+        }
+
+        /** Allocate uninitialized storage.
+             * \param the number of objects to allocate storage for
+             * \return a pointer to the storage */
+        T* allocate(size_t n)
+        {
+            if(n == 1 && alignof(T) <= alignof(std::max_align_t))
+            {
+                std::lock_guard<std::mutex> guard(block_pool_lock());
+                return static_cast<T*>(block_pool().allocate());
+            }
+            if(alignof(T) > alignof(std::max_align_t))
+            {
+                // Plain operator new only guarantees max_align_t.
+                return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+            }
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+
+        /** Deallocate storage obtained from allocate().
+             * \param the pointer to the storage
+             * \param the number of objects it was allocated for */
+        void deallocate(T* ptr, size_t n)
+        {
+            if(n == 1 && alignof(T) <= alignof(std::max_align_t))
+            {
+                std::lock_guard<std::mutex> guard(block_pool_lock());
+                block_pool().deallocate(ptr);
+                return;
+            }
+            if(alignof(T) > alignof(std::max_align_t))
+            {
+                ::operator delete(ptr, std::align_val_t(alignof(T)));
+                return;
+            }
+            ::operator delete(ptr);
+        }
+};
+
+/* All pool_allocators draw from the same shared pools, so they are
+ * always interchangeable. */
+template<typename T, typename U>
+bool operator==(const pool_allocator<T>&, const pool_allocator<U>&) { return true; }
+
+template<typename T, typename U>
+bool operator!=(const pool_allocator<T>&, const pool_allocator<U>&) { return false; }
+
+#endif // PAWLIB_POOL_ALLOCATOR_HPP
@@ -42,11 +42,16 @@
 #ifndef PAWLIB_POOL_TESTS_HPP
 #define PAWLIB_POOL_TESTS_HPP
 
+#include <list>
+#include <map>
 #include <new>
+#include <string>
+#include <thread>
 
 #include "pawlib/flex_array.hpp"
 #include "pawlib/goldilocks.hpp"
 #include "pawlib/pool.hpp"
+#include "pawlib/pool_allocator.hpp"
 #include "pawlib/stdutils.hpp"
 
 class DummyClass
@@ -128,8 +133,9 @@ class TestPool_ThriceFillAlloc : public Test
 class TestPool_ThriceFill : public Test
 {
     public:
-        // cppcheck-suppress uninitMemberVar
-        TestPool_ThriceFill(){}
+        TestPool_ThriceFill()
+        :pool(nullptr), refs(nullptr)
+        {}
 
         testdoc_t get_title() override
         {
@@ -225,8 +231,8 @@ class TestPool_Create : public Test
             COPY_FAILSAFE
         };
 
-        // cppcheck-suppress uninitMemberVar
         explicit TestPool_Create(TestPoolCreateMode mode)
+        :copyconst(false), failsafe(false), pool(nullptr)
         {
             switch(mode)
             {
@@ -351,8 +357,9 @@ class TestPool_Create : public Test
 class TestPool_Access : public Test
 {
     public:
-        // cppcheck-suppress uninitMemberVar
-        TestPool_Access(){}
+        TestPool_Access()
+        :pool(nullptr)
+        {}
 
         testdoc_t get_title() override
         {
@@ -427,8 +434,9 @@ class TestPool_Access : public Test
 class TestPool_Destroy : public Test
 {
     public:
-        // cppcheck-suppress uninitMemberVar
-        TestPool_Destroy(){}
+        TestPool_Destroy()
+        :pool(nullptr)
+        {}
 
         testdoc_t get_title() override
         {
@@ -513,9 +521,8 @@ class TestPool_Exception : public Test
             POOL_DES_FOREIGN_REF
         };
 
-        // cppcheck-suppress uninitMemberVar
         explicit TestPool_Exception(FailTestType ex)
-        :type(ex)
+        :type(ex), pool(nullptr)
         {
             switch(type)
             {
@@ -701,6 +708,999 @@ class TestPool_Exception : public Test
         testdoc_t docs;
 };
 
+// P-tB160E - P-tB160F
+class TestPool_CreateN : public Test
+{
+    public:
+        explicit TestPool_CreateN(bool fs)
+        :failsafe(fs), pool(nullptr)
+        {}
+
+        testdoc_t get_title() override
+        {
+            if(failsafe)
+            {
+                return "Pool: Bulk Create, Failsafe";
+            }
+            return "Pool: Bulk Create";
+        }
+
+        testdoc_t get_docs() override
+        {
+            if(failsafe)
+            {
+                return "Create more objects than will fit in a failsafe pool with create_n(), and ensure the remaining references are invalid.";
+            }
+            return "Create several objects with create_n(), and ensure creating more than will fit throws e_pool_full without creating anything.";
+        }
+
+        bool janitor() override
+        {
+            delete pool;
+            pool = new Pool<DummyClass>(iters, failsafe);
+            return (pool != nullptr);
+        }
+
+        bool run() override
+        {
+            if(failsafe)
+            {
+                PL_ASSERT_EQUAL(pool->create_n(iters / 2, refs), iters / 2);
+                // Only half of these will fit.
+                PL_ASSERT_EQUAL(pool->create_n(iters, refs + (iters / 2)), iters / 2);
+                for(uint32_t i = 0; i < iters; ++i)
+                {
+                    PL_ASSERT_FALSE(refs[i].invalid());
+                }
+                for(uint32_t i = iters; i < iters + (iters / 2); ++i)
+                {
+                    PL_ASSERT_TRUE(refs[i].invalid());
+                }
+                return true;
+            }
+
+            PL_ASSERT_EQUAL(pool->create_n(iters / 2, refs, DummyClass(5,4,3,2,1)), iters / 2);
+            try
+            {
+                pool->create_n(iters, refs + (iters / 2));
+                return false;
+            }
+            catch(e_pool_full&)
+            {
+                // This is what we expected.
+            }
+            // The failed call must not have used up any space.
+            PL_ASSERT_EQUAL(pool->create_n(iters / 2, refs + (iters / 2)), iters / 2);
+            return true;
+        }
+
+        bool post() override
+        {
+            delete pool;
+            pool = nullptr;
+            return true;
+        }
+
+        ~TestPool_CreateN(){}
+
+    private:
+        static const uint32_t iters = 64;
+
+        bool failsafe;
+        Pool<DummyClass>* pool;
+        pool_ref<DummyClass> refs[iters + (iters / 2)];
+};
+
+// P-tB1610
+class TestPool_DestroyN : public Test
+{
+    public:
+        TestPool_DestroyN()
+        :pool(nullptr)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return "Pool: Bulk Destroy";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Destroy several objects with destroy_n(), and ensure all of their references are invalidated.";
+        }
+
+        bool janitor() override
+        {
+            delete pool;
+            pool = new Pool<DummyClass>(iters);
+            if(pool == nullptr)
+            {
+                return false;
+            }
+            return (pool->create_n(iters, refs) == iters);
+        }
+
+        bool run() override
+        {
+            // A copy of a reference in the same batch is only destroyed once.
+            refs[iters] = refs[0];
+            PL_ASSERT_EQUAL(pool->destroy_n(iters + 1, refs), iters);
+            for(uint32_t i = 0; i < iters + 1; ++i)
+            {
+                PL_ASSERT_TRUE(refs[i].invalid());
+            }
+
+            // All of the space should be available again.
+            PL_ASSERT_EQUAL(pool->create_n(iters, refs), iters);
+            return true;
+        }
+
+        bool post() override
+        {
+            delete pool;
+            pool = nullptr;
+            return true;
+        }
+
+        ~TestPool_DestroyN(){}
+
+    private:
+        static const uint32_t iters = 100;
+
+        Pool<DummyClass>* pool;
+        pool_ref<DummyClass> refs[iters + 1];
+};
+
+// P-tB1611*
+class TestPool_AccessEach : public Test
+{
+    public:
+        TestPool_AccessEach()
+        :pool(nullptr), refs(nullptr)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return "Pool: Update Live Objects (Access)";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Update every live object in a half-full " + stdutils::itos(iters) + "-object pool by accessing each through its reference.";
+        }
+
+        bool pre() override
+        {
+            pool = new Pool<DummyClass>(iters);
+            refs = new pool_ref<DummyClass>[iters];
+            pool->create_n(iters, refs);
+            // Leave every other object live.
+            for(uint32_t i = 0; i < iters; i += 2)
+            {
+                pool->destroy(refs[i]);
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            uint32_t count = 0;
+            for(uint32_t i = 0; i < iters; ++i)
+            {
+                if(!refs[i].invalid())
+                {
+                    pool->access(refs[i]) = DummyClass(2, 3, 4, 5, 6);
+                    ++count;
+                }
+            }
+            return (count == iters / 2);
+        }
+
+        bool post() override
+        {
+            delete[] refs;
+            refs = nullptr;
+            delete pool;
+            pool = nullptr;
+            return true;
+        }
+
+        ~TestPool_AccessEach(){}
+
+    private:
+        static const uint32_t iters = 10000;
+
+        Pool<DummyClass>* pool;
+        pool_ref<DummyClass>* refs;
+};
+
+// P-tB1611
+class TestPool_ForEachLive : public Test
+{
+    public:
+        TestPool_ForEachLive()
+        :pool(nullptr), refs(nullptr)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return "Pool: Update Live Objects (for_each_live)";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Update every live object in a half-full " + stdutils::itos(iters) + "-object pool with for_each_live().";
+        }
+
+        bool pre() override
+        {
+            pool = new Pool<DummyClass>(iters);
+            refs = new pool_ref<DummyClass>[iters];
+            pool->create_n(iters, refs);
+            // Leave every other object live.
+            for(uint32_t i = 0; i < iters; i += 2)
+            {
+                pool->destroy(refs[i]);
+            }
+            return true;
+        }
+
+        bool run() override
+        {
+            uint32_t count = 0;
+            pool->for_each_live([&count](DummyClass& obj)
+            {
+                obj = DummyClass(2, 3, 4, 5, 6);
+                ++count;
+            });
+            return (count == iters / 2);
+        }
+
+        bool post() override
+        {
+            delete[] refs;
+            refs = nullptr;
+            delete pool;
+            pool = nullptr;
+            return true;
+        }
+
+        ~TestPool_ForEachLive(){}
+
+    private:
+        static const uint32_t iters = 10000;
+
+        Pool<DummyClass>* pool;
+        pool_ref<DummyClass>* refs;
+};
+
+// P-tB1612 - P-tB1613
+class TestPool_BlockPool : public Test
+{
+    public:
+        explicit TestPool_BlockPool(bool grow)
+        :grow(grow)
+        {}
+
+        testdoc_t get_title() override
+        {
+            if(grow)
+            {
+                return "Pool: BlockPool Growth";
+            }
+            return "Pool: BlockPool Fixed Size";
+        }
+
+        testdoc_t get_docs() override
+        {
+            if(grow)
+            {
+                return "Allocate more blocks than a growable BlockPool starts with, and ensure the blocks are distinct.";
+            }
+            return "Allocate every block in a fixed-size BlockPool, and ensure the next allocation throws e_pool_full.";
+        }
+
+        bool run() override
+        {
+            BlockPool pool(sizeof(DummyClass), blocks, grow);
+            PL_ASSERT_GREATER_EQUAL(pool.block_size(), sizeof(DummyClass));
+            PL_ASSERT_EQUAL(pool.capacity(), blocks);
+
+            void* ptrs[blocks * 2];
+            for(uint32_t i = 0; i < blocks; ++i)
+            {
+                ptrs[i] = pool.allocate();
+                // Make sure the block is really usable.
+                new (ptrs[i]) DummyClass(i);
+            }
+
+            if(!grow)
+            {
+                try
+                {
+                    pool.allocate();
+                    return false;
+                }
+                catch(e_pool_full&)
+                {
+                    // Returning a block should make room for one more.
+                    pool.deallocate(ptrs[0]);
+                    PL_ASSERT_TRUE(pool.allocate() == ptrs[0]);
+                    return true;
+                }
+            }
+
+            for(uint32_t i = blocks; i < blocks * 2; ++i)
+            {
+                ptrs[i] = pool.allocate();
+            }
+            PL_ASSERT_EQUAL(pool.capacity(), blocks * 2);
+
+            // No block should be handed out twice.
+            for(uint32_t i = 1; i < blocks * 2; ++i)
+            {
+                PL_ASSERT_TRUE(ptrs[i] != ptrs[i - 1]);
+            }
+            return true;
+        }
+
+        ~TestPool_BlockPool(){}
+
+    private:
+        static const uint32_t blocks = 16;
+
+        bool grow;
+};
+
+// P-tB1614
+class TestPool_AllocatorContainers : public Test
+{
+    public:
+        TestPool_AllocatorContainers(){}
+
+        testdoc_t get_title() override
+        {
+            return "Pool: pool_allocator with std::list and std::map";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Use pool_allocator as the allocator for std::list and std::map, and ensure the containers behave normally.";
+        }
+
+        bool run() override
+        {
+            std::list<int, pool_allocator<int>> list;
+            for(int i = 0; i < 100; ++i)
+            {
+                list.push_back(i);
+            }
+            list.remove_if([](int i){ return (i % 2) == 0; });
+            PL_ASSERT_EQUAL(list.size(), 50u);
+            PL_ASSERT_EQUAL(list.front(), 1);
+            PL_ASSERT_EQUAL(list.back(), 99);
+
+            std::map<int, int, std::less<int>,
+                pool_allocator<std::pair<const int, int>>> map;
+            for(int i = 0; i < 100; ++i)
+            {
+                map[i] = i * 2;
+            }
+            map.erase(50);
+            PL_ASSERT_EQUAL(map.size(), 99u);
+            PL_ASSERT_EQUAL(map[99], 198);
+            PL_ASSERT_EQUAL(map.count(50), 0u);
+            return true;
+        }
+
+        ~TestPool_AllocatorContainers(){}
+};
+
+// P-tB1615*
+class TestPool_ListStdAllocator : public Test
+{
+    public:
+        TestPool_ListStdAllocator(){}
+
+        testdoc_t get_title() override
+        {
+            return "Pool: std::list Churn (std::allocator)";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Push and pop " + stdutils::itos(iters) + " Dummy objects on a std::list using the default allocator.";
+        }
+
+        bool run() override
+        {
+            std::list<DummyClass> list;
+            for(int i = 0; i < iters; ++i)
+            {
+                list.push_back(DummyClass(i));
+            }
+            while(!list.empty())
+            {
+                list.pop_front();
+            }
+            return true;
+        }
+
+        ~TestPool_ListStdAllocator(){}
+
+    private:
+        static const int iters = 1000;
+};
+
+// P-tB1615
+class TestPool_ListPoolAllocator : public Test
+{
+    public:
+        TestPool_ListPoolAllocator(){}
+
+        testdoc_t get_title() override
+        {
+            return "Pool: std::list Churn (pool_allocator)";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Push and pop " + stdutils::itos(iters) + " Dummy objects on a std::list using pool_allocator.";
+        }
+
+        bool run() override
+        {
+            std::list<DummyClass, pool_allocator<DummyClass>> list;
+            for(int i = 0; i < iters; ++i)
+            {
+                list.push_back(DummyClass(i));
+            }
+            while(!list.empty())
+            {
+                list.pop_front();
+            }
+            return true;
+        }
+
+        ~TestPool_ListPoolAllocator(){}
+
+    private:
+        static const int iters = 1000;
+};
+
+// P-tB1616
+class TestPool_Stats : public Test
+{
+    public:
+        TestPool_Stats(){}
+
+        testdoc_t get_title() override
+        {
+            return "Pool: Usage Statistics";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Create and destroy objects on a pool with statistics enabled, and check the counters in the stats() snapshot.";
+        }
+
+        bool run() override
+        {
+            // A failsafe pool, with statistics enabled.
+            Pool<DummyClass> pool(size, true, true);
+            pool_ref<DummyClass> refs[size + 2];
+
+            pool_stats stats = pool.stats();
+            PL_ASSERT_EQUAL(stats.capacity, size);
+            PL_ASSERT_EQUAL(stats.live, 0u);
+
+            refs[0] = pool.create();
+            refs[1] = pool.create(DummyClass(1));
+            pool.destroy(refs[0]);
+
+            // Only three of these four will fit.
+            PL_ASSERT_EQUAL(pool.create_n(size, refs + 2), size - 1);
+            // The pool is full, so this one is invalid.
+            refs[0] = pool.create();
+
+            stats = pool.stats();
+            PL_ASSERT_EQUAL(stats.live, size);
+            PL_ASSERT_EQUAL(stats.high_water, size);
+            PL_ASSERT_EQUAL(stats.creates, 5u);
+            PL_ASSERT_EQUAL(stats.destroys, 1u);
+            PL_ASSERT_EQUAL(stats.failed, 2u);
+            PL_ASSERT_EQUAL(stats.failsafe_invalid, 2u);
+
+            // With statistics off, only the live count changes.
+            pool.set_stats(false);
+            PL_ASSERT_EQUAL(pool.destroy_n(size - 1, refs + 2), size - 1);
+            stats = pool.stats();
+            PL_ASSERT_EQUAL(stats.live, 1u);
+            PL_ASSERT_EQUAL(stats.destroys, 1u);
+
+            // Resetting clears the counters, and the peak is the live count.
+            pool.reset_stats();
+            stats = pool.stats();
+            PL_ASSERT_EQUAL(stats.high_water, 1u);
+            PL_ASSERT_EQUAL(stats.creates, 0u);
+            PL_ASSERT_EQUAL(stats.failed, 0u);
+
+            ioc << IOVrb::tmi << IOCat::debug << stats << IOCtrl::endl;
+            return true;
+        }
+
+        ~TestPool_Stats(){}
+
+    private:
+        static const uint32_t size = 4;
+};
+
+// P-tB1617
+class TestPool_Compact : public Test
+{
+    public:
+        TestPool_Compact(){}
+
+        testdoc_t get_title() override
+        {
+            return "Pool: Incremental Compaction";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Compact a sparse pool a few objects at a time, and ensure every reference still refers to its own object.";
+        }
+
+        bool run() override
+        {
+            Pool<uint32_t> pool(size);
+            pool_ref<uint32_t> refs[size];
+            for(uint32_t i = 0; i < size; ++i)
+            {
+                refs[i] = pool.create(i);
+            }
+            // Leave only every fourth object live.
+            for(uint32_t i = 0; i < size; ++i)
+            {
+                if(i % 4 != 0)
+                {
+                    pool.destroy(refs[i]);
+                }
+            }
+
+            // Move no more than ten objects per call.
+            uint32_t total = 0;
+            uint32_t calls = 0;
+            uint32_t moved = 0;
+            do
+            {
+                moved = pool.compact(10);
+                PL_ASSERT_LESS_EQUAL(moved, 10u);
+                total += moved;
+                ++calls;
+            } while(moved > 0);
+            PL_ASSERT_GREATER(calls, 2u);
+            PL_ASSERT_GREATER(total, 0u);
+            PL_ASSERT_EQUAL(pool.compact(), 0u);
+
+            // The references must have followed their objects.
+            for(uint32_t i = 0; i < size; i += 4)
+            {
+                PL_ASSERT_FALSE(refs[i].invalid());
+                PL_ASSERT_EQUAL(pool.access(refs[i]), i);
+            }
+            PL_ASSERT_EQUAL(pool.stats().live, size / 4);
+
+            // Destroying a moved object still invalidates its reference.
+            pool.destroy(refs[size - 4]);
+            PL_ASSERT_TRUE(refs[size - 4].invalid());
+            return true;
+        }
+
+        ~TestPool_Compact(){}
+
+    private:
+        static const uint32_t size = 200;
+};
+
+// P-tB1618
+class TestPool_Shrink : public Test
+{
+    public:
+        TestPool_Shrink(){}
+
+        testdoc_t get_title() override
+        {
+            return "Pool: Shrink";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Shrink a sparse pool, and ensure references survive and the new maximum size is enforced.";
+        }
+
+        bool run() override
+        {
+            Pool<uint32_t> pool(size);
+            pool_ref<uint32_t> refs[size];
+            for(uint32_t i = 0; i < size; ++i)
+            {
+                refs[i] = pool.create(i);
+            }
+            for(uint32_t i = 0; i < size; i += 2)
+            {
+                pool.destroy(refs[i]);
+            }
+
+            // The pool can't shrink below the number of live objects.
+            PL_ASSERT_EQUAL(pool.shrink(), size / 2);
+            PL_ASSERT_EQUAL(pool.shrink(size), size / 2);
+            PL_ASSERT_EQUAL(pool.stats().capacity, size / 2);
+            for(uint32_t i = 1; i < size; i += 2)
+            {
+                PL_ASSERT_EQUAL(pool.access(refs[i]), i);
+            }
+
+            // The pool is full now.
+            try
+            {
+                pool.create(0);
+                return false;
+            }
+            catch(e_pool_full&)
+            {
+                // Expected.
+            }
+
+            // Space freed after shrinking can be reused.
+            pool.destroy(refs[1]);
+            refs[0] = pool.create(42);
+            PL_ASSERT_EQUAL(pool.access(refs[0]), 42u);
+            return true;
+        }
+
+        ~TestPool_Shrink(){}
+
+    private:
+        static const uint32_t size = 100;
+};
+
+// P-tB1619
+class TestPool_PaddedLayout : public Test
+{
+    public:
+        TestPool_PaddedLayout(){}
+
+        testdoc_t get_title() override
+        {
+            return "Pool: Padded Layout";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Ensure that each object in a padded pool is on its own cache line.";
+        }
+
+        bool run() override
+        {
+            Pool<uint64_t, true> pool(size);
+            pool_ref<uint64_t, true> refs[size];
+            PL_ASSERT_EQUAL(pool.create_n(size, refs), size);
+            PL_ASSERT_EQUAL(pool.size(), static_cast<uint32_t>(CACHE_LINE_SIZE * size));
+
+            for(uint32_t i = 0; i < size; ++i)
+            {
+                uintptr_t addr = reinterpret_cast<uintptr_t>(&pool.access(refs[i]));
+                PL_ASSERT_EQUAL(addr % CACHE_LINE_SIZE, 0u);
+            }
+
+            // The default layout packs small objects together.
+            PL_ASSERT_EQUAL(Pool<uint64_t>(size).size(), static_cast<uint32_t>(sizeof(uint64_t) * size));
+            return true;
+        }
+
+        ~TestPool_PaddedLayout(){}
+
+    private:
+        static const uint32_t size = 8;
+};
+
+// P-tB161A, P-tB161A*
+template<bool padded>
+class TestPool_LayoutIterate : public Test
+{
+    public:
+        TestPool_LayoutIterate()
+        :pool(nullptr), refs(nullptr)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return padded ? "Pool: Iterate (Padded Layout)" : "Pool: Iterate (Packed Layout)";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Sum every object in a full " + stdutils::itos(iters) + "-object pool with for_each_live().";
+        }
+
+        bool pre() override
+        {
+            pool = new Pool<uint64_t, padded>(iters);
+            refs = new pool_ref<uint64_t, padded>[iters];
+            return (pool->create_n(iters, refs, 1) == iters);
+        }
+
+        bool run() override
+        {
+            uint64_t sum = 0;
+            pool->for_each_live([&sum](uint64_t& obj)
+            {
+                sum += obj;
+            });
+            return (sum == iters);
+        }
+
+        bool post() override
+        {
+            delete[] refs;
+            refs = nullptr;
+            delete pool;
+            pool = nullptr;
+            return true;
+        }
+
+        ~TestPool_LayoutIterate(){}
+
+    private:
+        static const uint32_t iters = 10000;
+
+        Pool<uint64_t, padded>* pool;
+        pool_ref<uint64_t, padded>* refs;
+};
+
+// P-tB161B, P-tB161B*
+template<bool padded>
+class TestPool_LayoutThreaded : public Test
+{
+    public:
+        TestPool_LayoutThreaded()
+        :pool(nullptr)
+        {}
+
+        testdoc_t get_title() override
+        {
+            return padded ? "Pool: Threaded Update (Padded Layout)" : "Pool: Threaded Update (Packed Layout)";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Have each of " + stdutils::itos(threads) + " threads update its own object in the same pool " + stdutils::itos(iters) + " times.";
+        }
+
+        bool pre() override
+        {
+            pool = new Pool<uint64_t, padded>(threads);
+            return (pool->create_n(threads, refs, 0) == threads);
+        }
+
+        bool run() override
+        {
+            std::thread workers[threads];
+            for(uint32_t t = 0; t < threads; ++t)
+            {
+                // Each thread only ever touches its own object.
+                volatile uint64_t* obj = &(pool->access(refs[t]));
+                workers[t] = std::thread([obj]()
+                {
+                    for(uint32_t i = 0; i < iters; ++i)
+                    {
+                        *obj = *obj + 1;
+                    }
+                });
+            }
+            for(uint32_t t = 0; t < threads; ++t)
+            {
+                workers[t].join();
+            }
+            return true;
+        }
+
+        bool post() override
+        {
+            for(uint32_t t = 0; t < threads; ++t)
+            {
+                refs[t] = pool_ref<uint64_t, padded>();
+            }
+            delete pool;
+            pool = nullptr;
+            return true;
+        }
+
+        ~TestPool_LayoutThreaded(){}
+
+    private:
+        static const uint32_t threads = 4;
+        static const uint32_t iters = 100000;
+
+        Pool<uint64_t, padded>* pool;
+        pool_ref<uint64_t, padded> refs[threads];
+};
+
+// P-tB161C
+class TestPool_CompactStrings : public Test
+{
+    public:
+        TestPool_CompactStrings(){}
+
+        testdoc_t get_title() override
+        {
+            return "Pool: Compact and Shrink (Non-Trivial Objects)";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Compact and shrink a sparse pool of heap-allocated strings, and ensure each object is moved intact and destroyed exactly once.";
+        }
+
+        bool run() override
+        {
+            Pool<std::string> pool(size);
+            pool_ref<std::string> refs[size];
+            for(uint32_t i = 0; i < size; ++i)
+            {
+                refs[i] = pool.create(value(i));
+            }
+            // Leave only every third object live.
+            for(uint32_t i = 0; i < size; ++i)
+            {
+                if(i % 3 != 2)
+                {
+                    pool.destroy(refs[i]);
+                }
+            }
+
+            PL_ASSERT_GREATER(pool.compact(), 0u);
+            for(uint32_t i = 2; i < size; i += 3)
+            {
+                PL_ASSERT_EQUAL(pool.access(refs[i]), value(i));
+            }
+
+            PL_ASSERT_EQUAL(pool.shrink(), size / 3);
+            for(uint32_t i = 2; i < size; i += 3)
+            {
+                PL_ASSERT_EQUAL(pool.access(refs[i]), value(i));
+            }
+
+            // Space freed after shrinking can be reused.
+            pool.destroy(refs[2]);
+            refs[0] = pool.create(value(size));
+            PL_ASSERT_EQUAL(pool.access(refs[0]), value(size));
+            // The remaining live objects are destroyed with the pool.
+            return true;
+        }
+
+        ~TestPool_CompactStrings(){}
+
+    private:
+        static const uint32_t size = 30;
+
+        /* Each string is too long to be stored inline, so a double
+         * destruction or a leak shows up under a memory checker. */
+        static std::string value(uint32_t i)
+        {
+            return "A string that won't fit in the inline buffer #" + stdutils::itos(i);
+        }
+};
+
+// P-tB161D
+class TestPool_AllocatorThreaded : public Test
+{
+    public:
+        TestPool_AllocatorThreaded(){}
+
+        testdoc_t get_title() override
+        {
+            return "Pool: pool_allocator on Multiple Threads";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Churn a separate std::list using pool_allocator on each of " + stdutils::itos(threads) + " threads at once, and ensure every list keeps its own values.";
+        }
+
+        bool run() override
+        {
+            std::thread workers[threads];
+            bool intact[threads];
+            for(uint32_t t = 0; t < threads; ++t)
+            {
+                bool* result = &(intact[t]);
+                workers[t] = std::thread([t, result]()
+                {
+                    // Every list draws from the same shared pool.
+                    std::list<uint32_t, pool_allocator<uint32_t>> list;
+                    for(uint32_t i = 0; i < iters; ++i)
+                    {
+                        list.push_back(t);
+                        list.push_back(t);
+                        list.pop_front();
+                    }
+                    *result = (list.size() == iters);
+                    for(uint32_t value : list)
+                    {
+                        if(value != t)
+                        {
+                            *result = false;
+                        }
+                    }
+                });
+            }
+            for(uint32_t t = 0; t < threads; ++t)
+            {
+                workers[t].join();
+            }
+            for(uint32_t t = 0; t < threads; ++t)
+            {
+                PL_ASSERT_TRUE(intact[t]);
+            }
+            return true;
+        }
+
+        ~TestPool_AllocatorThreaded(){}
+
+    private:
+        static const uint32_t threads = 4;
+        static const uint32_t iters = 20000;
+};
+
+// P-tB161E
+class TestPool_AllocatorOverAligned : public Test
+{
+    protected:
+        struct alignas(128) wide_t
+        {
+            uint32_t value;
+        };
+
+    public:
+        TestPool_AllocatorOverAligned(){}
+
+        testdoc_t get_title() override
+        {
+            return "Pool: pool_allocator with Over-Aligned Type";
+        }
+
+        testdoc_t get_docs() override
+        {
+            return "Fill a std::list using pool_allocator with a type aligned to 128 bytes, and ensure every element is aligned.";
+        }
+
+        bool run() override
+        {
+            std::list<wide_t, pool_allocator<wide_t>> list;
+            for(uint32_t i = 0; i < 64; ++i)
+            {
+                list.push_back(wide_t{i});
+            }
+            uint32_t i = 0;
+            for(const wide_t& item : list)
+            {
+                PL_ASSERT_EQUAL(reinterpret_cast<uintptr_t>(&item) % alignof(wide_t), 0u);
+                PL_ASSERT_EQUAL(item.value, i++);
+            }
+
+            // Array storage takes the same path.
+            pool_allocator<wide_t> alloc;
+            wide_t* array = alloc.allocate(3);
+            PL_ASSERT_EQUAL(reinterpret_cast<uintptr_t>(array) % alignof(wide_t), 0u);
+            alloc.deallocate(array, 3);
+            return true;
+        }
+
+        ~TestPool_AllocatorOverAligned(){}
+};
+
 class TestSuite_Pool : public TestSuite
 {
     public:
@@ -53,8 +53,9 @@
 #include <limits>
 #include <stdexcept>
 #include <vector>
-// Needed for stdsplit
+// Needed for stdsplit and stdtokenize
 #include <string>
+#include <string_view>
 
 /* NOTE: Due to bug 19439, if we're using GCC, this only works on g++ 5.3 or higher.
  * https://sourceware.org/bugzilla/show_bug.cgi?id=19439
@@ -79,6 +80,57 @@ class stdutils
         */
         static void stdsplit(std::string, std::string, std::vector<std::string>&);
 
+        /** Split a std::string by tokens, in one pass, without allocating.
+        * Each token is passed to the callback as a view into the string.
+        * \param the string to split
+        * \param the string to split by, or the characters to split on
+        * \param the callback, which is called with a std::string_view
+        * \param whether to split on any one character of the delimiter
+        * \return the number of tokens
+        */
+        template <typename F>
+        static size_t stdtokenize(std::string_view str, std::string_view delim,
+                                  F&& each, bool any_of = false)
+        {
+            // An empty delimiter never matches, so the string is one token.
+            bool marked[256] = {false};
+            for (char ch : delim)
+            {
+                marked[static_cast<unsigned char>(ch)] = true;
+            }
+
+            size_t count = 0;
+            size_t start = 0;
+            while (true)
+            {
+                size_t end = std::string_view::npos;
+                if (any_of)
+                {
+                    for (size_t i = start; i < str.size(); ++i)
+                    {
+                        if (marked[static_cast<unsigned char>(str[i])])
+                        {
+                            end = i;
+                            break;
+                        }
+                    }
+                }
+                else if (!delim.empty())
+                {
+                    end = str.find(delim, start);
+                }
+
+                ++count;
+                if (end == std::string_view::npos)
+                {
+                    each(str.substr(start));
+                    return count;
+                }
+                each(str.substr(start, end - start));
+                start = end + (any_of ? 1 : delim.size());
+            }
+        }
+
         /** Reverse a C-string. Algorithm from
         * http://stackoverflow.com/a/784567/472647
         * \param the C-string to reverse.
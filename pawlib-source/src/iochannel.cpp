@@ -189,6 +189,23 @@ iochannel& iochannel::operator<<(const onestring& rhs)
     return *this;
 }
 
+iochannel& iochannel::operator<<(const onestring_view& rhs)
+{
+    //If we cannot parse because of `shutup()` settings, abort.
+    if(!can_parse()){return *this;}
+
+    //If we just applied attributes, push them now.
+    if(apply_attributes())
+    {
+        inject(format.c_str());
+    }
+
+    /* A view isn't null-terminated, so append its bytes directly,
+     * rather than copying it to a c-string first. */
+    msg.append(rhs.data(), rhs.size());
+    return *this;
+}
+
 iochannel& iochannel::operator<<(const std::exception& rhs)
 {
     //If we cannot parse because of `shutup()` settings, abort.
@@ -409,6 +426,7 @@ template iochannel& iochannel::resolve_pointer<long double>(const long double*);
 template iochannel& iochannel::resolve_pointer<std::string>(const std::string*);
 template iochannel& iochannel::resolve_pointer<onechar>(const onechar*);
 template iochannel& iochannel::resolve_pointer<onestring>(const onestring*);
+template iochannel& iochannel::resolve_pointer<onestring_view>(const onestring_view*);
 
 template <typename T>
 iochannel& iochannel::resolve_integer(const T& rhs)
@@ -50,4 +50,7 @@ void TestSuite_Onechar::load_tests()
     register_test("P-tB4111b", new TestOnechar_OpGreaterEqual(TestOnechar::TestCharType::CSTR));
     register_test("P-tB4111c", new TestOnechar_OpGreaterEqual(TestOnechar::TestCharType::STRING));
     register_test("P-tB4111d", new TestOnechar_OpGreaterEqual(TestOnechar::TestCharType::ONECHAR));
+
+    register_test("P-tB4112", new TestOnechar_Packed());
+    register_test("P-tB4113", new TestOnechar_Sort(), true, new TestStdString_SortChars());
 }
@@ -1,60 +1,77 @@
 #include "pawlib/onestring.hpp"
 
+#include <memory> // std::unique_ptr
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__) || defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
 /*******************************************
 * Constructors + Destructor
 *******************************************/
 onestring::onestring()
-:_capacity(BASE_SIZE), _elements(0), internal(nullptr), _c_str(0)
+:_bytes(_local), _size(0), _capacity(BASE_SIZE), _elements(0), _index(nullptr),
+ _index_capacity(0), _indexed(0), _cursor_pos(0), _cursor_off(0), _hash(0),
+ _resource(nullptr)
 {
-    allocate(this->_capacity);
-    //assign('\0');
+    // Short strings need no allocation at all.
+    _local[0] = '\0';
 }
 
 onestring::onestring(char ch)
-:_capacity(BASE_SIZE), _elements(0), internal(nullptr), _c_str(0)
+:onestring()
 {
-    allocate(this->_capacity);
     assign(ch);
 }
 
 onestring::onestring(const onechar& ochr)
-:_capacity(BASE_SIZE), _elements(0), internal(nullptr), _c_str(0)
+:onestring()
 {
-    allocate(this->_capacity);
     assign(ochr);
 }
 
 onestring::onestring(const char* cstr)
-:_capacity(BASE_SIZE), _elements(0), internal(nullptr), _c_str(0)
+:onestring()
 {
-    allocate(this->_capacity);
     assign(cstr);
 }
 
 onestring::onestring(const std::string& str)
-:_capacity(BASE_SIZE), _elements(0), internal(nullptr), _c_str(0)
+:onestring()
 {
-    allocate(this->_capacity);
     append(str);
 }
 
 onestring::onestring(const onestring& ostr)
-:_capacity(BASE_SIZE), _elements(0), internal(nullptr), _c_str(0)
+:onestring()
 {
-    allocate(this->_capacity);
     assign(ostr);
 }
 
+onestring::onestring(const onestring_view& view)
+:onestring()
+{
+    assign(view);
+}
+
+onestring::onestring(std::pmr::memory_resource* resource)
+:onestring()
+{
+    this->_resource = resource;
+}
+
 onestring::~onestring()
 {
-    if (_c_str != nullptr)
+    if (!is_local())
     {
-        delete[] _c_str;
+        release(this->_bytes, this->_capacity + 1);
     }
-
-    if (internal != nullptr)
+    if (this->_index != nullptr)
     {
-        delete[] internal;
+        release(this->_index, this->_index_capacity);
     }
 }
 
@@ -64,37 +81,544 @@ onestring::~onestring()
 
 void onestring::allocate(size_t capacity)
 {
-    this->_capacity = capacity;
+    char* newArr = this->_local;
+    size_t oldCapacity = this->_capacity;
+
+    // If it fits, use the inline storage.
+    if (capacity <= BASE_SIZE)
+    {
+        // If we're already inline, there's nothing to do.
+        if (is_local()) { return; }
+        this->_capacity = BASE_SIZE;
+    }
+    else
+    {
+        this->_capacity = capacity;
+        // Allocate a new array with the new size, plus the null terminator.
+        newArr = obtain<char>(this->_capacity + 1);
+    }
+
+    // Move the old contents over.
+    memcpy(newArr, this->_bytes, this->_size);
+    newArr[this->_size] = '\0';
+
+    // Release the old array, if it wasn't inline.
+    if (!is_local())
+    {
+        release(this->_bytes, oldCapacity + 1);
+    }
+
+    // Store the new structure.
+    this->_bytes = newArr;
+}
+
+void onestring::take_copy(onestring& ostr)
+{
+    assign(static_cast<const onestring&>(ostr));
+    ostr.clear();
+}
+
+size_t onestring::offset_of(size_t pos) const
+{
+    // In an ASCII-only string, every character is a single byte.
+    if (this->_size == this->_elements) { return pos; }
+    if (pos == this->_elements) { return this->_size; }
+
+    size_t entry = pos / INDEX_STRIDE;
+    size_t from = entry * INDEX_STRIDE;
+    size_t off = 0;
+
+    // If the last character we located is on the way, start from there.
+    if (_cursor_pos <= pos && _cursor_pos >= from)
+    {
+        from = _cursor_pos;
+        off = _cursor_off;
+    }
+    // Otherwise, start from the nearest index entry (0 is always at 0).
+    else if (entry > 0)
+    {
+        if (entry >= _indexed) { build_index(entry); }
+        off = _index[entry];
+    }
+
+    // Walk the rest of the way, one character at a time.
+    while (from < pos)
+    {
+        off += onechar::evaluateLength(this->_bytes + off);
+        ++from;
+    }
+
+    _cursor_pos = pos;
+    _cursor_off = off;
+    return off;
+}
+
+unsigned int onestring::select_bit(uint32_t mask, unsigned int k)
+{
+#ifdef __BMI2__
+    return __builtin_ctz(_pdep_u32(1u << k, mask));
+#else
+    /* Narrow it down to the byte, then the half, pair, and single bit,
+     * using the counts of set bits in each, without branching. */
+    uint32_t pairs = mask - ((mask >> 1) & 0x55555555);
+    uint32_t nibbles = (pairs & 0x33333333) + ((pairs >> 2) & 0x33333333);
+    uint32_t bytes = (nibbles + (nibbles >> 4)) & 0x0F0F0F0F;
+    // The running total of set bits, up to and including each byte.
+    uint32_t totals = bytes * 0x01010101;
+    // Mark the bytes whose total is more than k; the first holds the bit.
+    uint32_t past = ((totals | 0x80808080) - (k + 1) * 0x01010101) & 0x80808080;
+    unsigned int at = __builtin_ctz(past) - 7;
+    k -= ((totals << 8) >> at) & 0xFF;
+
+    uint32_t count = (nibbles >> at) & 0x0F;
+    unsigned int step = (k >= count) ? 4 : 0;
+    k -= (step != 0) ? count : 0;
+    at += step;
+
+    count = (pairs >> at) & 0x03;
+    step = (k >= count) ? 2 : 0;
+    k -= (step != 0) ? count : 0;
+    at += step;
+
+    return at + ((k >= ((mask >> at) & 1)) ? 1 : 0);
+#endif
+}
+
+void onestring::build_index(size_t entry) const
+{
+    // Make room for the new entries, if needed.
+    if (entry >= _index_capacity)
+    {
+        size_t newCapacity = (_index_capacity > 0) ? _index_capacity : 8;
+        while (newCapacity <= entry) { newCapacity *= 2; }
 
-    // If we're allocating down, throw away the excess elements.
-    if (this->_elements > this->_capacity)
+        size_t* newIndex = obtain<size_t>(newCapacity);
+        if (_index != nullptr)
+        {
+            memcpy(newIndex, _index, sizeof(size_t) * _indexed);
+            release(_index, _index_capacity);
+        }
+        _index = newIndex;
+        _index_capacity = newCapacity;
+    }
+
+    // The first character is always at the start.
+    if (_indexed == 0)
     {
-        this->_elements = this->_capacity;
+        _index[0] = 0;
+        _indexed = 1;
     }
 
-    // Allocate a new array with the new size.
-    onechar* newArr = new onechar[this->_capacity];
+    /* Count forward from the last valid entry to find the new ones. Work
+     * on copies of the members, which the stores to the index could
+     * otherwise alias. */
+    const char* bytes = this->_bytes;
+    const size_t size = this->_size;
+    size_t* index = _index;
+    size_t indexed = _indexed;
+    size_t off = index[indexed - 1];
+
+#ifdef __SSE2__
+    /* Count the bytes that start a character, 32 at a time. There are
+     * INDEX_STRIDE (at least 32) characters between entries, so no block
+     * can hold more than one entry. */
+    const __m128i limit = _mm_set1_epi8(-65);
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = off + 1;
+    // The entry is at the remaining-th character to start after off.
+    size_t remaining = INDEX_STRIDE;
+    for (; indexed <= entry && i + 32 <= size; i += 32)
+    {
+        __m128i lo = _mm_cmpgt_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i)), limit);
+        __m128i hi = _mm_cmpgt_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i + 16)), limit);
+        // Each lead is -1 in both halves; negate and sum them.
+        __m128i sums = _mm_sad_epu8(_mm_sub_epi8(zero, _mm_add_epi8(lo, hi)), zero);
+        size_t leads = _mm_cvtsi128_si32(sums) + _mm_extract_epi16(sums, 4);
+        if (leads < remaining)
+        {
+            remaining -= leads;
+            continue;
+        }
 
-    // If an old array exists...
-    if(this->internal != nullptr)
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(lo)) |
+                        (static_cast<uint32_t>(_mm_movemask_epi8(hi)) << 16);
+        off = i + select_bit(mask, remaining - 1);
+        index[indexed++] = off;
+        // Count the leads after the entry towards the next one.
+        remaining = INDEX_STRIDE - (leads - remaining);
+    }
+    /* Finish in what remains, one byte at a time. The block loop can stop
+     * in the middle of a character, so count the leads from i itself. */
+    if (indexed <= entry)
     {
-        for (size_t i = 0; i < this->_elements; ++i)
+        for (off = i; off < size; ++off)
         {
-            newArr[i] = std::move(this->internal[i]);
+            if ((bytes[off] & 0xC0) != 0x80 && --remaining == 0) { break; }
         }
+        index[indexed++] = off;
+    }
+#endif
 
-        // Delete the old structure
-        delete[] internal;
-        this->internal = nullptr;
+    while (indexed <= entry)
+    {
+        off += advance(bytes + off, size - off, INDEX_STRIDE);
+        index[indexed++] = off;
     }
+    _indexed = indexed;
+}
 
-    // Store the new structure.
-    this->internal = newArr;
+void onestring::invalidate_index(size_t pos)
+{
+    // Entries for characters up to and including pos are unaffected.
+    size_t keep = pos / INDEX_STRIDE + 1;
+    if (_indexed > keep) { _indexed = keep; }
+
+    // The cursor is always valid at the start of the string.
+    _cursor_pos = 0;
+    _cursor_off = 0;
+}
+
+void onestring::shift_index(size_t pos, size_t len, size_t start, size_t n, size_t was)
+{
+    for (size_t entry = pos / INDEX_STRIDE + 1; entry < _indexed; ++entry)
+    {
+        size_t at = entry * INDEX_STRIDE;
+        // An entry among the new characters must be found again.
+        if (at < pos + len)
+        {
+            _index[entry] = start + advance(this->_bytes + start, n, at - pos);
+        }
+        // Every entry after them moves by the change in size.
+        else
+        {
+            _index[entry] = _index[entry] + n - was;
+        }
+    }
+
+    // The cursor is always valid at the start of the string.
+    _cursor_pos = 0;
+    _cursor_off = 0;
+}
+
+void onestring::splice(size_t pos, size_t len, const char* bytes, size_t n, size_t chars)
+{
+    // WARNING: pos and len are not validated. That MUST be done externally!
+
+    // If the new text is part of this string, work from a copy of it.
+    if (n > 0 && bytes >= this->_bytes && bytes <= this->_bytes + this->_capacity)
+    {
+        // Get the copy from the same resource, and give it back even if
+        // the splice throws.
+        auto give_back = [this, n](char* ptr) { release(ptr, n); };
+        std::unique_ptr<char, decltype(give_back)> copy(obtain<char>(n), give_back);
+        memcpy(copy.get(), bytes, n);
+        splice(pos, len, copy.get(), n, chars);
+        return;
+    }
+
+    size_t start = offset_of(pos);
+    size_t end = offset_of(pos + len);
+    size_t newSize = this->_size - (end - start) + n;
+
+    // Reserve the needed space
+    reserve(newSize);
+
+    // Move the right partition (and the terminator) into place.
+    if (end - start != n)
+    {
+        memmove(this->_bytes + start + n, this->_bytes + end, this->_size - end + 1);
+    }
+
+    // Write the new text into the gap.
+    if (n > 0)
+    {
+        memcpy(this->_bytes + start, bytes, n);
+    }
+
+    /* If the number of characters changed, the index after pos is stale.
+     * If only their size did, the later entries just move. */
+    if (len != chars)
+    {
+        invalidate_index(pos);
+    }
+    else if (end - start != n)
+    {
+        shift_index(pos, len, start, n, end - start);
+    }
+
+    this->_size = newSize;
+    this->_elements = this->_elements - len + chars;
+    this->_hash = 0;
+}
+
+size_t onestring::sequence_length(const char* bytes, size_t n)
+{
+    /* The length of the sequence started by each possible first byte, or 0
+     * if the byte can't start one. 0xC0 and 0xC1 could only start overlong
+     * forms, and 0xF5 and up would be past U+10FFFF. */
+    static const unsigned char lengths[256] = {
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x00
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x10
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x20
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x30
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x40
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x50
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x60
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x70
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x80
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x90
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xA0
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xB0
+        0, 0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, // 0xC0
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, // 0xD0
+        3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, // 0xE0
+        4, 4, 4, 4, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0  // 0xF0
+    };
+
+    const unsigned char* seq = reinterpret_cast<const unsigned char*>(bytes);
+    size_t len = lengths[seq[0]];
+    if (len <= 1) { return len; }
+    if (len > n) { return 0; }
+
+    /* The second byte's range depends on the first, to rule out overlong
+     * forms (0xE0, 0xF0), surrogates (0xED), and values past U+10FFFF (0xF4). */
+    unsigned char low = 0x80;
+    unsigned char high = 0xBF;
+    switch (seq[0])
+    {
+        case 0xE0: { low = 0xA0; break; }
+        case 0xED: { high = 0x9F; break; }
+        case 0xF0: { low = 0x90; break; }
+        case 0xF4: { high = 0x8F; break; }
+        default: { break; }
+    }
+    if (seq[1] < low || seq[1] > high) { return 0; }
+
+    // Any remaining bytes are ordinary continuation bytes.
+    for (size_t i = 2; i < len; ++i)
+    {
+        if ((seq[i] & 0xC0) != 0x80) { return 0; }
+    }
+    return len;
+}
+
+size_t onestring::scan(const char* bytes, size_t n, size_t& chars)
+{
+    size_t invalid = npos;
+    size_t i = 0;
+    chars = 0;
+
+    while (i < n)
+    {
+        // ASCII text can be skipped in blocks: no byte has the high bit set.
+        if (static_cast<unsigned char>(bytes[i]) < 0x80)
+        {
+            size_t from = i;
+#ifdef __AVX2__
+            while (i + 32 <= n && _mm256_movemask_epi8(_mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(bytes + i))) == 0)
+            {
+                i += 32;
+            }
+#endif
+#ifdef __SSE2__
+            while (i + 16 <= n && _mm_movemask_epi8(_mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(bytes + i))) == 0)
+            {
+                i += 16;
+            }
+#endif
+            // Finish off any ASCII left over.
+            while (i < n && static_cast<unsigned char>(bytes[i]) < 0x80)
+            {
+                ++i;
+            }
+            chars += i - from;
+            continue;
+        }
+
+        size_t len = sequence_length(bytes + i, n - i);
+        if (len == 0)
+        {
+            // Count the invalid byte as one character, and move on.
+            if (invalid == npos) { invalid = i; }
+            len = 1;
+        }
+        i += len;
+        ++chars;
+    }
+    return invalid;
+}
+
+size_t onestring::validated(const char*& bytes, size_t& n, std::string& repaired)
+{
+    size_t chars;
+    size_t invalid = scan(bytes, n, chars);
+    if (invalid == npos) { return chars; }
+
+    // Copy the valid part, then replace each invalid byte from there on.
+    repaired.reserve(n + 8);
+    repaired.append(bytes, invalid);
+    size_t i = invalid;
+    while (i < n)
+    {
+        size_t len = sequence_length(bytes + i, n - i);
+        if (len == 0)
+        {
+            repaired.append("\xEF\xBF\xBD");
+            ++i;
+        }
+        else
+        {
+            repaired.append(bytes + i, len);
+            i += len;
+        }
+    }
+
+    bytes = repaired.data();
+    n = repaired.size();
+    return chars;
+}
+
+void onestring::splice_text(size_t pos, size_t len, const char* bytes, size_t n)
+{
+    std::string repaired;
+    size_t chars = validated(bytes, n, repaired);
+    splice(pos, len, bytes, n, chars);
+}
+
+void onestring::append_pieces(const piece* parts, size_t count)
+{
+    size_t n = 0;
+    size_t chars = 0;
+    bool aliased = false;
+    for (size_t i = 0; i < count; ++i)
+    {
+        n += parts[i].n;
+        chars += parts[i].chars;
+        aliased = aliased || (parts[i].n > 0 && parts[i].bytes >= this->_bytes &&
+                              parts[i].bytes <= this->_bytes + this->_capacity);
+    }
+
+    // If some of the text is part of this string, work on a copy of it.
+    if (aliased)
+    {
+        onestring copy(this->_resource);
+        copy.assign(*this);
+        copy.append_pieces(parts, count);
+        steal(copy);
+        return;
+    }
+
+    /* An empty string gets exactly the space it needs. Otherwise, grow as
+     * usual, so that repeated appends stay amortized. */
+    if (this->_size == 0 && n > this->_capacity)
+    {
+        allocate(n);
+    }
+    else
+    {
+        expand(n);
+    }
+
+    // Appending never disturbs the index, which only covers earlier text.
+    char* out = this->_bytes + this->_size;
+    for (size_t i = 0; i < count; ++i)
+    {
+        memcpy(out, parts[i].bytes, parts[i].n);
+        out += parts[i].n;
+    }
+    *out = '\0';
+
+    this->_size += n;
+    this->_elements += chars;
+    this->_hash = 0;
+}
+
+void onestring::format_pieces(const char* fmt, size_t n, const piece* values, size_t count)
+{
+    // The format string is text like any other, so repair it if needed.
+    std::string repaired;
+    size_t chars = validated(fmt, n, repaired);
+
+    // Measure the result. Each field and escaped brace is two characters.
+    size_t size = 0;
+    size_t field = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (fmt[i] == '{' && i + 1 < n && fmt[i + 1] == '}' && field < count)
+        {
+            size += values[field].n;
+            chars += values[field].chars;
+            chars -= 2;
+            ++field;
+            ++i;
+        }
+        else
+        {
+            if ((fmt[i] == '{' || fmt[i] == '}') && i + 1 < n && fmt[i + 1] == fmt[i])
+            {
+                --chars;
+                ++i;
+            }
+            ++size;
+        }
+    }
+
+    if (size > this->_capacity)
+    {
+        allocate(size);
+    }
+
+    // Then write it, copying the text between fields a run at a time.
+    char* out = this->_bytes;
+    field = 0;
+    size_t run = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        bool is_field = (fmt[i] == '{' && i + 1 < n && fmt[i + 1] == '}' && field < count);
+        bool is_brace = (!is_field && (fmt[i] == '{' || fmt[i] == '}') &&
+                         i + 1 < n && fmt[i + 1] == fmt[i]);
+        if (!is_field && !is_brace) { continue; }
+
+        // Everything up to here, and the first of two braces.
+        size_t end = is_brace ? i + 1 : i;
+        memcpy(out, fmt + run, end - run);
+        out += end - run;
+        if (is_field)
+        {
+            memcpy(out, values[field].bytes, values[field].n);
+            out += values[field].n;
+            ++field;
+        }
+        ++i;
+        run = i + 1;
+    }
+    memcpy(out, fmt + run, n - run);
+    out += n - run;
+    *out = '\0';
+
+    this->_size = size;
+    this->_elements = chars;
+    this->_hash = 0;
+}
+
+size_t onestring::characterCount(const char* cstr)
+{
+    size_t chars;
+    scan(cstr, strlen(cstr), chars);
+    return chars;
+}
+
+size_t onestring::validate(const char* bytes, size_t n)
+{
+    size_t chars;
+    return scan(bytes, n, chars);
 }
 
 void onestring::expand(size_t expansion)
 {
-    reserve(this->_elements + expansion);
+    reserve(this->_size + expansion);
 }
 
 void onestring::reserve(size_t elements)
@@ -103,119 +627,102 @@ void onestring::reserve(size_t elements)
     if (this->_capacity >= elements) { return; }
 
     // A capacity of 0 will trigger a complete reallocation
-    if (this->_capacity == 0)
-    {
-        this->_capacity = BASE_SIZE;
-    }
+    size_t capacity = (this->_capacity == 0) ? BASE_SIZE : this->_capacity;
 
     // If we're about to blow past indexing, manually set the capacity.
     if (elements >= RESIZE_LIMIT)
     {
-        this->_capacity = npos;
+        capacity = elements;
     }
 
     // Expand until we have enough space.
-    // cppcheck-suppress knownConditionTrueFalse
-    while (this->_capacity < elements)
+    while (capacity < elements)
     {
-        this->_capacity *= RESIZE_FACTOR;
+        capacity *= RESIZE_FACTOR;
     }
 
-    allocate(this->_capacity);
+    allocate(capacity);
 }
 
 void onestring::resize(size_t elements)
 {
-    // Don't reallocate if we already have the exact size needed.
-    if (this->_capacity == elements) { return; }
+    // Throw away any characters past the new length.
+    if (elements < this->_elements)
+    {
+        size_t end = offset_of(elements);
+        this->_bytes[end] = '\0';
+        this->_size = end;
+        this->_elements = elements;
+        this->_hash = 0;
+        invalidate_index(elements);
+    }
 
     // Reallocate to EXACTLY the needed size.
-    allocate(elements);
+    size_t capacity = (elements > this->_size) ? elements : this->_size;
+    if (this->_capacity != capacity)
+    {
+        allocate(capacity);
+    }
 }
 
 void onestring::resize(size_t elements, const onechar& ch)
 {
-    int to_add = elements - this->_elements;
-    std::cout << to_add << std::endl;
+    size_t to_add = (elements > this->_elements) ? elements - this->_elements : 0;
     resize(elements);
 
     if (to_add > 0)
     {
         append(ch, to_add);
+        shrink_to_fit();
     }
 }
 
-void onestring::shift(size_t fromIndex, int offset)
+void onestring::shrink_to_fit()
 {
-    // WARNING: We do NOT handle expansion in this function; only shifting.
-
-    // If we're shifting forward...
-    if (offset > 0)
-    {
-        // Work from last element being moved to first
-        size_t target = _elements;
-        // Copy each element forward to its new position.
-        while (target-- > fromIndex)
-        {
-            this->internal[target + offset] = this->internal[target];
-        }
-    }
-    // Otherwise, if we're shifting backward...
-    else if (offset < 0)
+    // We simply need to reallocate for the EXACT number of bytes we have
+    if (this->_capacity != this->_size)
     {
-        // Work from first element being moved to last
-        size_t target = fromIndex;
-        // Copy each element back to its new position.
-        while (target < _elements)
-        {
-            this->internal[target + offset] = this->internal[target];
-            ++target;
-        }
+        allocate(this->_size);
     }
 }
 
-void onestring::shrink_to_fit()
-{
-    // We simply need to reallocate for the EXACT number of elements we have
-    allocate(this->_elements);
-}
-
 /*******************************************
 * Accessors
 *******************************************/
 
-onechar& onestring::at(size_t pos)
+onestring::reference onestring::at(size_t pos)
 {
-    if (pos > _elements)
+    if (pos >= _elements)
     {
         throw std::out_of_range("Onestring::at(): Index out of bounds.");
     }
 
-    return internal[pos];
+    return reference(this, pos);
 }
 
-const onechar& onestring::at(size_t pos) const
+onechar onestring::at(size_t pos) const
 {
-    if (pos > _elements)
+    if (pos >= _elements)
     {
         throw std::out_of_range("Onestring::at(): Index out of bounds.");
     }
 
-    return internal[pos];
+    onechar ochr;
+    ochr.parseFromString(this->_bytes, offset_of(pos));
+    return ochr;
 }
 
-onechar& onestring::back()
+onestring::reference onestring::back()
 {
-    // WARNING: If string is empty, this is undefined (but memory safe)
+    // WARNING: If string is empty, this is undefined
     // Return a reference to the last element in the string.
-    return this->internal[_elements - 1];
+    return reference(this, _elements - 1);
 }
 
-const onechar& onestring::back() const
+onechar onestring::back() const
 {
-    // WARNING: If string is empty, this is undefined (but memory safe)
-    // Return a reference to the last element in the string.
-    return this->internal[_elements - 1];
+    // WARNING: If string is empty, this is undefined
+    return at(_elements - 1);
 }
 
 size_t onestring::capacity() const
@@ -235,53 +742,31 @@ size_t onestring::copy(char* arr, size_t max, size_t len, size_t pos) const
     // Remove one char from the max to account for the null terminator.
     --max;
 
-    // The indices for the c-string and (this) onestring.
-    size_t cstr_i = 0;
-    size_t ostr_i = pos;
-
     // Account for unspecified len, or adjust so it doesn't blow past the end.
     if (len == 0 || len + pos > this->_elements)
     {
         len = this->_elements - pos;
     }
 
-    while (cstr_i < max && ostr_i < (pos + len))
-    {
-        memcpy(arr + cstr_i, this->internal[ostr_i].internal, this->internal[ostr_i].size);
-        cstr_i += this->internal[ostr_i].size;
-        ++ostr_i;
-    }
-
-    arr[cstr_i] = '\0';
-
-    return cstr_i;
-}
-
-const char* onestring::c_str() const
-{
-    // If we have a c-string instance cached, deallocate it.
-    if (this->_c_str != nullptr)
-    {
-        delete[] this->_c_str;
-    }
-
-    // Allocate a new c-string.
-    size_t n = size();
-    this->_c_str = new char[n];
+    size_t start = offset_of(pos);
+    size_t end = offset_of(pos + len);
 
-    // Convert and store each onechar's value in the c-string
-    char* dest = this->_c_str;
-    for(size_t i = 0; i < _elements; ++i)
+    // If it won't all fit, only copy the whole characters that do.
+    if (end - start > max)
     {
-        memcpy(dest, internal[i].internal, internal[i].size);
-        dest += internal[i].size;
+        end = start;
+        size_t next = end + onechar::evaluateLength(this->_bytes + end);
+        while (next - start <= max)
+        {
+            end = next;
+            next += onechar::evaluateLength(this->_bytes + next);
+        }
     }
 
-    // Append the null terminator to the end of the c-string
-    this->_c_str[n-1] = '\0';
+    memcpy(arr, this->_bytes + start, end - start);
+    arr[end - start] = '\0';
 
-    // Return the pointer to the new cached c-string
-    return this->_c_str;
+    return end - start;
 }
 
 bool onestring::empty() const
@@ -289,18 +774,17 @@ bool onestring::empty() const
     return (_elements == 0);
 }
 
-onechar& onestring::front()
+onestring::reference onestring::front()
 {
-    // WARNING: If string is empty, this is undefined (but memory safe)
+    // WARNING: If string is empty, this is undefined
     // Return a reference to the first element in the string.
-    return this->internal[0];
+    return reference(this, 0);
 }
 
-const onechar& onestring::front() const
+onechar onestring::front() const
 {
-    // WARNING: If string is empty, this is undefined (but memory safe)
-    // Return a reference to the last element in the string.
-    return this->internal[0];
+    // WARNING: If string is empty, this is undefined
+    return at(0);
 }
 
 size_t onestring::length() const
@@ -315,31 +799,22 @@ onestring onestring::substr(size_t pos, size_t len) const
         throw std::out_of_range("Onestring::substr(): specified pos out of range");
     }
 
-    onestring r;
     // Calculate size of substr (number of elements)
     size_t elements_to_copy = (len > _elements - pos) ? (_elements - pos) : len;
-    // Reserve necessary space in the new onestring
-    r.reserve(elements_to_copy);
-    // Copy the characters for the substring
-    for (size_t i = 0; i < elements_to_copy; ++i)
-    {
-        r.internal[i] = this->internal[pos + i];
-    }
-    // Record how many elements were copied.
-    r._elements = elements_to_copy;
+
+    // Find the bytes of the substring
+    size_t start = offset_of(pos);
+    size_t end = offset_of(pos + elements_to_copy);
+
+    onestring r;
+    r.splice(0, 0, this->_bytes + start, end - start, elements_to_copy);
     return r;
 }
 
 size_t onestring::size() const
 {
-    // Start counting at 1 to account for the null terminator.
-    size_t bytes = 1;
-    // Sum all of the byte lengths of the onechars.
-    for(size_t i = 0; i < _elements; ++i)
-    {
-        bytes += this->internal[i].size;
-    }
-    return bytes;
+    // Add 1 to account for the null terminator.
+    return this->_size + 1;
 }
 
 size_t onestring::size(size_t len, size_t pos) const
@@ -352,15 +827,10 @@ size_t onestring::size(size_t len, size_t pos) const
         throw std::out_of_range("Onestring::size(): specified pos out of range");
     }
 
-    // Start counting at 1 to account for the null terminator.
-    size_t bytes = 1;
+    size_t end = (len > _elements - pos) ? _elements : pos + len;
 
-    // Sum all of the byte lengths of the onechars in the range
-    for(size_t i = pos; i < (pos + len) && i < _elements; ++i)
-    {
-        bytes += this->internal[i].size;
-    }
-    return bytes;
+    // Add 1 to account for the null terminator.
+    return offset_of(end) - offset_of(pos) + 1;
 }
 
 /*******************************************
@@ -369,22 +839,17 @@ size_t onestring::size(size_t len, size_t pos) const
 
 int onestring::compare(const char ch) const
 {
-    int sizeDiff = this->_elements - 1;
-    if (sizeDiff == 0)
-    {
-        return this->internal[0].compare(ch);
-    }
-    return sizeDiff;
+    return compare(onechar(ch));
 }
 
 int onestring::compare(const onechar& ochr) const
 {
-    int sizeDiff = this->_elements - 1;
-    if (sizeDiff == 0)
+    // See compare(const onestring&)
+    if (this->_elements != 1)
     {
-        return this->internal[0].compare(ochr);
+        return (this->_elements < 1) ? -1 : 1;
     }
-    return sizeDiff;
+    return onechar(this->_bytes).compare(ochr);
 }
 
 int onestring::compare(const char* cstr) const
@@ -392,22 +857,17 @@ int onestring::compare(const char* cstr) const
     /* This algorithm will not return a meaningful integer; only its
         * relation to 0 will be useful */
 
-    int sizeDiff = this->_elements - characterCount(cstr);
-
-    if (sizeDiff == 0)
+    size_t len = strlen(cstr);
+    size_t chars = count_leads(cstr, len);
+    if (this->_elements != chars)
     {
-        size_t j = 0;
-        // If the strings are the same length, compare each character...
-        for(size_t i = 0; i < this->_elements; ++i)
-        {
-            // Return the compare result of the first character mismatch
-            int r = this->internal[i].compare(cstr+j);
-            if ( r != 0) { return r; }
-
-            j += onechar::evaluateLength(cstr+j);
-        }
+        return (this->_elements < chars) ? -1 : 1;
     }
-    return sizeDiff;
+
+    /* If the strings are the same length, the first differing byte
+     * belongs to the first differing character, and UTF-8 orders
+     * the same bytewise as it does by code point. */
+    return memcmp(this->_bytes, cstr, (len < this->_size) ? len : this->_size);
 }
 
 int onestring::compare(const std::string& str) const
@@ -415,195 +875,1045 @@ int onestring::compare(const std::string& str) const
     return compare(str.c_str());
 }
 
-int onestring::compare(const onestring& ostr) const
+int onestring::compare(const onestring_view& view) const
 {
-    /* This algorithm will not return a meaningful integer; only its
-        * relation to 0 will be useful */
-
-    int sizeDiff = this->_elements - ostr._elements;
-    if (sizeDiff == 0)
-    {
-        // If the strings are the same length, compare each character...
-        for(size_t i = 0; i < this->_elements; ++i)
-        {
-            // Return the compare result of the first character mismatch
-            int r = this->internal[i].compare(ostr.internal[i]);
-            if ( r != 0) { return r; }
-        }
-    }
-    return sizeDiff;
+    return onestring_view(*this).compare(view);
 }
 
 bool onestring::equals(const char ch) const
 {
-    return (this->_elements == 1 && this->internal[0] == ch);
+    return (this->_size == 1 && this->_bytes[0] == ch);
 }
 
 bool onestring::equals(const onechar& ochr) const
 {
-    return (this->_elements == 1 && this->internal[0] == ochr);
+    return (this->_size == ochr.size() &&
+            memcmp(this->_bytes, ochr.internal, ochr.size()) == 0);
 }
 
 bool onestring::equals(const char* cstr) const
 {
-    size_t index = 0;
-    size_t compare_to = 0;
-    if (this->_elements != characterCount(cstr)) { return false; }
-    while(cstr[index] != '\0')
-    {
-        if (!(this->internal[compare_to].equals_at(cstr + index))) { return false; }
-        index += onechar::evaluateLength(cstr + index);
-        if(compare_to++ > this->_elements) { return false; }
-    }
-
-    return true;
+    return (strlen(cstr) == this->_size &&
+            memcmp(this->_bytes, cstr, this->_size) == 0);
 }
 
 bool onestring::equals(const std::string& str) const
 {
-    return equals(str.c_str());
+    return (str.size() == this->_size &&
+            memcmp(this->_bytes, str.data(), this->_size) == 0);
 }
 
-bool onestring::equals(const onestring& ostr) const
+bool onestring::equals(const onestring_view& view) const
 {
-    if (this->_elements != ostr._elements) { return false; }
-
-    for (size_t index = 0; index < this->_elements; ++index)
-    {
-        if (this->internal[index] != ostr.internal[index]) { return false; }
-    }
-    return true;
+    return (view.size() == this->_size &&
+            memcmp(this->_bytes, view.data(), this->_size) == 0);
 }
 
-/*******************************************
-* Mutators
-********************************************/
-
-onestring& onestring::append(const char ch, size_t repeat)
+int onestring::icompare(const char ch) const
 {
-    expand(repeat);
+    return icompare(onechar(ch));
+}
 
-    for(size_t a = 0; a < repeat; ++a)
+int onestring::icompare(const onechar& ochr) const
+{
+    // See compare(const onestring&)
+    if (this->_elements != 1)
     {
-        // Insert a 1-byte ASCII char
-        internal[_elements++] = ch;
+        return (this->_elements < 1) ? -1 : 1;
     }
-    return *this;
+    return fold_compare(this->_bytes, this->_size, ochr.internal, ochr.size());
 }
 
-onestring& onestring::append(const onechar& ochr, size_t repeat)
+int onestring::icompare(const char* cstr) const
 {
-    expand(repeat);
-
-    for(size_t a = 0; a < repeat; ++a)
+    size_t len = strlen(cstr);
+    size_t chars = count_leads(cstr, len);
+    if (this->_elements != chars)
     {
-        internal[_elements++] = ochr;
+        return (this->_elements < chars) ? -1 : 1;
     }
-    return *this;
+    return fold_compare(this->_bytes, this->_size, cstr, len);
 }
 
-onestring& onestring::append(const char* cstr, size_t repeat)
+int onestring::icompare(const std::string& str) const
 {
-    size_t len = characterCount(cstr);
-    expand(len * repeat);
-
-    for(size_t a = 0; a < repeat; ++a)
+    size_t chars = count_leads(str.data(), str.size());
+    if (this->_elements != chars)
     {
-        size_t index = 0;
-        // Loop through each character in the string literal
-        while(cstr[index] != '\0')
-        {
-            index += internal[_elements++].parseFromString(cstr, index);
-        }
+        return (this->_elements < chars) ? -1 : 1;
     }
-    return *this;
+    return fold_compare(this->_bytes, this->_size, str.data(), str.size());
 }
 
-onestring& onestring::append(const std::string& str, size_t repeat)
+int onestring::icompare(const onestring& ostr) const
 {
-    // Parse the internal c string directly.
-    append(str.c_str(), repeat);
-    return *this;
+    return onestring_view(*this).icompare(ostr);
 }
 
-onestring& onestring::append(const onestring& ostr, size_t repeat)
+int onestring::icompare(const onestring_view& view) const
 {
-    expand(ostr._elements * repeat);
+    return onestring_view(*this).icompare(view);
+}
 
-    for(size_t a = 0; a < repeat; ++a)
+bool onestring::iequals(const char ch) const
+{
+    return iequals(onechar(ch));
+}
+
+bool onestring::iequals(const onechar& ochr) const
+{
+    // Folding never changes the length of a character.
+    return (this->_size == ochr.size() &&
+            fold_compare(this->_bytes, this->_size, ochr.internal, ochr.size()) == 0);
+}
+
+bool onestring::iequals(const char* cstr) const
+{
+    size_t len = strlen(cstr);
+    return (len == this->_size && fold_compare(this->_bytes, this->_size, cstr, len) == 0);
+}
+
+bool onestring::iequals(const std::string& str) const
+{
+    return (str.size() == this->_size &&
+            fold_compare(this->_bytes, this->_size, str.data(), str.size()) == 0);
+}
+
+bool onestring::iequals(const onestring& ostr) const
+{
+    return (ostr._size == this->_size &&
+            fold_compare(this->_bytes, this->_size, ostr._bytes, ostr._size) == 0);
+}
+
+bool onestring::iequals(const onestring_view& view) const
+{
+    return onestring_view(*this).iequals(view);
+}
+
+/*******************************************
+* Search
+********************************************/
+
+size_t onestring::index_of(size_t offset) const
+{
+    // In an ASCII-only string, every character is a single byte.
+    if (this->_size == this->_elements) { return offset; }
+
+    // Start from the last character we located, if it's on the way.
+    size_t pos = 0;
+    size_t off = 0;
+    if (_cursor_off <= offset)
+    {
+        pos = _cursor_pos;
+        off = _cursor_off;
+    }
+
+    pos += count_leads(this->_bytes + off, offset - off);
+
+    _cursor_pos = pos;
+    _cursor_off = offset;
+    return pos;
+}
+
+size_t onestring::count_leads(const char* bytes, size_t n)
+{
+    size_t count = 0;
+    size_t i = 0;
+
+#ifdef __SSE2__
+    /* Every byte other than the first of a character is 10xxxxxx, which
+     * as a signed char is less than -64 (0xC0). Count the rest, 16 at once. */
+    const __m128i limit = _mm_set1_epi8(-65);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sums = zero;
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+        // Each lead is -1; negate and sum them.
+        __m128i leads = _mm_sub_epi8(zero, _mm_cmpgt_epi8(block, limit));
+        sums = _mm_add_epi64(sums, _mm_sad_epu8(leads, zero));
+    }
+    count = _mm_cvtsi128_si32(sums) + _mm_cvtsi128_si32(_mm_unpackhi_epi64(sums, sums));
+#endif
+
+    for (; i < n; ++i)
+    {
+        if ((bytes[i] & 0xC0) != 0x80) { ++count; }
+    }
+    return count;
+}
+
+size_t onestring::hash_bytes(const char* bytes, size_t n, size_t seed)
+{
+    const uint64_t PRIME_1 = 0x9E3779B185EBCA87ULL;
+    const uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+    const uint64_t PRIME_3 = 0x165667B19E3779F9ULL;
+
+    // Derive a key for each lane from the seed.
+    const uint64_t key[4] = {
+        seed ^ PRIME_1, seed + PRIME_2, seed ^ PRIME_3, seed - PRIME_1
+    };
+
+    uint64_t h;
+    if (n <= 16)
+    {
+        // Short text is read as two (possibly overlapping) words.
+        uint64_t lo = 0;
+        uint64_t hi = 0;
+        if (n >= 8)
+        {
+            memcpy(&lo, bytes, 8);
+            memcpy(&hi, bytes + n - 8, 8);
+        }
+        else if (n >= 4)
+        {
+            uint32_t a;
+            uint32_t b;
+            memcpy(&a, bytes, 4);
+            memcpy(&b, bytes + n - 4, 4);
+            lo = a;
+            hi = b;
+        }
+        else if (n > 0)
+        {
+            lo = static_cast<unsigned char>(bytes[0]) |
+                 (static_cast<unsigned char>(bytes[n / 2]) << 8) |
+                 (static_cast<unsigned char>(bytes[n - 1]) << 16);
+        }
+        h = fold(lo ^ key[0], hi ^ key[1]);
+    }
+    else
+    {
+        uint64_t acc[4] = {key[2], key[3], key[0], key[1]};
+
+        /* Each lane adds the product of the low and high halves of its
+         * keyed word, plus the unkeyed word from its neighbouring lane. */
+#ifdef __SSE2__
+        /* Build the vectors from registers, rather than loading them from
+         * the arrays, which would stall waiting on the scalar stores. */
+        __m128i lanes[2] = {
+            _mm_set_epi64x(acc[1], acc[0]), _mm_set_epi64x(acc[3], acc[2])
+        };
+        const __m128i keys[2] = {
+            _mm_set_epi64x(key[1], key[0]), _mm_set_epi64x(key[3], key[2])
+        };
+        auto mix = [&lanes, &keys](__m128i data, int half)
+        {
+            __m128i keyed = _mm_xor_si128(data, keys[half]);
+            __m128i product = _mm_mul_epu32(keyed, _mm_srli_epi64(keyed, 32));
+            __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+            lanes[half] = _mm_add_epi64(lanes[half], _mm_add_epi64(product, swapped));
+        };
+#endif
+
+        size_t i = 0;
+#ifdef __SSE2__
+        for (; i + 32 <= n; i += 32)
+        {
+            for (int half = 0; half < 2; ++half)
+            {
+                mix(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i + 16 * half)), half);
+            }
+        }
+
+        if (i < n)
+        {
+            /* Build the last partial stripe in registers, padded with
+             * zeroes. Copying it to a buffer first would stall the loads.
+             * A partial word is read as the last eight bytes of the text,
+             * shifted down; the text is always longer than eight bytes. */
+            const size_t left = n - i;
+            auto word = [bytes, n, i, left](size_t off) -> uint64_t
+            {
+                uint64_t w = 0;
+                if (off + 8 <= left)
+                {
+                    memcpy(&w, bytes + i + off, 8);
+                }
+                else if (off < left)
+                {
+                    memcpy(&w, bytes + n - 8, 8);
+                    w >>= (off + 8 - left) * 8;
+                }
+                return w;
+            };
+            const uint64_t words[4] = {word(0), word(8), word(16), word(24)};
+            for (int half = 0; half < 2; ++half)
+            {
+                mix(_mm_set_epi64x(words[2 * half + 1], words[2 * half]), half);
+            }
+        }
+#else
+        char last[32];
+        while (i < n)
+        {
+            const char* stripe = bytes + i;
+            // Pad the last partial stripe with zeroes.
+            if (n - i < 32)
+            {
+                memset(last, 0, 32);
+                memcpy(last, bytes + i, n - i);
+                stripe = last;
+            }
+            uint64_t data[4];
+            memcpy(data, stripe, 32);
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                uint64_t keyed = data[lane] ^ key[lane];
+                acc[lane] += (keyed & 0xFFFFFFFF) * (keyed >> 32) + data[lane ^ 1];
+            }
+            i += 32;
+        }
+#endif
+
+#if defined(__SSE2__) && defined(__x86_64__)
+        acc[0] = _mm_cvtsi128_si64(lanes[0]);
+        acc[1] = _mm_cvtsi128_si64(_mm_unpackhi_epi64(lanes[0], lanes[0]));
+        acc[2] = _mm_cvtsi128_si64(lanes[1]);
+        acc[3] = _mm_cvtsi128_si64(_mm_unpackhi_epi64(lanes[1], lanes[1]));
+#elif defined(__SSE2__)
+        // A 32-bit build can't move a 64-bit lane to a register directly.
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc), lanes[0]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + 2), lanes[1]);
+#endif
+
+        h = fold(acc[0] ^ key[2], acc[1] ^ key[3]) + fold(acc[2] ^ key[0], acc[3] ^ key[1]);
+    }
+
+    // Mix in the length, and spread every bit over the whole result.
+    h ^= n * PRIME_3;
+    h ^= h >> 37;
+    h *= PRIME_2;
+    h ^= h >> 32;
+    return static_cast<size_t>(h);
+}
+
+size_t onestring::advance(const char* bytes, size_t n, size_t pos)
+{
+    if (pos == 0) { return 0; }
+    size_t i = 0;
+
+#ifdef __SSE2__
+    // Skip whole blocks of 16 bytes while the character is beyond them.
+    const __m128i limit = _mm_set1_epi8(-65);
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+        uint32_t mask = _mm_movemask_epi8(_mm_cmpgt_epi8(block, limit));
+        size_t leads = __builtin_popcount(mask);
+        if (leads > pos)
+        {
+            // The character starts in this block.
+            return i + select_bit(mask, pos);
+        }
+        pos -= leads;
+    }
+#endif
+
+    // Find the character's first byte in what remains.
+    for (; i < n; ++i)
+    {
+        if ((bytes[i] & 0xC0) != 0x80)
+        {
+            if (pos == 0) { return i; }
+            --pos;
+        }
+    }
+    return n;
+}
+
+const char* onestring::search(const char* hay, size_t hay_n, const char* needle, size_t n)
+{
+    if (n > hay_n) { return nullptr; }
+    if (n == 1) { return static_cast<const char*>(memchr(hay, needle[0], hay_n)); }
+
+    // The last offset a match could start at.
+    size_t last = hay_n - n;
+    size_t i = 0;
+
+#ifdef __SSE2__
+    /* Test 16 possible starting offsets at once, keeping only those where
+     * both the first and last bytes of the needle match. Only those few
+     * need to be compared in full. */
+    const __m128i first_byte = _mm_set1_epi8(needle[0]);
+    const __m128i last_byte = _mm_set1_epi8(needle[n - 1]);
+    for (; i + 16 <= last + 1; i += 16)
+    {
+        __m128i firsts = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hay + i));
+        __m128i lasts = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hay + i + n - 1));
+        unsigned int mask = _mm_movemask_epi8(_mm_and_si128(
+            _mm_cmpeq_epi8(firsts, first_byte), _mm_cmpeq_epi8(lasts, last_byte)));
+
+        while (mask != 0)
+        {
+            size_t at = i + __builtin_ctz(mask);
+            if (memcmp(hay + at + 1, needle + 1, n - 2) == 0) { return hay + at; }
+            // Clear the lowest set bit.
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    // Check any remaining offsets one at a time.
+    for (; i <= last; ++i)
+    {
+        if (hay[i] == needle[0] && hay[i + n - 1] == needle[n - 1] &&
+            memcmp(hay + i + 1, needle + 1, n - 2) == 0)
+        {
+            return hay + i;
+        }
+    }
+    return nullptr;
+}
+
+const char* onestring::rsearch(const char* hay, size_t hay_n, const char* needle, size_t n)
+{
+    if (n > hay_n) { return nullptr; }
+
+    // One past the last offset a match could start at.
+    size_t i = hay_n - n + 1;
+
+#ifdef __SSE2__
+    // See search(), but working backwards from the end.
+    const __m128i first_byte = _mm_set1_epi8(needle[0]);
+    const __m128i last_byte = _mm_set1_epi8(needle[n - 1]);
+    while (i >= 16)
+    {
+        i -= 16;
+        __m128i firsts = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hay + i));
+        __m128i lasts = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hay + i + n - 1));
+        unsigned int mask = _mm_movemask_epi8(_mm_and_si128(
+            _mm_cmpeq_epi8(firsts, first_byte), _mm_cmpeq_epi8(lasts, last_byte)));
+
+        while (mask != 0)
+        {
+            unsigned int bit = 31 - __builtin_clz(mask);
+            size_t at = i + bit;
+            if (n <= 2 || memcmp(hay + at + 1, needle + 1, n - 2) == 0) { return hay + at; }
+            // Clear the highest set bit.
+            mask &= ~(1u << bit);
+        }
+    }
+#endif
+
+    // Check any remaining offsets one at a time.
+    while (i-- > 0)
+    {
+        if (hay[i] == needle[0] && hay[i + n - 1] == needle[n - 1] &&
+            (n <= 2 || memcmp(hay + i + 1, needle + 1, n - 2) == 0))
+        {
+            return hay + i;
+        }
+    }
+    return nullptr;
+}
+
+bool onestring::in_set(const char* set, size_t n, const char* ch, size_t len)
+{
+    size_t i = 0;
+    while (i < n)
+    {
+        size_t setLen = onechar::evaluateLength(set + i);
+        if (setLen == len && memcmp(set + i, ch, len) == 0) { return true; }
+        i += setLen;
+    }
+    return false;
+}
+
+size_t onestring::find_bytes(const char* needle, size_t n, size_t pos) const
+{
+    if (pos > this->_elements) { return npos; }
+
+    // An empty substring is found immediately.
+    if (n == 0) { return pos; }
+
+    size_t start = offset_of(pos);
+    const char* found = search(this->_bytes + start, this->_size - start, needle, n);
+    if (found == nullptr) { return npos; }
+
+    // offset_of() left the cursor at pos, so this only counts from there.
+    return index_of(found - this->_bytes);
+}
+
+size_t onestring::rfind_bytes(const char* needle, size_t n, size_t pos) const
+{
+    if (pos > this->_elements) { pos = this->_elements; }
+
+    // An empty substring is found immediately.
+    if (n == 0) { return pos; }
+
+    // Only search as far as a match starting at pos could reach.
+    size_t end = offset_of(pos) + n;
+    if (end > this->_size) { end = this->_size; }
+
+    const char* found = rsearch(this->_bytes, end, needle, n);
+    if (found == nullptr) { return npos; }
+    return index_of(found - this->_bytes);
+}
+
+size_t onestring::find_of(const char* set, size_t n, size_t pos, bool match) const
+{
+    if (pos >= this->_elements) { return npos; }
+
+    /* Mark every byte in the set. A character whose first byte is unmarked
+     * can't be in the set. For an ASCII-only set, a marked byte is enough. */
+    bool marked[256] = {false};
+    bool ascii = true;
+    for (size_t i = 0; i < n; ++i)
+    {
+        unsigned char byte = static_cast<unsigned char>(set[i]);
+        marked[byte] = true;
+        if (byte >= 0x80) { ascii = false; }
+    }
+
+    size_t off = offset_of(pos);
+    while (off < this->_size)
+    {
+        size_t len = onechar::evaluateLength(this->_bytes + off);
+        bool found = marked[static_cast<unsigned char>(this->_bytes[off])] &&
+                     (ascii || in_set(set, n, this->_bytes + off, len));
+        if (found == match)
+        {
+            _cursor_pos = pos;
+            _cursor_off = off;
+            return pos;
+        }
+        off += len;
+        ++pos;
+    }
+    return npos;
+}
+
+size_t onestring::rfind_of(const char* set, size_t n, size_t pos, bool match) const
+{
+    if (this->_elements == 0) { return npos; }
+    if (pos >= this->_elements) { pos = this->_elements - 1; }
+
+    // See find_of()
+    bool marked[256] = {false};
+    bool ascii = true;
+    for (size_t i = 0; i < n; ++i)
+    {
+        unsigned char byte = static_cast<unsigned char>(set[i]);
+        marked[byte] = true;
+        if (byte >= 0x80) { ascii = false; }
+    }
+
+    // Work backwards from the end of the character at pos.
+    size_t end = offset_of(pos + 1);
+    while (end > 0)
+    {
+        // Step back over the continuation bytes to the start of the character.
+        size_t off = end - 1;
+        while (off > 0 && (this->_bytes[off] & 0xC0) == 0x80) { --off; }
+
+        bool found = marked[static_cast<unsigned char>(this->_bytes[off])] &&
+                     (ascii || in_set(set, n, this->_bytes + off, end - off));
+        if (found == match) { return pos; }
+        end = off;
+        --pos;
+    }
+    return npos;
+}
+
+size_t onestring::count_bytes(const char* needle, size_t n) const
+{
+    if (n == 0) { return 0; }
+
+    size_t total = 0;
+    const char* hay = this->_bytes;
+    const char* hay_end = this->_bytes + this->_size;
+    const char* found;
+    while ((found = search(hay, hay_end - hay, needle, n)) != nullptr)
+    {
+        ++total;
+        // Continue after the match, so matches never overlap.
+        hay = found + n;
+    }
+    return total;
+}
+
+size_t onestring::find(const char ch, size_t pos) const
+{
+    piece needle(ch);
+    return find_bytes(needle.bytes, needle.n, pos);
+}
+
+size_t onestring::find(const onechar& ochr, size_t pos) const
+{
+    return find_bytes(ochr.internal, ochr.size(), pos);
+}
+
+size_t onestring::find(const char* cstr, size_t pos) const
+{
+    piece needle(cstr);
+    return find_bytes(needle.bytes, needle.n, pos);
+}
+
+size_t onestring::find(const std::string& str, size_t pos) const
+{
+    piece needle(str);
+    return find_bytes(needle.bytes, needle.n, pos);
+}
+
+size_t onestring::find(const onestring& ostr, size_t pos) const
+{
+    return find_bytes(ostr._bytes, ostr._size, pos);
+}
+
+size_t onestring::find(const onestring_view& view, size_t pos) const
+{
+    return find_bytes(view.data(), view.size(), pos);
+}
+
+size_t onestring::rfind(const char ch, size_t pos) const
+{
+    piece needle(ch);
+    return rfind_bytes(needle.bytes, needle.n, pos);
+}
+
+size_t onestring::rfind(const onechar& ochr, size_t pos) const
+{
+    return rfind_bytes(ochr.internal, ochr.size(), pos);
+}
+
+size_t onestring::rfind(const char* cstr, size_t pos) const
+{
+    piece needle(cstr);
+    return rfind_bytes(needle.bytes, needle.n, pos);
+}
+
+size_t onestring::rfind(const std::string& str, size_t pos) const
+{
+    piece needle(str);
+    return rfind_bytes(needle.bytes, needle.n, pos);
+}
+
+size_t onestring::rfind(const onestring& ostr, size_t pos) const
+{
+    return rfind_bytes(ostr._bytes, ostr._size, pos);
+}
+
+size_t onestring::rfind(const onestring_view& view, size_t pos) const
+{
+    return rfind_bytes(view.data(), view.size(), pos);
+}
+
+size_t onestring::find_first_of(const char ch, size_t pos) const
+{
+    piece needle(ch);
+    return find_of(needle.bytes, needle.n, pos, true);
+}
+
+size_t onestring::find_first_of(const onechar& ochr, size_t pos) const
+{
+    return find_of(ochr.internal, ochr.size(), pos, true);
+}
+
+size_t onestring::find_first_of(const char* cstr, size_t pos) const
+{
+    piece needle(cstr);
+    return find_of(needle.bytes, needle.n, pos, true);
+}
+
+size_t onestring::find_first_of(const std::string& str, size_t pos) const
+{
+    piece needle(str);
+    return find_of(needle.bytes, needle.n, pos, true);
+}
+
+size_t onestring::find_first_of(const onestring& ostr, size_t pos) const
+{
+    return find_of(ostr._bytes, ostr._size, pos, true);
+}
+
+size_t onestring::find_first_of(const onestring_view& view, size_t pos) const
+{
+    return find_of(view.data(), view.size(), pos, true);
+}
+
+size_t onestring::find_first_not_of(const char ch, size_t pos) const
+{
+    piece needle(ch);
+    return find_of(needle.bytes, needle.n, pos, false);
+}
+
+size_t onestring::find_first_not_of(const onechar& ochr, size_t pos) const
+{
+    return find_of(ochr.internal, ochr.size(), pos, false);
+}
+
+size_t onestring::find_first_not_of(const char* cstr, size_t pos) const
+{
+    piece needle(cstr);
+    return find_of(needle.bytes, needle.n, pos, false);
+}
+
+size_t onestring::find_first_not_of(const std::string& str, size_t pos) const
+{
+    piece needle(str);
+    return find_of(needle.bytes, needle.n, pos, false);
+}
+
+size_t onestring::find_first_not_of(const onestring& ostr, size_t pos) const
+{
+    return find_of(ostr._bytes, ostr._size, pos, false);
+}
+
+size_t onestring::find_first_not_of(const onestring_view& view, size_t pos) const
+{
+    return find_of(view.data(), view.size(), pos, false);
+}
+
+size_t onestring::find_last_of(const char ch, size_t pos) const
+{
+    piece needle(ch);
+    return rfind_of(needle.bytes, needle.n, pos, true);
+}
+
+size_t onestring::find_last_of(const onechar& ochr, size_t pos) const
+{
+    return rfind_of(ochr.internal, ochr.size(), pos, true);
+}
+
+size_t onestring::find_last_of(const char* cstr, size_t pos) const
+{
+    piece needle(cstr);
+    return rfind_of(needle.bytes, needle.n, pos, true);
+}
+
+size_t onestring::find_last_of(const std::string& str, size_t pos) const
+{
+    piece needle(str);
+    return rfind_of(needle.bytes, needle.n, pos, true);
+}
+
+size_t onestring::find_last_of(const onestring& ostr, size_t pos) const
+{
+    return rfind_of(ostr._bytes, ostr._size, pos, true);
+}
+
+size_t onestring::find_last_of(const onestring_view& view, size_t pos) const
+{
+    return rfind_of(view.data(), view.size(), pos, true);
+}
+
+size_t onestring::find_last_not_of(const char ch, size_t pos) const
+{
+    piece needle(ch);
+    return rfind_of(needle.bytes, needle.n, pos, false);
+}
+
+size_t onestring::find_last_not_of(const onechar& ochr, size_t pos) const
+{
+    return rfind_of(ochr.internal, ochr.size(), pos, false);
+}
+
+size_t onestring::find_last_not_of(const char* cstr, size_t pos) const
+{
+    piece needle(cstr);
+    return rfind_of(needle.bytes, needle.n, pos, false);
+}
+
+size_t onestring::find_last_not_of(const std::string& str, size_t pos) const
+{
+    piece needle(str);
+    return rfind_of(needle.bytes, needle.n, pos, false);
+}
+
+size_t onestring::find_last_not_of(const onestring& ostr, size_t pos) const
+{
+    return rfind_of(ostr._bytes, ostr._size, pos, false);
+}
+
+size_t onestring::find_last_not_of(const onestring_view& view, size_t pos) const
+{
+    return rfind_of(view.data(), view.size(), pos, false);
+}
+
+size_t onestring::count(const char ch) const
+{
+    piece needle(ch);
+    return count_bytes(needle.bytes, needle.n);
+}
+
+size_t onestring::count(const onechar& ochr) const
+{
+    return count_bytes(ochr.internal, ochr.size());
+}
+
+size_t onestring::count(const char* cstr) const
+{
+    piece needle(cstr);
+    return count_bytes(needle.bytes, needle.n);
+}
+
+size_t onestring::count(const std::string& str) const
+{
+    piece needle(str);
+    return count_bytes(needle.bytes, needle.n);
+}
+
+size_t onestring::count(const onestring& ostr) const
+{
+    return count_bytes(ostr._bytes, ostr._size);
+}
+
+size_t onestring::count(const onestring_view& view) const
+{
+    return count_bytes(view.data(), view.size());
+}
+
+bool onestring::contains(const char ch) const
+{
+    piece needle(ch);
+    return (find_bytes(needle.bytes, needle.n, 0) != npos);
+}
+
+bool onestring::contains(const onechar& ochr) const
+{
+    return (find_bytes(ochr.internal, ochr.size(), 0) != npos);
+}
+
+bool onestring::contains(const char* cstr) const
+{
+    piece needle(cstr);
+    return (find_bytes(needle.bytes, needle.n, 0) != npos);
+}
+
+bool onestring::contains(const std::string& str) const
+{
+    piece needle(str);
+    return (find_bytes(needle.bytes, needle.n, 0) != npos);
+}
+
+bool onestring::contains(const onestring& ostr) const
+{
+    return (find_bytes(ostr._bytes, ostr._size, 0) != npos);
+}
+
+bool onestring::contains(const onestring_view& view) const
+{
+    return (find_bytes(view.data(), view.size(), 0) != npos);
+}
+
+bool onestring::starts_with(const char ch) const
+{
+    return has_prefix(this->_bytes, this->_size, &ch, 1);
+}
+
+bool onestring::starts_with(const onechar& ochr) const
+{
+    return has_prefix(this->_bytes, this->_size, ochr.internal, ochr.size());
+}
+
+bool onestring::starts_with(const char* cstr) const
+{
+    return has_prefix(this->_bytes, this->_size, cstr, strlen(cstr));
+}
+
+bool onestring::starts_with(const std::string& str) const
+{
+    return has_prefix(this->_bytes, this->_size, str.data(), str.size());
+}
+
+bool onestring::starts_with(const onestring& ostr) const
+{
+    return has_prefix(this->_bytes, this->_size, ostr._bytes, ostr._size);
+}
+
+bool onestring::starts_with(const onestring_view& view) const
+{
+    return has_prefix(this->_bytes, this->_size, view.data(), view.size());
+}
+
+bool onestring::ends_with(const char ch) const
+{
+    return has_suffix(this->_bytes, this->_size, &ch, 1);
+}
+
+bool onestring::ends_with(const onechar& ochr) const
+{
+    return has_suffix(this->_bytes, this->_size, ochr.internal, ochr.size());
+}
+
+bool onestring::ends_with(const char* cstr) const
+{
+    return has_suffix(this->_bytes, this->_size, cstr, strlen(cstr));
+}
+
+bool onestring::ends_with(const std::string& str) const
+{
+    return has_suffix(this->_bytes, this->_size, str.data(), str.size());
+}
+
+bool onestring::ends_with(const onestring& ostr) const
+{
+    return has_suffix(this->_bytes, this->_size, ostr._bytes, ostr._size);
+}
+
+bool onestring::ends_with(const onestring_view& view) const
+{
+    return has_suffix(this->_bytes, this->_size, view.data(), view.size());
+}
+
+/*******************************************
+* Mutators
+********************************************/
+
+onestring& onestring::append(const char ch, size_t repeat)
+{
+    // A lone byte above 0x7F isn't valid UTF-8; it goes in as U+FFFD.
+    if (static_cast<unsigned char>(ch) >= 0x80)
     {
-        for(size_t i = 0; i < ostr._elements; ++i)
+        for(size_t a = 0; a < repeat; ++a)
         {
-            this->internal[_elements + i] = ostr.internal[i];
+            splice_text(this->_elements, 0, &ch, 1);
         }
+        return *this;
+    }
+
+    // Reserve the needed space
+    expand(repeat);
+
+    // Insert 1-byte ASCII chars
+    memset(this->_bytes + this->_size, ch, repeat);
+    this->_size += repeat;
+    this->_elements += repeat;
+    this->_bytes[this->_size] = '\0';
+    this->_hash = 0;
+    return *this;
+}
+
+onestring& onestring::append(const onechar& ochr, size_t repeat)
+{
+    // Reserve the needed space
+    expand(ochr.size() * repeat);
+
+    for(size_t a = 0; a < repeat; ++a)
+    {
+        memcpy(this->_bytes + this->_size, ochr.internal, ochr.size());
+        this->_size += ochr.size();
+    }
+    this->_elements += repeat;
+    this->_bytes[this->_size] = '\0';
+    this->_hash = 0;
+    return *this;
+}
+
+onestring& onestring::append(const char* cstr, size_t repeat)
+{
+    const char* bytes = cstr;
+    size_t len = strlen(cstr);
+    std::string repaired;
+    size_t count = validated(bytes, len, repaired);
+
+    for(size_t a = 0; a < repeat; ++a)
+    {
+        splice(this->_elements, 0, bytes, len, count);
+    }
+    return *this;
+}
+
+onestring& onestring::append(const std::string& str, size_t repeat)
+{
+    const char* bytes = str.data();
+    size_t len = str.size();
+    std::string repaired;
+    size_t count = validated(bytes, len, repaired);
 
-        _elements += ostr._elements;
+    for(size_t a = 0; a < repeat; ++a)
+    {
+        splice(this->_elements, 0, bytes, len, count);
     }
+    return *this;
+}
 
+onestring& onestring::append(const onestring& ostr, size_t repeat)
+{
+    // Appending a string to itself is handled by splice()
+    for(size_t a = 0; a < repeat; ++a)
+    {
+        splice(this->_elements, 0, ostr._bytes, ostr._size, ostr._elements);
+    }
+    return *this;
+}
+
+onestring& onestring::append(onestring&& ostr, size_t repeat)
+{
+    // If we have nothing of our own, just take the other string's contents.
+    if (this->_elements == 0 && repeat == 1 && this != &ostr)
+    {
+        steal(ostr);
+        return *this;
+    }
+    return append(ostr, repeat);
+}
+
+onestring& onestring::append(const onestring_view& view, size_t repeat)
+{
+    // A view is always valid, and may even be of this string.
+    for(size_t a = 0; a < repeat; ++a)
+    {
+        splice(this->_elements, 0, view.data(), view.size(), view.length());
+    }
     return *this;
 }
 
 onestring& onestring::assign(const char ch)
 {
     clear();
-    reserve(1);
-    this->internal[_elements++] = ch;
+    append(ch);
     return *this;
 }
 
 onestring& onestring::assign(const onechar& ochr)
 {
     clear();
-    reserve(1);
-    this->internal[_elements++] = ochr;
+    append(ochr);
     return *this;
 }
 
 onestring& onestring::assign(const char* cstr)
 {
     clear();
-
-    size_t len = characterCount(cstr);
-    reserve(len);
-
-    // Loop through each character in the string literal
-    size_t index = 0;
-    while(cstr[index] != '\0')
-    {
-        // Parse and store the character.
-        index += internal[_elements++].parseFromString(cstr, index);
-    }
+    append(cstr);
     return *this;
 }
 
 onestring& onestring::assign(const std::string& str)
 {
-    assign(str.c_str());
+    clear();
+    append(str);
     return *this;
 }
 
 onestring& onestring::assign(const onestring& ostr)
 {
-    clear();
-    reserve(ostr._elements);
-    for(size_t i = 0; i < ostr._elements; ++i)
+    // Assigning a string to itself should change nothing.
+    if (this != &ostr)
     {
-        this->internal[i] = ostr.internal[i];
+        clear();
+        append(ostr);
     }
-    _elements = ostr._elements;
+    return *this;
+}
+
+onestring& onestring::assign(const onestring_view& view)
+{
+    // If the view is of this string, splice() works from a copy.
+    splice(0, this->_elements, view.data(), view.size(), view.length());
     return *this;
 }
 
 void onestring::clear()
 {
-    if (_elements > 0)
-    {
-        delete[] this->internal;
-        internal = nullptr;
-        _capacity = 0;
-        reserve(BASE_SIZE);
-        _elements = 0;
-    }
+    // Keep the allocated space for reuse.
+    this->_size = 0;
+    this->_elements = 0;
+    this->_bytes[0] = '\0';
+    this->_hash = 0;
+    invalidate_index(0);
 }
 
 onestring& onestring::erase(size_t pos, size_t len)
@@ -616,28 +1926,16 @@ onestring& onestring::erase(size_t pos, size_t len)
     // Calculate the number of elements we need to REMOVE
     len = (len > _elements - pos) ? (_elements - pos) : len;
 
-    // If there are any elements remaining after the erasure...
-    if(_elements - pos - len > 0)
-    {
-        // Move the remaining elements back
-        shift(pos + len, -(len));
-    }
-
-    // Update the number of elements
-    _elements = _elements - len;
+    splice(pos, len, nullptr, 0, 0);
 
     return *this;
 }
-
-std::istream& onestring::getline(std::istream& is, onestring& ostr, char delim)
-{
-    ostr.clear();
-
-    char ch;
-    while (is.get(ch) && ch != delim)
-    {
-        ostr.append(ch);
-    }
+
+std::istream& onestring::getline(std::istream& is, onestring& ostr, char delim)
+{
+    std::string str;
+    std::getline(is, str, delim);
+    ostr.assign(str);
     return is;
 }
 
@@ -649,20 +1947,12 @@ onestring& onestring::insert(size_t pos, char ch)
         throw std::out_of_range("Onestring::insert(): specified pos out of range");
     }
 
-    // Reserve needed space
-    expand(1);
-    // Move the right partition to make room for the new element
-    shift(pos, 1);
-
-    // Insert the new element
-    this->internal[pos] = ch;
-    // Increase the element count
-    ++_elements;
+    splice_text(pos, 0, &ch, 1);
 
     return *this;
 }
 
-onestring& onestring::insert(size_t pos, onechar& ochr)
+onestring& onestring::insert(size_t pos, const onechar& ochr)
 {
     // Ensure the insertion position is in range.
     if (pos >= this->_elements)
@@ -670,20 +1960,12 @@ onestring& onestring::insert(size_t pos, onechar& ochr)
         throw std::out_of_range("Onestring::insert(): specified pos out of range");
     }
 
-    // Reserve needed space
-    expand(1);
-    // Move the right partition to make room for the new element
-    shift(pos, 1);
-
-    // Insert the new element
-    this->internal[pos] = ochr;
-    // Increase the element count
-    ++_elements;
+    splice(pos, 0, ochr.internal, ochr.size(), 1);
 
     return *this;
 }
 
-onestring& onestring::insert(size_t pos, char* cstr)
+onestring& onestring::insert(size_t pos, const char* cstr)
 {
     // Ensure the insertion position is in range.
     if (pos >= this->_elements)
@@ -691,28 +1973,23 @@ onestring& onestring::insert(size_t pos, char* cstr)
         throw std::out_of_range("Onestring::insert(): specified pos out of range");
     }
 
-    size_t elements_to_insert = characterCount(cstr);
-    // Reserve needed space
-    expand(elements_to_insert);
-    // Move the right partition to make room for the new element
-    shift(pos, elements_to_insert);
-
-    // Insert the new elements
-    size_t index = 0;
-    while(cstr[index] != '\0')
-    {
-        // Parse and store the character.
-        index += internal[pos++].parseFromString(cstr, index);
-    }
-    // Increase the element count
-    _elements += elements_to_insert;
+    size_t len = strlen(cstr);
+    splice_text(pos, 0, cstr, len);
 
     return *this;
 }
 
-onestring& onestring::insert(size_t pos, std::string& str)
+onestring& onestring::insert(size_t pos, const std::string& str)
 {
-    return insert(pos, str.c_str());
+    // Ensure the insertion position is in range.
+    if (pos >= this->_elements)
+    {
+        throw std::out_of_range("Onestring::insert(): specified pos out of range");
+    }
+
+    splice_text(pos, 0, str.data(), str.size());
+
+    return *this;
 }
 
 onestring& onestring::insert(size_t pos, const onestring& ostr)
@@ -723,19 +2000,20 @@ onestring& onestring::insert(size_t pos, const onestring& ostr)
         throw std::out_of_range("Onestring::insert(): specified pos out of range");
     }
 
-    size_t elements_to_insert = ostr._elements;
-    // Reserve needed space
-    expand(elements_to_insert);
-    // Move the right partition to make room for the new element
-    shift(pos, elements_to_insert);
+    splice(pos, 0, ostr._bytes, ostr._size, ostr._elements);
 
-    // Insert the new elements
-    for(size_t i = 0; i < ostr._elements; ++i)
+    return *this;
+}
+
+onestring& onestring::insert(size_t pos, const onestring_view& view)
+{
+    // Ensure the insertion position is in range.
+    if (pos >= this->_elements)
     {
-        this->internal[pos + i] = ostr.internal[i];
+        throw std::out_of_range("Onestring::insert(): specified pos out of range");
     }
-    // Increase the element count
-    _elements += elements_to_insert;
+
+    splice(pos, 0, view.data(), view.size(), view.length());
 
     return *this;
 }
@@ -746,50 +2024,15 @@ void onestring::pop_back()
     {
         /* We don't actually need to delete anything. The space will be
         * reused or deallocated as needed by other functions. */
+        size_t end = offset_of(_elements - 1);
         --_elements;
+        this->_size = end;
+        this->_bytes[end] = '\0';
+        this->_hash = 0;
+        invalidate_index(_elements);
     }
 }
 
-void onestring::replace_setup(size_t pos, size_t len, size_t sublen)
-{
-    // WARNING: pos and len are not validated. That MUST be done externally!
-
-    // Calculate whether we're replacing 1:1, expanding, or erasing
-    int difference = sublen - len;
-    size_t pos_after = pos + len;
-    size_t elements_after = _elements - pos_after;
-
-    // If our replacement expands the string...
-    if (difference > 0)
-    {
-        // Reserve the needed space
-        expand(difference);
-
-        // Move the right partition to make room, if necessary
-        if (elements_after > 0)
-        {
-            shift(pos, difference);
-        }
-
-        // Update the element count
-        _elements += difference;
-    }
-    // Otherwise, if our replacement shrinks the string...
-    else if (difference < 0)
-    {
-        // Move the right partition back, erasing excess characters.
-        if (elements_after > 0)
-        {
-            shift(pos_after, difference);
-        }
-
-        // Update the element count
-        _elements += difference;
-    }
-
-    // If the string size won't change, we need no extra setup.
-}
-
 onestring& onestring::replace(size_t pos, size_t len, const char ch)
 {
     // Ensure the replacement position is in range.
@@ -801,11 +2044,7 @@ onestring& onestring::replace(size_t pos, size_t len, const char ch)
     // Adjust len so it doesn't run past the end of the string
     len = (len > _elements - pos) ? (_elements - pos) : len;
 
-    // Rearrange the string memory to accommodate the new data
-    replace_setup(pos, len, 1);
-
-    // Write the data, using pos as our destination index.
-    this->internal[pos] = ch;
+    splice_text(pos, len, &ch, 1);
 
     return *this;
 }
@@ -821,11 +2060,7 @@ onestring& onestring::replace(size_t pos, size_t len, const onechar& ochr)
     // Adjust len so it doesn't run past the end of the string
     len = (len > _elements - pos) ? (_elements - pos) : len;
 
-    // Rearrange the string memory to accommodate the new data
-    replace_setup(pos, len, 1);
-
-    // Write the data, using pos as our destination index.
-    this->internal[pos] = ochr;
+    splice(pos, len, ochr.internal, ochr.size(), 1);
 
     return *this;
 }
@@ -841,23 +2076,26 @@ onestring& onestring::replace(size_t pos, size_t len, const char* cstr)
     // Adjust len so it doesn't run past the end of the string
     len = (len > _elements - pos) ? (_elements - pos) : len;
 
-    // Rearrange the string memory to accommodate the new data
-    replace_setup(pos, len, characterCount(cstr));
-
-    // Write the data, using pos as our destination index.
-    size_t index = 0;
-    while(cstr[index] != '\0')
-    {
-        // Parse and store the character.
-        index += internal[pos++].parseFromString(cstr, index);
-    }
+    size_t n = strlen(cstr);
+    splice_text(pos, len, cstr, n);
 
     return *this;
 }
 
 onestring& onestring::replace(size_t pos, size_t len, const std::string& str)
 {
-    return replace(pos, len, str.c_str());
+    // Ensure the replacement position is in range.
+    if (pos >= this->_elements)
+    {
+        throw std::out_of_range("Onestring::replace(): specified pos out of range");
+    }
+
+    // Adjust len so it doesn't run past the end of the string
+    len = (len > _elements - pos) ? (_elements - pos) : len;
+
+    splice_text(pos, len, str.data(), str.size());
+
+    return *this;
 }
 
 onestring& onestring::replace(size_t pos, size_t len, const onestring& ostr)
@@ -871,14 +2109,24 @@ onestring& onestring::replace(size_t pos, size_t len, const onestring& ostr)
     // Adjust len so it doesn't run past the end of the string
     len = (len > _elements - pos) ? (_elements - pos) : len;
 
-    // Rearrange the string memory to accommodate the new data
-    replace_setup(pos, len, ostr._elements);
+    splice(pos, len, ostr._bytes, ostr._size, ostr._elements);
+
+    return *this;
+}
 
-    for(size_t i = 0; i < ostr._elements; ++i)
+onestring& onestring::replace(size_t pos, size_t len, const onestring_view& view)
+{
+    // Ensure the replacement position is in range.
+    if (pos >= this->_elements)
     {
-        this->internal[pos + i] = ostr.internal[i];
+        throw std::out_of_range("Onestring::replace(): specified pos out of range");
     }
 
+    // Adjust len so it doesn't run past the end of the string
+    len = (len > _elements - pos) ? (_elements - pos) : len;
+
+    splice(pos, len, view.data(), view.size(), view.length());
+
     return *this;
 }
 
@@ -890,7 +2138,11 @@ onestring& onestring::replace(size_t pos, size_t len, const char* cstr, size_t s
         throw std::out_of_range("Onestring::replace(): specified pos out of range");
     }
 
-    size_t cstr_len = strlen(cstr);
+    // Work from valid UTF-8, so we can step through it safely.
+    const char* bytes = cstr;
+    size_t n = strlen(cstr);
+    std::string repaired;
+    size_t cstr_len = validated(bytes, n, repaired);
     if (subpos >= cstr_len)
     {
         throw std::out_of_range("Onestring::replace(): specified subpos out of range");
@@ -901,19 +2153,20 @@ onestring& onestring::replace(size_t pos, size_t len, const char* cstr, size_t s
     // Adjust sublen so it doesn't run past the end of the c-string.
     sublen = (sublen > cstr_len - subpos) ? (cstr_len - subpos) : sublen;
 
-    // Rearrange the string memory to accommodate the new data
-    replace_setup(pos, len, sublen);
-
-    // Repurpose sublen so it marks the end of the area we are to copy from
-    sublen += subpos;
-
-    // Replace the characters in the specified range, using pos and subpos as our indices.
-    while(subpos < sublen)
+    // Find the bytes of the characters to copy from.
+    size_t start = 0;
+    for (size_t i = 0; i < subpos; ++i)
+    {
+        start += onechar::evaluateLength(bytes + start);
+    }
+    size_t end = start;
+    for (size_t i = 0; i < sublen; ++i)
     {
-        // Parse and store the character.
-        subpos += internal[pos++].parseFromString(cstr, subpos);
+        end += onechar::evaluateLength(bytes + end);
     }
 
+    splice(pos, len, bytes + start, end - start, sublen);
+
     return *this;
 }
 
@@ -940,34 +2193,49 @@ onestring& onestring::replace(size_t pos, size_t len, const onestring& ostr, siz
     // Adjust sublen so it doesn't run past the end of the c-string.
     sublen = (sublen > ostr._elements - subpos) ? (ostr._elements - subpos) : sublen;
 
-    // Rearrange the string memory to accommodate the new data
-    replace_setup(pos, len, sublen);
-
-    for(size_t i = 0; i < sublen; ++i)
-    {
-        this->internal[pos + i] = ostr.internal[subpos + i];
-    }
+    size_t start = ostr.offset_of(subpos);
+    size_t end = ostr.offset_of(subpos + sublen);
+    splice(pos, len, ostr._bytes + start, end - start, sublen);
 
     return *this;
 }
 
 onestring& onestring::reverse()
 {
-    // Create temporary storage unit
-    onechar temp;
+    // Reverse all of the bytes...
+    std::reverse(this->_bytes, this->_bytes + this->_size);
 
-    // Perform the swap
-    size_t lhe = 0;
-    size_t rhe = _elements - 1;
-    while(lhe < rhe)
+    /* ...which leaves each multi-byte character backwards, with its
+     * continuation bytes before its lead byte. Put those back in order. */
+    size_t start = 0;
+    for (size_t i = 0; i < this->_size; ++i)
     {
-        temp = this->internal[rhe];
-        this->internal[rhe] = this->internal[lhe];
-        this->internal[lhe] = temp;
-        ++lhe;
-        --rhe;
+        // Continuation bytes are 10xxxxxx.
+        if ((this->_bytes[i] & 0xC0) != 0x80)
+        {
+            std::reverse(this->_bytes + start, this->_bytes + i + 1);
+            start = i + 1;
+        }
     }
 
+    this->_hash = 0;
+    invalidate_index(0);
+
+    return *this;
+}
+
+onestring& onestring::to_lower()
+{
+    // Every character keeps its length, so the index is still good.
+    map_case(this->_bytes, this->_size, this->_bytes, casing::lower);
+    this->_hash = 0;
+    return *this;
+}
+
+onestring& onestring::to_upper()
+{
+    map_case(this->_bytes, this->_size, this->_bytes, casing::upper);
+    this->_hash = 0;
     return *this;
 }
 
@@ -978,9 +2246,525 @@ void onestring::swap(std::string& str)
     this->assign(temp);
 }
 
-void onestring::swap(onestring& ostr)
+
+/*******************************************
+* Transcoding
+********************************************/
+
+char32_t onestring::decode(const char* bytes, size_t len)
 {
-    onestring temp = ostr;
-    ostr.assign(*this);
-    this->assign(temp);
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(bytes);
+    switch (len)
+    {
+        case 1: { return b[0]; }
+        case 2: { return ((b[0] & 0x1F) << 6) | (b[1] & 0x3F); }
+        case 3: { return ((b[0] & 0x0F) << 12) | ((b[1] & 0x3F) << 6) | (b[2] & 0x3F); }
+        default:
+        {
+            return ((b[0] & 0x07) << 18) | ((b[1] & 0x3F) << 12) |
+                   ((b[2] & 0x3F) << 6) | (b[3] & 0x3F);
+        }
+    }
+}
+
+size_t onestring::encode(char32_t cp, char* out)
+{
+    if (cp < 0x80)
+    {
+        out[0] = static_cast<char>(cp);
+        return 1;
+    }
+    if (cp < 0x800)
+    {
+        out[0] = static_cast<char>(0xC0 | (cp >> 6));
+        out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000)
+    {
+        out[0] = static_cast<char>(0xE0 | (cp >> 12));
+        out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = static_cast<char>(0xF0 | (cp >> 18));
+    out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+char32_t onestring::read_unit(const char16_t* units, size_t n, size_t& i)
+{
+    char32_t unit = units[i++];
+    if (unit < 0xD800 || unit > 0xDFFF) { return unit; }
+
+    // A high surrogate must be followed by a low one.
+    if (unit <= 0xDBFF && i < n && units[i] >= 0xDC00 && units[i] <= 0xDFFF)
+    {
+        char32_t low = units[i++];
+        return 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+    }
+    return 0xFFFD;
+}
+
+char32_t onestring::read_unit(const char32_t* units, size_t, size_t& i)
+{
+    char32_t unit = units[i++];
+    if ((unit >= 0xD800 && unit <= 0xDFFF) || unit > 0x10FFFF) { return 0xFFFD; }
+    return unit;
+}
+
+bool onestring::narrow_ascii(const char16_t* units, char* out)
+{
+#ifdef __SSE2__
+    __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(units));
+    __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(units + 8));
+    // Every unit is ASCII if no bits above the lowest seven are set.
+    __m128i high_bits = _mm_and_si128(_mm_or_si128(lo, hi), _mm_set1_epi16(-0x80));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(high_bits, _mm_setzero_si128())) != 0xFFFF)
+    {
+        return false;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(lo, hi));
+    return true;
+#else
+    char16_t any = 0;
+    for (size_t i = 0; i < 16; ++i) { any |= units[i]; }
+    if (any >= 0x80) { return false; }
+    for (size_t i = 0; i < 16; ++i) { out[i] = static_cast<char>(units[i]); }
+    return true;
+#endif
+}
+
+bool onestring::narrow_ascii(const char32_t* units, char* out)
+{
+#ifdef __SSE2__
+    const __m128i* in = reinterpret_cast<const __m128i*>(units);
+    __m128i a = _mm_loadu_si128(in);
+    __m128i b = _mm_loadu_si128(in + 1);
+    __m128i c = _mm_loadu_si128(in + 2);
+    __m128i d = _mm_loadu_si128(in + 3);
+    __m128i any = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+    __m128i high_bits = _mm_and_si128(any, _mm_set1_epi32(-0x80));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(high_bits, _mm_setzero_si128())) != 0xFFFF)
+    {
+        return false;
+    }
+    // All are below 0x80, so neither pack saturates.
+    __m128i ab = _mm_packs_epi32(a, b);
+    __m128i cd = _mm_packs_epi32(c, d);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(ab, cd));
+    return true;
+#else
+    char32_t any = 0;
+    for (size_t i = 0; i < 16; ++i) { any |= units[i]; }
+    if (any >= 0x80) { return false; }
+    for (size_t i = 0; i < 16; ++i) { out[i] = static_cast<char>(units[i]); }
+    return true;
+#endif
+}
+
+template<typename Unit>
+onestring onestring::from_units(const Unit* units, size_t n)
+{
+    // Measure the result first, so it can be allocated exactly once.
+    char scratch[16];
+    size_t size = 0;
+    size_t chars = 0;
+    size_t i = 0;
+    while (i < n)
+    {
+        if (i + 16 <= n && narrow_ascii(units + i, scratch))
+        {
+            i += 16;
+            size += 16;
+            chars += 16;
+            continue;
+        }
+        char32_t cp = read_unit(units, n, i);
+        size += (cp < 0x80) ? 1 : (cp < 0x800) ? 2 : (cp < 0x10000) ? 3 : 4;
+        ++chars;
+    }
+
+    onestring r;
+    r.allocate(size);
+
+    // Then write it, narrowing runs of ASCII 16 units at a time.
+    char* out = r._bytes;
+    i = 0;
+    while (i < n)
+    {
+        if (i + 16 <= n && narrow_ascii(units + i, out))
+        {
+            i += 16;
+            out += 16;
+            continue;
+        }
+        out += encode(read_unit(units, n, i), out);
+    }
+    *out = '\0';
+
+    r._size = size;
+    r._elements = chars;
+    return r;
+}
+
+onestring onestring::from_utf16(const char16_t* units, size_t n)
+{
+    return from_units(units, n);
+}
+
+onestring onestring::from_utf32(const char32_t* units, size_t n)
+{
+    return from_units(units, n);
+}
+
+size_t onestring::utf16_size() const
+{
+    // Only a 4-byte character needs two units (a surrogate pair).
+    size_t wide = 0;
+    size_t i = 0;
+
+#ifdef __SSE2__
+    // The lead byte of a 4-byte character is 11110xxx.
+    const __m128i mask = _mm_set1_epi8(static_cast<char>(0xF8));
+    const __m128i lead = _mm_set1_epi8(static_cast<char>(0xF0));
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sums = zero;
+    for (; i + 16 <= this->_size; i += 16)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(this->_bytes + i));
+        __m128i found = _mm_cmpeq_epi8(_mm_and_si128(block, mask), lead);
+        sums = _mm_add_epi64(sums, _mm_sad_epu8(_mm_sub_epi8(zero, found), zero));
+    }
+    wide = _mm_cvtsi128_si32(sums) + _mm_cvtsi128_si32(_mm_unpackhi_epi64(sums, sums));
+#endif
+
+    for (; i < this->_size; ++i)
+    {
+        if ((this->_bytes[i] & 0xF8) == 0xF0) { ++wide; }
+    }
+    return this->_elements + wide;
+}
+
+size_t onestring::to_utf16(char16_t* out) const
+{
+    char16_t* start = out;
+    size_t i = 0;
+    while (i < this->_size)
+    {
+#ifdef __SSE2__
+        // Widen runs of ASCII 16 bytes at a time.
+        const __m128i zero = _mm_setzero_si128();
+        while (i + 16 <= this->_size)
+        {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(this->_bytes + i));
+            if (_mm_movemask_epi8(block) != 0) { break; }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(block, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpackhi_epi8(block, zero));
+            i += 16;
+            out += 16;
+        }
+        if (i >= this->_size) { break; }
+#endif
+
+        size_t len = onechar::evaluateLength(this->_bytes + i);
+        char32_t cp = decode(this->_bytes + i, len);
+        i += len;
+        if (cp < 0x10000)
+        {
+            *(out++) = static_cast<char16_t>(cp);
+        }
+        else
+        {
+            cp -= 0x10000;
+            *(out++) = static_cast<char16_t>(0xD800 + (cp >> 10));
+            *(out++) = static_cast<char16_t>(0xDC00 + (cp & 0x3FF));
+        }
+    }
+    return out - start;
+}
+
+size_t onestring::to_utf32(char32_t* out) const
+{
+    char32_t* start = out;
+    size_t i = 0;
+    while (i < this->_size)
+    {
+#ifdef __SSE2__
+        // Widen runs of ASCII 16 bytes at a time.
+        const __m128i zero = _mm_setzero_si128();
+        while (i + 16 <= this->_size)
+        {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(this->_bytes + i));
+            if (_mm_movemask_epi8(block) != 0) { break; }
+            __m128i lo = _mm_unpacklo_epi8(block, zero);
+            __m128i hi = _mm_unpackhi_epi8(block, zero);
+            __m128i* dest = reinterpret_cast<__m128i*>(out);
+            _mm_storeu_si128(dest, _mm_unpacklo_epi16(lo, zero));
+            _mm_storeu_si128(dest + 1, _mm_unpackhi_epi16(lo, zero));
+            _mm_storeu_si128(dest + 2, _mm_unpacklo_epi16(hi, zero));
+            _mm_storeu_si128(dest + 3, _mm_unpackhi_epi16(hi, zero));
+            i += 16;
+            out += 16;
+        }
+        if (i >= this->_size) { break; }
+#endif
+
+        size_t len = onechar::evaluateLength(this->_bytes + i);
+        *(out++) = decode(this->_bytes + i, len);
+        i += len;
+    }
+    return out - start;
+}
+
+std::u16string onestring::to_utf16() const
+{
+    std::u16string r(utf16_size(), u'\0');
+    to_utf16(&r[0]);
+    return r;
+}
+
+std::u32string onestring::to_utf32() const
+{
+    std::u32string r(utf32_size(), U'\0');
+    to_utf32(&r[0]);
+    return r;
+}
+
+/*******************************************
+* Case Mapping
+********************************************/
+
+const int16_t* onestring::case_deltas(casing mode)
+{
+    // U+0080 to U+07FF are all of the two-byte characters.
+    static const struct tables
+    {
+        int16_t deltas[3][0x780];
+
+        tables()
+        :deltas()
+        {
+            int16_t* lower = deltas[static_cast<int>(casing::lower)];
+            int16_t* upper = deltas[static_cast<int>(casing::upper)];
+            int16_t* fold = deltas[static_cast<int>(casing::fold)];
+
+            auto pair = [&](char32_t up, char32_t low)
+            {
+                lower[up - 0x80] = static_cast<int16_t>(low - up);
+                upper[low - 0x80] = static_cast<int16_t>(up - low);
+            };
+            // A block of uppercase, and the block of lowercase after it.
+            auto run = [&](char32_t first, char32_t last, char32_t offset)
+            {
+                for (char32_t up = first; up <= last; ++up) { pair(up, up + offset); }
+            };
+            // Uppercase and lowercase, one after the other.
+            auto alternate = [&](char32_t first, char32_t last)
+            {
+                for (char32_t up = first; up < last; up += 2) { pair(up, up + 1); }
+            };
+
+            // Latin-1 Supplement, leaving out the multiplication sign.
+            run(0xC0, 0xD6, 0x20);
+            run(0xD8, 0xDE, 0x20);
+            pair(0x178, 0xFF);
+            upper[0xB5 - 0x80] = 0x39C - 0xB5;
+
+            // Latin Extended-A and the regular parts of Latin Extended-B.
+            alternate(0x100, 0x12F);
+            alternate(0x132, 0x137);
+            alternate(0x139, 0x148);
+            alternate(0x14A, 0x177);
+            alternate(0x179, 0x17E);
+            alternate(0x1CD, 0x1DC);
+            alternate(0x1DE, 0x1EF);
+            alternate(0x1F8, 0x21F);
+            alternate(0x222, 0x233);
+            alternate(0x246, 0x24F);
+
+            // Greek, including the final sigma, which has no uppercase of its own.
+            pair(0x386, 0x3AC);
+            run(0x388, 0x38A, 0x25);
+            pair(0x38C, 0x3CC);
+            run(0x38E, 0x38F, 0x3F);
+            run(0x391, 0x3A1, 0x20);
+            run(0x3A3, 0x3AB, 0x20);
+            upper[0x3C2 - 0x80] = 0x3A3 - 0x3C2;
+            alternate(0x3D8, 0x3EF);
+
+            // Cyrillic and Cyrillic Supplement.
+            run(0x400, 0x40F, 0x50);
+            run(0x410, 0x42F, 0x20);
+            alternate(0x460, 0x481);
+            alternate(0x48A, 0x4BF);
+            pair(0x4C0, 0x4CF);
+            alternate(0x4C1, 0x4CE);
+            alternate(0x4D0, 0x52F);
+
+            // Armenian.
+            run(0x531, 0x556, 0x30);
+
+            // Fold is lowercase of uppercase; both stay in this range.
+            for (char32_t cp = 0x80; cp < 0x800; ++cp)
+            {
+                char32_t up = cp + upper[cp - 0x80];
+                fold[cp - 0x80] = static_cast<int16_t>(up + lower[up - 0x80] - cp);
+            }
+        }
+    } built;
+
+    return built.deltas[static_cast<int>(mode)];
+}
+
+char32_t onestring::map_point(char32_t cp, casing mode)
+{
+    if (cp < 0x80)
+    {
+        if (mode == casing::upper) { return (cp >= 'a' && cp <= 'z') ? (cp ^ 0x20) : cp; }
+        return (cp >= 'A' && cp <= 'Z') ? (cp | 0x20) : cp;
+    }
+    if (cp < 0x800)
+    {
+        return cp + case_deltas(mode)[cp - 0x80];
+    }
+
+    // Latin Extended Additional, and fullwidth Latin, which need three bytes.
+    bool upper = (mode == casing::upper);
+    if ((cp >= 0x1E00 && cp <= 0x1E95) || (cp >= 0x1EA0 && cp <= 0x1EFF))
+    {
+        // Even code points are uppercase.
+        if (upper) { return (cp & 1) ? cp - 1 : cp; }
+        return (cp & 1) ? cp : cp + 1;
+    }
+    if (upper && cp >= 0xFF41 && cp <= 0xFF5A) { return cp - 0x20; }
+    if (!upper && cp >= 0xFF21 && cp <= 0xFF3A) { return cp + 0x20; }
+    return cp;
+}
+
+bool onestring::map_ascii(const char* in, char* out, casing mode)
+{
+    char first = (mode == casing::upper) ? 'a' : 'A';
+#ifdef __SSE2__
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+    if (_mm_movemask_epi8(block) != 0) { return false; }
+
+    // Flip the case bit of every letter in the range.
+    __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8(first - 1)),
+                                    _mm_cmplt_epi8(block, _mm_set1_epi8(first + 26)));
+    block = _mm_xor_si128(block, _mm_and_si128(letters, _mm_set1_epi8(0x20)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), block);
+    return true;
+#else
+    char any = 0;
+    for (size_t i = 0; i < 16; ++i) { any |= in[i]; }
+    if (any & 0x80) { return false; }
+    for (size_t i = 0; i < 16; ++i)
+    {
+        out[i] = (in[i] >= first && in[i] < first + 26) ? (in[i] ^ 0x20) : in[i];
+    }
+    return true;
+#endif
+}
+
+size_t onestring::map_char(const char* in, size_t n, char* out, casing mode)
+{
+    unsigned char lead = static_cast<unsigned char>(in[0]);
+    if (lead < 0x80)
+    {
+        out[0] = static_cast<char>(map_point(lead, mode));
+        return 1;
+    }
+
+    size_t len = onechar::evaluateLength(in);
+    if (len > n)
+    {
+        len = n;
+    }
+    else if (len > 1)
+    {
+        char32_t cp = decode(in, len);
+        char32_t mapped = map_point(cp, mode);
+        // An overlong sequence is left alone, as it would change length.
+        size_t natural = (cp < 0x80) ? 1 : (cp < 0x800) ? 2 : (cp < 0x10000) ? 3 : 4;
+        if (mapped != cp && natural == len)
+        {
+            encode(mapped, out);
+            return len;
+        }
+    }
+
+    // A cut-off sequence, or a stray continuation byte, is copied as it is.
+    if (in != out) { memcpy(out, in, len); }
+    return len;
+}
+
+void onestring::map_case(const char* in, size_t n, char* out, casing mode)
+{
+    size_t i = 0;
+    while (i < n)
+    {
+        if (i + 16 <= n && map_ascii(in + i, out + i, mode))
+        {
+            i += 16;
+            continue;
+        }
+
+        /* Go character by character to the end of this block, so a block
+         * with non-ASCII in it isn't tried again at every character. */
+        size_t stop = (i + 16 < n) ? i + 16 : n;
+        while (i < stop)
+        {
+            i += map_char(in + i, n - i, out + i, mode);
+        }
+    }
+}
+
+int onestring::fold_compare(const char* a, size_t an, const char* b, size_t bn)
+{
+    /* Folded characters keep their lengths, and UTF-8 is prefix-free, so
+     * while the two match, their characters start at the same offsets. */
+    size_t n = (an < bn) ? an : bn;
+    char folded_a[16];
+    char folded_b[16];
+    size_t i = 0;
+    while (i < n)
+    {
+        if (i + 16 <= n && map_ascii(a + i, folded_a, casing::fold) &&
+            map_ascii(b + i, folded_b, casing::fold))
+        {
+            int diff = memcmp(folded_a, folded_b, 16);
+            if (diff != 0) { return diff; }
+            i += 16;
+            continue;
+        }
+
+        // See map_case()
+        size_t stop = (i + 16 < n) ? i + 16 : n;
+        while (i < stop)
+        {
+            size_t len_a = map_char(a + i, an - i, folded_a, casing::fold);
+            size_t len_b = map_char(b + i, bn - i, folded_b, casing::fold);
+            int diff = memcmp(folded_a, folded_b, (len_a < len_b) ? len_a : len_b);
+            if (diff != 0) { return diff; }
+            if (len_a != len_b) { return (len_a < len_b) ? -1 : 1; }
+            i += len_a;
+        }
+    }
+
+    if (an == bn) { return 0; }
+    return (an < bn) ? -1 : 1;
+}
+
+onestring onestring::mapped(const onestring_view& view, casing mode)
+{
+    onestring r;
+    r.allocate(view._size);
+    map_case(view._bytes, view._size, r._bytes, mode);
+    r._bytes[view._size] = '\0';
+    r._size = view._size;
+    r._elements = view._elements;
+    return r;
 }
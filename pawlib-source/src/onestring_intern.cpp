@@ -0,0 +1,170 @@
+#include "pawlib/onestring_intern.hpp"
+
+onestring_interner::entry* onestring_interner::lookup(const table* t, const onestring_view& text, size_t hash)
+{
+    if (t == nullptr) { return nullptr; }
+
+    // Probe from the hash's slot until we find the text or an empty slot.
+    size_t mask = t->capacity - 1;
+    for (size_t i = hash & mask; ; i = (i + 1) & mask)
+    {
+        entry* e = t->slots[i].load(std::memory_order_acquire);
+        if (e == nullptr) { return nullptr; }
+
+        // Compare the hashes first, so most mismatches never touch the text.
+        if (e->hash == hash && e->size == text._size &&
+            memcmp(e->bytes(), text._bytes, text._size) == 0)
+        {
+            return e;
+        }
+    }
+}
+
+onestring_interner::entry* onestring_interner::store(shard& s, const onestring_view& text, size_t hash)
+{
+    // Keep every entry aligned, so the next one can follow directly.
+    const size_t align = alignof(entry);
+    size_t needed = sizeof(entry) + text._size + 1;
+    needed = ((needed + align - 1) / align) * align;
+
+    if (needed > s.remaining)
+    {
+        // Unusually long text gets a block all to itself.
+        size_t capacity = (needed > BLOCK_SIZE) ? needed : BLOCK_SIZE;
+        char* memory = static_cast<char*>(::operator new(sizeof(block) + capacity));
+
+        block* b = reinterpret_cast<block*>(memory);
+        b->prev = s.blocks;
+        s.blocks = b;
+
+        s.cursor = memory + sizeof(block);
+        s.remaining = capacity;
+    }
+
+    entry* e = reinterpret_cast<entry*>(s.cursor);
+    s.cursor += needed;
+    s.remaining -= needed;
+
+    e->hash = hash;
+    e->size = text._size;
+    e->elements = text._elements;
+    char* bytes = reinterpret_cast<char*>(e + 1);
+    memcpy(bytes, text._bytes, text._size);
+    bytes[text._size] = '\0';
+
+    // Keep the table no more than half full, so probes stay short.
+    table* t = s.current.load(std::memory_order_relaxed);
+    if (t == nullptr || (s.count + 1) * 2 > t->capacity)
+    {
+        grow(s);
+        t = s.current.load(std::memory_order_relaxed);
+    }
+
+    size_t mask = t->capacity - 1;
+    size_t i = hash & mask;
+    while (t->slots[i].load(std::memory_order_relaxed) != nullptr)
+    {
+        i = (i + 1) & mask;
+    }
+    // Publish the entry only once it is complete.
+    t->slots[i].store(e, std::memory_order_release);
+    ++s.count;
+
+    return e;
+}
+
+void onestring_interner::grow(shard& s)
+{
+    table* old = s.current.load(std::memory_order_relaxed);
+
+    table* t = new table;
+    t->prev = old;
+    t->capacity = (old == nullptr) ? INITIAL_SLOTS : old->capacity * 2;
+    t->slots = new std::atomic<entry*>[t->capacity];
+    for (size_t i = 0; i < t->capacity; ++i)
+    {
+        t->slots[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    // The entries themselves never move; only the pointers to them are copied.
+    if (old != nullptr)
+    {
+        size_t mask = t->capacity - 1;
+        for (size_t j = 0; j < old->capacity; ++j)
+        {
+            entry* e = old->slots[j].load(std::memory_order_relaxed);
+            if (e == nullptr) { continue; }
+
+            size_t i = e->hash & mask;
+            while (t->slots[i].load(std::memory_order_relaxed) != nullptr)
+            {
+                i = (i + 1) & mask;
+            }
+            t->slots[i].store(e, std::memory_order_relaxed);
+        }
+    }
+
+    // Readers still using the old table will simply miss newer entries.
+    s.current.store(t, std::memory_order_release);
+}
+
+onestring_interner::handle onestring_interner::intern(const onestring_view& text)
+{
+    size_t hash = text.hash();
+    shard& s = shard_for(hash);
+
+    // Most text has been interned before, so look for it without locking.
+    entry* e = lookup(s.current.load(std::memory_order_acquire), text, hash);
+    if (e != nullptr) { return handle(e); }
+
+    std::lock_guard<std::mutex> guard(s.lock);
+    // Another thread may have interned the text while we waited.
+    e = lookup(s.current.load(std::memory_order_relaxed), text, hash);
+    if (e == nullptr)
+    {
+        e = store(s, text, hash);
+    }
+    return handle(e);
+}
+
+onestring_interner::handle onestring_interner::find(const onestring_view& text) const
+{
+    size_t hash = text.hash();
+    shard& s = shard_for(hash);
+    return handle(lookup(s.current.load(std::memory_order_acquire), text, hash));
+}
+
+size_t onestring_interner::size() const
+{
+    size_t total = 0;
+    for (shard& s : shards)
+    {
+        std::lock_guard<std::mutex> guard(s.lock);
+        total += s.count;
+    }
+    return total;
+}
+
+onestring_interner::~onestring_interner()
+{
+    for (shard& s : shards)
+    {
+        // Release every table, including the ones it replaced.
+        table* t = s.current.load(std::memory_order_relaxed);
+        while (t != nullptr)
+        {
+            table* prev = t->prev;
+            delete[] t->slots;
+            delete t;
+            t = prev;
+        }
+
+        // Release every block, and all the entries in it.
+        while (s.blocks != nullptr)
+        {
+            block* prev = s.blocks->prev;
+            ::operator delete(s.blocks);
+            s.blocks = prev;
+        }
+    }
+}
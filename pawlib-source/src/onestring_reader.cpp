@@ -0,0 +1,135 @@
+#include "pawlib/onestring_reader.hpp"
+
+#include <stdexcept>
+
+/*******************************************
+* Constructors + Destructor
+*******************************************/
+
+onestring_reader::onestring_reader(std::istream& is, const onestring_view& delim,
+                                   size_t buffer_size)
+:_stream(is), _delim(delim.data(), delim.size()), _buffer(nullptr),
+ _capacity((buffer_size > 0) ? buffer_size : BUFFER_SIZE), _start(0), _end(0),
+ _records(0)
+{
+    if (this->_delim.empty())
+    {
+        throw std::invalid_argument("Onestring_reader(): delimiter must not be empty");
+    }
+    this->_buffer = new char[this->_capacity];
+}
+
+onestring_reader::~onestring_reader()
+{
+    delete[] this->_buffer;
+}
+
+/*******************************************
+* Buffering
+*******************************************/
+
+bool onestring_reader::refill()
+{
+    // Move what is left to the front of the buffer.
+    size_t left = this->_end - this->_start;
+    if (this->_start > 0)
+    {
+        memmove(this->_buffer, this->_buffer + this->_start, left);
+        this->_start = 0;
+        this->_end = left;
+    }
+
+    // If the buffer is still full, a record is longer than it; grow it.
+    if (this->_end == this->_capacity)
+    {
+        size_t capacity = this->_capacity * 2;
+        char* buffer = new char[capacity];
+        memcpy(buffer, this->_buffer, this->_end);
+        delete[] this->_buffer;
+        this->_buffer = buffer;
+        this->_capacity = capacity;
+    }
+
+    if (!this->_stream) { return false; }
+    this->_stream.read(this->_buffer + this->_end, this->_capacity - this->_end);
+    size_t got = static_cast<size_t>(this->_stream.gcount());
+    this->_end += got;
+    return (got > 0);
+}
+
+bool onestring_reader::find_record(size_t& end, size_t& skip)
+{
+    // The number of bytes after _start that are already known not to match.
+    size_t searched = 0;
+    while (true)
+    {
+        const char* hay = this->_buffer + this->_start + searched;
+        size_t n = this->_end - this->_start - searched;
+
+        // Most delimiters are one byte, which memchr() finds fastest.
+        const char* found;
+        if (this->_delim.size() == 1)
+        {
+            found = static_cast<const char*>(memchr(hay, this->_delim[0], n));
+        }
+        else
+        {
+            found = onestring::search(hay, n, this->_delim.data(), this->_delim.size());
+        }
+
+        if (found != nullptr)
+        {
+            end = found - this->_buffer;
+            skip = this->_delim.size();
+            return true;
+        }
+
+        // Next time, only search the new text, and anything that could
+        // be the start of a delimiter cut off by the end of the buffer.
+        size_t avail = this->_end - this->_start;
+        searched = (avail >= this->_delim.size()) ? avail - this->_delim.size() + 1 : 0;
+
+        if (!refill())
+        {
+            // The last record may not have a delimiter after it.
+            if (this->_start == this->_end) { return false; }
+            end = this->_end;
+            skip = 0;
+            return true;
+        }
+    }
+}
+
+/*******************************************
+* Records
+*******************************************/
+
+bool onestring_reader::next(onestring_view& record)
+{
+    size_t end;
+    size_t skip;
+    if (!find_record(end, skip)) { return false; }
+
+    const char* bytes = this->_buffer + this->_start;
+    size_t n = end - this->_start;
+    this->_start = end + skip;
+
+    // Validate the whole record at once, and only repair it if needed.
+    size_t chars;
+    if (onestring::scan(bytes, n, chars) != onestring::npos)
+    {
+        chars = onestring::validated(bytes, n, this->_repaired);
+    }
+
+    record = onestring_view(bytes, n, chars);
+    ++this->_records;
+    return true;
+}
+
+bool onestring_reader::next(onestring& record)
+{
+    onestring_view view;
+    if (!next(view)) { return false; }
+    record.assign(view);
+    return true;
+}
@@ -0,0 +1,491 @@
+#include "pawlib/onestring_rope.hpp"
+
+#include <new>
+#include <vector>
+
+/*******************************************
+* Nodes
+*******************************************/
+
+onestring_rope::node* onestring_rope::make_leaf(const char* bytes, size_t n, size_t chars)
+{
+    if (n == 0) { return nullptr; }
+
+    void* memory = ::operator new(sizeof(node) + n);
+    node* leaf = new (memory) node;
+    leaf->refs.store(1, std::memory_order_relaxed);
+    leaf->size = n;
+    leaf->elements = chars;
+    leaf->height = 0;
+    leaf->left = nullptr;
+    leaf->right = nullptr;
+    memcpy(const_cast<char*>(leaf->bytes()), bytes, n);
+    return leaf;
+}
+
+onestring_rope::node* onestring_rope::make_branch(node* left, node* right)
+{
+    if (left == nullptr) { return right; }
+    if (right == nullptr) { return left; }
+
+    void* memory = ::operator new(sizeof(node));
+    node* branch = new (memory) node;
+    branch->refs.store(1, std::memory_order_relaxed);
+    branch->size = left->size + right->size;
+    branch->elements = left->elements + right->elements;
+    branch->height = ((left->height > right->height) ? left->height : right->height) + 1;
+    branch->left = left;
+    branch->right = right;
+    return branch;
+}
+
+onestring_rope::node* onestring_rope::retain(node* t)
+{
+    if (t != nullptr)
+    {
+        t->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    return t;
+}
+
+void onestring_rope::release(node* t)
+{
+    // Work down the tree with a loop, rather than recursion, where we can.
+    while (t != nullptr && t->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        node* left = t->left;
+        node* right = t->right;
+        t->~node();
+        ::operator delete(t);
+
+        release(left);
+        t = right;
+    }
+}
+
+/*******************************************
+* Balancing
+*******************************************/
+
+onestring_rope::node* onestring_rope::balance(node* left, node* right)
+{
+    size_t hl = (left == nullptr) ? 0 : left->height;
+    size_t hr = (right == nullptr) ? 0 : right->height;
+
+    // Too tall on the right: rotate left (twice, if its inside is taller).
+    if (hr > hl + 1)
+    {
+        node* inner = right->left;
+        node* outer = right->right;
+        node* result;
+        if (inner->height > outer->height)
+        {
+            result = make_branch(make_branch(left, retain(inner->left)),
+                                 make_branch(retain(inner->right), retain(outer)));
+        }
+        else
+        {
+            result = make_branch(make_branch(left, retain(inner)), retain(outer));
+        }
+        release(right);
+        return result;
+    }
+
+    // Too tall on the left: the mirror image.
+    if (hl > hr + 1)
+    {
+        node* inner = left->right;
+        node* outer = left->left;
+        node* result;
+        if (inner->height > outer->height)
+        {
+            result = make_branch(make_branch(retain(outer), retain(inner->left)),
+                                 make_branch(retain(inner->right), right));
+        }
+        else
+        {
+            result = make_branch(retain(outer), make_branch(retain(inner), right));
+        }
+        release(left);
+        return result;
+    }
+
+    return make_branch(left, right);
+}
+
+onestring_rope::node* onestring_rope::join(node* left, node* right)
+{
+    if (left == nullptr) { return right; }
+    if (right == nullptr) { return left; }
+
+    // Merge small neighbouring leaves, so many small edits don't leave
+    // the tree full of tiny leaves.
+    if (left->height == 0 && right->height == 0 && left->size + right->size <= LEAF_SIZE)
+    {
+        void* memory = ::operator new(sizeof(node) + left->size + right->size);
+        node* leaf = new (memory) node;
+        leaf->refs.store(1, std::memory_order_relaxed);
+        leaf->size = left->size + right->size;
+        leaf->elements = left->elements + right->elements;
+        leaf->height = 0;
+        leaf->left = nullptr;
+        leaf->right = nullptr;
+        char* dest = const_cast<char*>(leaf->bytes());
+        memcpy(dest, left->bytes(), left->size);
+        memcpy(dest + left->size, right->bytes(), right->size);
+        release(left);
+        release(right);
+        return leaf;
+    }
+
+    // Join the shorter tree onto the facing edge of the taller one, at
+    // the point where they are about the same height.
+    if (left->height > right->height + 1)
+    {
+        node* result = balance(retain(left->left), join(retain(left->right), right));
+        release(left);
+        return result;
+    }
+    if (right->height > left->height + 1)
+    {
+        node* result = balance(join(left, retain(right->left)), retain(right->right));
+        release(right);
+        return result;
+    }
+    return make_branch(left, right);
+}
+
+void onestring_rope::split(node* t, size_t pos, node*& left, node*& right)
+{
+    if (t == nullptr || pos == 0)
+    {
+        left = nullptr;
+        right = retain(t);
+        return;
+    }
+    if (pos >= t->elements)
+    {
+        left = retain(t);
+        right = nullptr;
+        return;
+    }
+
+    if (t->height == 0)
+    {
+        size_t off = onestring::advance(t->bytes(), t->size, pos);
+        left = make_leaf(t->bytes(), off, pos);
+        right = make_leaf(t->bytes() + off, t->size - off, t->elements - pos);
+        return;
+    }
+
+    size_t split_at = t->left->elements;
+    if (pos < split_at)
+    {
+        node* inner;
+        split(t->left, pos, left, inner);
+        right = join(inner, retain(t->right));
+    }
+    else if (pos == split_at)
+    {
+        left = retain(t->left);
+        right = retain(t->right);
+    }
+    else
+    {
+        node* inner;
+        split(t->right, pos - split_at, inner, right);
+        left = join(retain(t->left), inner);
+    }
+}
+
+onestring_rope::node* onestring_rope::build(const char* bytes, size_t n)
+{
+    // Cut the text into leaves, ending each at the start of a character.
+    std::vector<node*> leaves;
+    size_t start = 0;
+    while (start < n)
+    {
+        size_t end = start + LEAF_SIZE;
+        if (end >= n)
+        {
+            end = n;
+        }
+        else
+        {
+            while (end > start && (bytes[end] & 0xC0) == 0x80) { --end; }
+        }
+        leaves.push_back(make_leaf(bytes + start, end - start,
+                                   onestring::count_leads(bytes + start, end - start)));
+        start = end;
+    }
+
+    // Pair the leaves up, level by level, into a balanced tree.
+    while (leaves.size() > 1)
+    {
+        size_t half = 0;
+        for (size_t i = 0; i < leaves.size(); i += 2)
+        {
+            leaves[half++] = (i + 1 < leaves.size())
+                             ? make_branch(leaves[i], leaves[i + 1])
+                             : leaves[i];
+        }
+        leaves.resize(half);
+    }
+    return leaves.empty() ? nullptr : leaves[0];
+}
+
+const onestring_rope::node* onestring_rope::leaf_at(const node* t, size_t& pos)
+{
+    while (t->height > 0)
+    {
+        if (pos < t->left->elements)
+        {
+            t = t->left;
+        }
+        else
+        {
+            pos -= t->left->elements;
+            t = t->right;
+        }
+    }
+    return t;
+}
+
+/*******************************************
+* Constructors
+*******************************************/
+
+onestring_rope::onestring_rope(const char* cstr)
+:onestring_rope(std::string(cstr))
+{}
+
+onestring_rope::onestring_rope(const std::string& str)
+:root(nullptr)
+{
+    const char* bytes = str.data();
+    size_t n = str.size();
+    std::string repaired;
+    onestring::validated(bytes, n, repaired);
+    root = build(bytes, n);
+}
+
+onestring_rope::onestring_rope(const onestring& ostr)
+:root(build(ostr.data(), ostr.size() - 1))
+{}
+
+onestring_rope::onestring_rope(const onestring_view& view)
+:root(build(view.data(), view.size()))
+{}
+
+/*******************************************
+* Iterators
+*******************************************/
+
+onestring_rope::const_iterator::const_iterator(const node* t, size_t at)
+:tree(t), leaf(nullptr), off(0), pos(at)
+{
+    seek();
+}
+
+void onestring_rope::const_iterator::seek()
+{
+    if (tree == nullptr || pos >= tree->elements)
+    {
+        leaf = nullptr;
+        off = 0;
+        return;
+    }
+    size_t in_leaf = pos;
+    leaf = leaf_at(tree, in_leaf);
+    off = onestring::advance(leaf->bytes(), leaf->size, in_leaf);
+}
+
+onestring_rope::const_iterator& onestring_rope::const_iterator::operator++()
+{
+    ++pos;
+    off += onechar::evaluateLength(leaf->bytes() + off);
+    // Move on to the next leaf when we run off the end of this one.
+    if (off >= leaf->size) { seek(); }
+    return *this;
+}
+
+onestring_rope::const_iterator& onestring_rope::const_iterator::operator--()
+{
+    --pos;
+    if (leaf == nullptr || off == 0)
+    {
+        seek();
+        return *this;
+    }
+    // Step back over the continuation bytes.
+    do { --off; } while ((leaf->bytes()[off] & 0xC0) == 0x80);
+    return *this;
+}
+
+/*******************************************
+* Accessors
+*******************************************/
+
+onechar onestring_rope::at(size_t pos) const
+{
+    if (pos >= length())
+    {
+        throw std::out_of_range("Onestring_rope::at(): specified pos out of range");
+    }
+
+    const node* leaf = leaf_at(root, pos);
+    return onechar(leaf->bytes() + onestring::advance(leaf->bytes(), leaf->size, pos));
+}
+
+onestring_rope onestring_rope::substr(size_t pos, size_t len) const
+{
+    if (pos > length())
+    {
+        throw std::out_of_range("Onestring_rope::substr(): specified pos out of range");
+    }
+
+    node* before;
+    node* rest;
+    split(root, pos, before, rest);
+    release(before);
+
+    node* middle;
+    node* after;
+    split(rest, len, middle, after);
+    release(rest);
+    release(after);
+
+    return onestring_rope(middle);
+}
+
+onestring onestring_rope::str() const
+{
+    onestring r;
+    r.reserve(size());
+    for_each_leaf(root, [&r](const onestring_view& chunk) { r.append(chunk); });
+    return r;
+}
+
+/*******************************************
+* Comparison
+*******************************************/
+
+bool onestring_rope::equals(const onestring_view& view) const
+{
+    if (view.size() != size()) { return false; }
+
+    // Compare the view with each leaf in turn.
+    const char* cmp = view.data();
+    bool same = true;
+    for_each_leaf(root, [&cmp, &same](const onestring_view& chunk)
+    {
+        same = same && (memcmp(chunk.data(), cmp, chunk.size()) == 0);
+        cmp += chunk.size();
+    });
+    return same;
+}
+
+bool onestring_rope::equals(const onestring_rope& rope) const
+{
+    if (root == rope.root) { return true; }
+    if (rope.size() != size()) { return false; }
+
+    // The leaves of the two ropes may not line up, so walk them together.
+    std::vector<onestring_view> mine;
+    std::vector<onestring_view> theirs;
+    for_each_leaf(root, [&mine](const onestring_view& chunk) { mine.push_back(chunk); });
+    for_each_leaf(rope.root, [&theirs](const onestring_view& chunk) { theirs.push_back(chunk); });
+
+    size_t i = 0;
+    size_t j = 0;
+    size_t off_i = 0;
+    size_t off_j = 0;
+    while (i < mine.size() && j < theirs.size())
+    {
+        size_t left_i = mine[i].size() - off_i;
+        size_t left_j = theirs[j].size() - off_j;
+        size_t n = (left_i < left_j) ? left_i : left_j;
+        if (memcmp(mine[i].data() + off_i, theirs[j].data() + off_j, n) != 0)
+        {
+            return false;
+        }
+        off_i += n;
+        off_j += n;
+        if (off_i == mine[i].size()) { ++i; off_i = 0; }
+        if (off_j == theirs[j].size()) { ++j; off_j = 0; }
+    }
+    return true;
+}
+
+/*******************************************
+* Modifiers
+*******************************************/
+
+onestring_rope& onestring_rope::append(const onestring_view& view)
+{
+    root = join(root, build(view.data(), view.size()));
+    return *this;
+}
+
+onestring_rope& onestring_rope::append(const onestring_rope& rope)
+{
+    root = join(root, retain(rope.root));
+    return *this;
+}
+
+void onestring_rope::clear()
+{
+    release(root);
+    root = nullptr;
+}
+
+onestring_rope& onestring_rope::erase(size_t pos, size_t len)
+{
+    return replace(pos, len, onestring_rope());
+}
+
+onestring_rope& onestring_rope::insert(size_t pos, const onestring_view& view)
+{
+    if (pos > length())
+    {
+        throw std::out_of_range("Onestring_rope::insert(): specified pos out of range");
+    }
+    return replace(pos, 0, onestring_rope(build(view.data(), view.size())));
+}
+
+onestring_rope& onestring_rope::insert(size_t pos, const onestring_rope& rope)
+{
+    if (pos > length())
+    {
+        throw std::out_of_range("Onestring_rope::insert(): specified pos out of range");
+    }
+    return replace(pos, 0, rope);
+}
+
+onestring_rope& onestring_rope::replace(size_t pos, size_t len, const onestring_view& view)
+{
+    return replace(pos, len, onestring_rope(build(view.data(), view.size())));
+}
+
+onestring_rope& onestring_rope::replace(size_t pos, size_t len, const onestring_rope& rope)
+{
+    if (pos > length())
+    {
+        throw std::out_of_range("Onestring_rope::replace(): specified pos out of range");
+    }
+
+    node* before;
+    node* rest;
+    split(root, pos, before, rest);
+
+    node* middle;
+    node* after;
+    split(rest, len, middle, after);
+    release(rest);
+    release(middle);
+
+    node* old = root;
+    root = join(join(before, retain(rope.root)), after);
+    release(old);
+    return *this;
+}
@@ -158,11 +158,54 @@ void TestSuite_Onestring::load_tests()
     register_test("P-tB4034", new TestOnestring_ForceResize());
     register_test("P-tS4034", new TestOnestring_ForceResizeStress(), false);
 
-    // tB4035: find
-    // tB4036: find_first_not_of
-    // tB4037: find_first_of
-    // tB4038: find_last_not_of
-    // tB4039: rfind
+    register_test("P-tB4035", new TestOnestring_Find());
+    register_test("P-tB4036", new TestOnestring_FindFirstNotOf());
+    register_test("P-tB4037", new TestOnestring_FindFirstOf());
+    register_test("P-tB4038", new TestOnestring_FindLastNotOf());
+    register_test("P-tB4039", new TestOnestring_RFind());
+
+    register_test("P-tB4040", new TestOnestring_LongAccess());
+    register_test("P-tB4041", new TestOnestring_ShortBuild(), true, new TestStdString_ShortBuild());
+    register_test("P-tB4042", new TestOnestring_Inline());
+    register_test("P-tB4043", new TestOnestring_Move());
+    register_test("P-tB4044", new TestOnestring_CStrStable());
+    register_test("P-tB4045", new TestOnestring_FindLastOf());
+    register_test("P-tB4046", new TestOnestring_Count());
+    register_test("P-tB4047", new TestOnestring_FindLong(), true, new TestStdString_FindLong());
+    register_test("P-tB4048", new TestOnestring_Validate());
+    register_test("P-tB4049", new TestOnestring_Ingest(), true, new TestStdString_Ingest());
+    register_test("P-tB4050", new TestOnestringView_Access());
+    register_test("P-tB4051", new TestOnestringView_Search());
+    register_test("P-tB4052", new TestOnestringView_Iterate());
+    register_test("P-tB4053", new TestOnestring_FromView());
+    register_test("P-tB4054", new TestOnestringView_Tokenize(), true, new TestStdString_Tokenize());
+    register_test("P-tB4055", new TestOnestring_Hash());
+    register_test("P-tB4056", new TestOnestring_HashLong(), true, new TestStdString_HashLong());
+    register_test("P-tB4057", new TestOnestring_Intern());
+    register_test("P-tB4058", new TestOnestring_InternRepeat(), true, new TestStdString_InternRepeat());
+    register_test("P-tB4059", new TestOnestring_RandomEdits());
+    register_test("P-tB4060", new TestOnestring_EditLong(), true, new TestStdString_EditLong());
+    register_test("P-tB4061", new TestOnestringRope_Edit());
+    register_test("P-tB4062", new TestOnestringRope_Share());
+    register_test("P-tB4063", new TestOnestringRope_EditLong(), true, new TestOnestring_EditLong());
+    register_test("P-tB4064", new TestOnestring_Concat());
+    register_test("P-tB4065", new TestOnestring_ConcatChain(), true, new TestStdString_ConcatChain());
+    register_test("P-tB4066", new TestOnestring_StartsEndsWith());
+    register_test("P-tB4067", new TestOnestring_Sort(), true, new TestStdString_Sort());
+    register_test("P-tB4068", new TestOnestringReader_Records());
+    register_test("P-tB4069", new TestOnestringReader_ReadLines(), true, new TestOnestring_GetLine());
+    register_test("P-tB4070", new TestOnestring_Transcode());
+    register_test("P-tB4071", new TestOnestring_ToUTF16(), true, new TestOnestring_ToUTF16Chars());
+    register_test("P-tB4072", new TestOnestring_CaseMapping());
+    register_test("P-tB4073", new TestOnestring_ICompare());
+    register_test("P-tB4074", new TestOnestring_IEqualsHeaders(), true, new TestStdString_IEqualsHeaders());
+    register_test("P-tB4075", new TestOnestringTokenizer_Split());
+    register_test("P-tB4076", new TestOnestringTokenizer_SplitFields(), true, new TestStdutils_StdSplit());
+    register_test("P-tB4077", new TestOnestring_MemoryResource());
+    register_test("P-tB4078", new TestOnestring_ArenaRequest(), true, new TestOnestring_HeapRequest());
+    register_test("P-tB4079", new TestOnestring_Format());
+    register_test("P-tB4080", new TestOnestring_FormatMessage(), true, new TestOnestring_FormatSnprintf());
+    register_test("P-tB4081", new TestOnestring_IndexMixedWidths());
 
     //TODO: Comparative tests against std::string
 }
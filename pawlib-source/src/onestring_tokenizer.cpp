@@ -0,0 +1,108 @@
+#include "pawlib/onestring_tokenizer.hpp"
+
+#include <stdexcept>
+
+/*******************************************
+* Constructors
+*******************************************/
+
+onestring_tokenizer::onestring_tokenizer(const onestring_view& text,
+                                         const onestring_view& delim,
+                                         bool any_of, bool keep_empty)
+:_text(text), _delim(delim), _any(any_of), _keep_empty(keep_empty), _marked(),
+ _start(0), _done(false), _tokens(0)
+{
+    if (this->_delim.empty())
+    {
+        throw std::invalid_argument("Onestring_tokenizer(): delimiter must not be empty");
+    }
+
+    // See onestring::find_of()
+    for (size_t i = 0; i < this->_delim._size; ++i)
+    {
+        this->_marked[static_cast<unsigned char>(this->_delim._bytes[i])] = true;
+    }
+}
+
+/*******************************************
+* Tokens
+*******************************************/
+
+size_t onestring_tokenizer::find_token(size_t& skip) const
+{
+    const char* bytes = this->_text._bytes;
+    size_t size = this->_text._size;
+    const char* hay = bytes + this->_start;
+    size_t n = size - this->_start;
+
+    if (!this->_any)
+    {
+        skip = this->_delim._size;
+
+        // Most delimiters are one byte, which memchr() finds fastest.
+        const char* found;
+        if (this->_delim._size == 1)
+        {
+            found = static_cast<const char*>(memchr(hay, this->_delim._bytes[0], n));
+        }
+        else
+        {
+            found = onestring::search(hay, n, this->_delim._bytes, this->_delim._size);
+        }
+        return (found != nullptr) ? found - bytes : onestring_view::npos;
+    }
+
+    // An ASCII set only needs one lookup per byte.
+    if (this->_delim._size == this->_delim._elements)
+    {
+        skip = 1;
+        for (size_t off = this->_start; off < size; ++off)
+        {
+            if (this->_marked[static_cast<unsigned char>(bytes[off])]) { return off; }
+        }
+        return onestring_view::npos;
+    }
+
+    size_t off = this->_start;
+    while (off < size)
+    {
+        size_t len = onechar::evaluateLength(bytes + off);
+        if (this->_marked[static_cast<unsigned char>(bytes[off])] &&
+            onestring::in_set(this->_delim._bytes, this->_delim._size, bytes + off, len))
+        {
+            skip = len;
+            return off;
+        }
+        off += len;
+    }
+    return onestring_view::npos;
+}
+
+bool onestring_tokenizer::next(onestring_view& token)
+{
+    while (!this->_done)
+    {
+        size_t skip = 0;
+        size_t end = find_token(skip);
+        size_t start = this->_start;
+        if (end == onestring_view::npos)
+        {
+            // The last token runs to the end of the text.
+            end = this->_text._size;
+            this->_done = true;
+        }
+        else
+        {
+            this->_start = end + skip;
+        }
+
+        if (end == start && !this->_keep_empty) { continue; }
+
+        const char* bytes = this->_text._bytes + start;
+        size_t n = end - start;
+        token = onestring_view(bytes, n, onestring::count_leads(bytes, n));
+        ++this->_tokens;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,305 @@
+#include "pawlib/onestring_view.hpp"
+#include "pawlib/onestring.hpp"
+
+/*******************************************
+* Constructors
+*******************************************/
+
+onestring_view::onestring_view(const char* cstr)
+:onestring_view(cstr, strlen(cstr))
+{}
+
+onestring_view::onestring_view(const char* bytes, size_t n)
+:_bytes(bytes), _size(n), _elements(0)
+{
+    // A view can't repair its text, so it can only refuse it.
+    if (onestring::scan(bytes, n, _elements) != npos)
+    {
+        throw std::invalid_argument("Onestring_view(): text is not valid UTF-8");
+    }
+}
+
+onestring_view::onestring_view(const std::string& str)
+:onestring_view(str.data(), str.size())
+{}
+
+onestring_view::onestring_view(const onestring& ostr)
+:_bytes(ostr._bytes), _size(ostr._size), _elements(ostr._elements)
+{}
+
+/*******************************************
+* Accessors
+*******************************************/
+
+size_t onestring_view::offset_of(size_t pos) const
+{
+    // In an ASCII-only view, every character is a single byte.
+    if (this->_size == this->_elements) { return pos; }
+
+    return onestring::advance(this->_bytes, this->_size, pos);
+}
+
+onechar onestring_view::at(size_t pos) const
+{
+    if (pos >= this->_elements)
+    {
+        throw std::out_of_range("Onestring_view::at(): specified pos out of range");
+    }
+    return onechar(this->_bytes + offset_of(pos));
+}
+
+onechar onestring_view::back() const
+{
+    return *(--end());
+}
+
+size_t onestring_view::hash(size_t seed) const
+{
+    return onestring::hash_bytes(this->_bytes, this->_size, seed);
+}
+
+onechar onestring_view::front() const
+{
+    return onechar(this->_bytes);
+}
+
+onestring_view onestring_view::substr(size_t pos, size_t len) const
+{
+    if (pos >= this->_elements)
+    {
+        throw std::out_of_range("Onestring_view::substr(): specified pos out of range");
+    }
+
+    size_t chars = (len > _elements - pos) ? (_elements - pos) : len;
+
+    // Find the end by counting on from the start, rather than from scratch.
+    size_t start = offset_of(pos);
+    size_t end = start + chars;
+    if (this->_size != this->_elements)
+    {
+        end = start + onestring::advance(this->_bytes + start, this->_size - start, chars);
+    }
+
+    return onestring_view(this->_bytes + start, end - start, chars);
+}
+
+/*******************************************
+* Modifiers
+********************************************/
+
+void onestring_view::remove_prefix(size_t len)
+{
+    if (len > this->_elements)
+    {
+        throw std::out_of_range("Onestring_view::remove_prefix(): specified len out of range");
+    }
+
+    size_t off = offset_of(len);
+    this->_bytes += off;
+    this->_size -= off;
+    this->_elements -= len;
+}
+
+void onestring_view::remove_suffix(size_t len)
+{
+    if (len > this->_elements)
+    {
+        throw std::out_of_range("Onestring_view::remove_suffix(): specified len out of range");
+    }
+
+    // Step back from the end, rather than walking from the start.
+    size_t off = this->_size;
+    for (size_t i = 0; i < len; ++i)
+    {
+        do { --off; } while ((this->_bytes[off] & 0xC0) == 0x80);
+    }
+    this->_size = off;
+    this->_elements -= len;
+}
+
+void onestring_view::swap(onestring_view& view)
+{
+    std::swap(this->_bytes, view._bytes);
+    std::swap(this->_size, view._size);
+    std::swap(this->_elements, view._elements);
+}
+
+/*******************************************
+* Comparison
+********************************************/
+
+int onestring_view::compare(const onestring_view& view) const
+{
+    // See onestring::compare(const onestring&)
+    if (this->_elements != view._elements)
+    {
+        return (this->_elements < view._elements) ? -1 : 1;
+    }
+    return memcmp(this->_bytes, view._bytes,
+                  (view._size < this->_size) ? view._size : this->_size);
+}
+
+bool onestring_view::equals(const onestring_view& view) const
+{
+    return (view._size == this->_size &&
+            memcmp(this->_bytes, view._bytes, this->_size) == 0);
+}
+
+int onestring_view::icompare(const onestring_view& view) const
+{
+    // See compare()
+    if (this->_elements != view._elements)
+    {
+        return (this->_elements < view._elements) ? -1 : 1;
+    }
+    return onestring::fold_compare(this->_bytes, this->_size, view._bytes, view._size);
+}
+
+bool onestring_view::iequals(const onestring_view& view) const
+{
+    // Folding never changes the length of a character.
+    return (view._size == this->_size &&
+            onestring::fold_compare(this->_bytes, this->_size, view._bytes, view._size) == 0);
+}
+
+/*******************************************
+* Search
+********************************************/
+
+size_t onestring_view::find(const onestring_view& view, size_t pos) const
+{
+    if (pos > this->_elements) { return npos; }
+
+    // An empty substring is found immediately.
+    if (view._size == 0) { return pos; }
+
+    size_t start = offset_of(pos);
+    const char* found = onestring::search(this->_bytes + start, this->_size - start,
+                                          view._bytes, view._size);
+    if (found == nullptr) { return npos; }
+    return pos + onestring::count_leads(this->_bytes + start, found - (this->_bytes + start));
+}
+
+size_t onestring_view::rfind(const onestring_view& view, size_t pos) const
+{
+    if (pos > this->_elements) { pos = this->_elements; }
+
+    // An empty substring is found immediately.
+    if (view._size == 0) { return pos; }
+
+    // Only search as far as a match starting at pos could reach.
+    size_t end = offset_of(pos) + view._size;
+    if (end > this->_size) { end = this->_size; }
+
+    const char* found = onestring::rsearch(this->_bytes, end, view._bytes, view._size);
+    if (found == nullptr) { return npos; }
+    return onestring::count_leads(this->_bytes, found - this->_bytes);
+}
+
+size_t onestring_view::find_of(const onestring_view& set, size_t pos, bool match) const
+{
+    if (pos >= this->_elements) { return npos; }
+
+    // See onestring::find_of()
+    bool marked[256] = {false};
+    bool ascii = (set._size == set._elements);
+    for (size_t i = 0; i < set._size; ++i)
+    {
+        marked[static_cast<unsigned char>(set._bytes[i])] = true;
+    }
+
+    size_t off = offset_of(pos);
+    while (off < this->_size)
+    {
+        size_t len = onechar::evaluateLength(this->_bytes + off);
+        bool found = marked[static_cast<unsigned char>(this->_bytes[off])] &&
+                     (ascii || onestring::in_set(set._bytes, set._size, this->_bytes + off, len));
+        if (found == match) { return pos; }
+        off += len;
+        ++pos;
+    }
+    return npos;
+}
+
+size_t onestring_view::rfind_of(const onestring_view& set, size_t pos, bool match) const
+{
+    if (this->_elements == 0) { return npos; }
+    if (pos >= this->_elements) { pos = this->_elements - 1; }
+
+    // See onestring::find_of()
+    bool marked[256] = {false};
+    bool ascii = (set._size == set._elements);
+    for (size_t i = 0; i < set._size; ++i)
+    {
+        marked[static_cast<unsigned char>(set._bytes[i])] = true;
+    }
+
+    // Work backwards from the end of the character at pos.
+    size_t end = offset_of(pos + 1);
+    while (end > 0)
+    {
+        // Step back over the continuation bytes to the start of the character.
+        size_t off = end - 1;
+        while (off > 0 && (this->_bytes[off] & 0xC0) == 0x80) { --off; }
+
+        bool found = marked[static_cast<unsigned char>(this->_bytes[off])] &&
+                     (ascii || onestring::in_set(set._bytes, set._size, this->_bytes + off, end - off));
+        if (found == match) { return pos; }
+        end = off;
+        --pos;
+    }
+    return npos;
+}
+
+size_t onestring_view::find_first_of(const onestring_view& view, size_t pos) const
+{
+    return find_of(view, pos, true);
+}
+
+size_t onestring_view::find_first_not_of(const onestring_view& view, size_t pos) const
+{
+    return find_of(view, pos, false);
+}
+
+size_t onestring_view::find_last_of(const onestring_view& view, size_t pos) const
+{
+    return rfind_of(view, pos, true);
+}
+
+size_t onestring_view::find_last_not_of(const onestring_view& view, size_t pos) const
+{
+    return rfind_of(view, pos, false);
+}
+
+size_t onestring_view::count(const onestring_view& view) const
+{
+    if (view._size == 0) { return 0; }
+
+    size_t total = 0;
+    const char* hay = this->_bytes;
+    const char* hay_end = this->_bytes + this->_size;
+    const char* found;
+    while ((found = onestring::search(hay, hay_end - hay, view._bytes, view._size)) != nullptr)
+    {
+        ++total;
+        // Continue after the match, so matches never overlap.
+        hay = found + view._size;
+    }
+    return total;
+}
+
+bool onestring_view::contains(const onestring_view& view) const
+{
+    return (view._size == 0 ||
+            onestring::search(this->_bytes, this->_size, view._bytes, view._size) != nullptr);
+}
+
+bool onestring_view::starts_with(const onestring_view& view) const
+{
+    return onestring::has_prefix(this->_bytes, this->_size, view._bytes, view._size);
+}
+
+bool onestring_view::ends_with(const onestring_view& view) const
+{
+    return onestring::has_suffix(this->_bytes, this->_size, view._bytes, view._size);
+}
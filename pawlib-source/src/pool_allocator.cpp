@@ -0,0 +1,65 @@
+#include "pawlib/pool_allocator.hpp"
+
+BlockPool::BlockPool(size_t block_size, uint32_t blocks, bool grow)
+:_block_size(block_size), _capacity(0), _grow(grow),
+ free_list(nullptr), chunks(nullptr)
+{
+    // Every block must be able to hold a free list pointer.
+    if(_block_size < sizeof(free_block))
+    {
+        _block_size = sizeof(free_block);
+    }
+
+    // Round the block size up to maintain alignment.
+    const size_t align = alignof(std::max_align_t);
+    _block_size = ((_block_size + align - 1) / align) * align;
+
+    // We dynamically allocate all the requested space up front.
+    if(blocks > 0)
+    {
+        add_chunk(blocks);
+    }
+}
+
+void BlockPool::add_chunk(uint32_t blocks)
+{
+    // Make sure we won't overflow our block count.
+    if(blocks > INVALID_INDEX - 1 - _capacity)
+    {
+        blocks = INVALID_INDEX - 1 - _capacity;
+        if(blocks == 0)
+        {
+            throw e_pool_full();
+        }
+    }
+
+    char* memory = static_cast<char*>(::operator new(HEADER_SIZE + (_block_size * blocks)));
+
+    // Link the chunk into our list of chunks.
+    chunk_header* chunk = reinterpret_cast<chunk_header*>(memory);
+    chunk->prev = chunks;
+    chunks = chunk;
+
+    /* Thread the new blocks onto the free list, working backwards so
+     * they'll be handed out in memory order. */
+    char* first = memory + HEADER_SIZE;
+    for(uint32_t i = blocks; i > 0; --i)
+    {
+        free_block* block = reinterpret_cast<free_block*>(first + (_block_size * (i - 1)));
+        block->next = free_list;
+        free_list = block;
+    }
+
+    _capacity += blocks;
+}
+
+BlockPool::~BlockPool()
+{
+    // Release every chunk.
+    while(chunks != nullptr)
+    {
+        chunk_header* prev = chunks->prev;
+        ::operator delete(chunks);
+        chunks = prev;
+    }
+}
@@ -32,4 +32,41 @@ void TestSuite_Pool::load_tests()
         new TestPool_Exception(TestPool_Exception::FailTestType::POOL_DES_DELETED_REF));
     register_test("P-tB160D",
         new TestPool_Exception(TestPool_Exception::FailTestType::POOL_DES_FOREIGN_REF));
+
+    register_test("P-tB160E",
+        new TestPool_CreateN(false));
+    register_test("P-tB160F",
+        new TestPool_CreateN(true));
+    register_test("P-tB1610",
+        new TestPool_DestroyN());
+    register_test("P-tB1611",
+        new TestPool_ForEachLive(), true, new TestPool_AccessEach());
+
+    register_test("P-tB1612",
+        new TestPool_BlockPool(true));
+    register_test("P-tB1613",
+        new TestPool_BlockPool(false));
+    register_test("P-tB1614",
+        new TestPool_AllocatorContainers());
+    register_test("P-tB1615",
+        new TestPool_ListPoolAllocator(), true, new TestPool_ListStdAllocator());
+    register_test("P-tB1616",
+        new TestPool_Stats());
+    register_test("P-tB1617",
+        new TestPool_Compact());
+    register_test("P-tB1618",
+        new TestPool_Shrink());
+
+    register_test("P-tB1619",
+        new TestPool_PaddedLayout());
+    register_test("P-tB161A",
+        new TestPool_LayoutIterate<false>(), true, new TestPool_LayoutIterate<true>());
+    register_test("P-tB161B",
+        new TestPool_LayoutThreaded<true>(), true, new TestPool_LayoutThreaded<false>());
+    register_test("P-tB161C",
+        new TestPool_CompactStrings());
+    register_test("P-tB161D",
+        new TestPool_AllocatorThreaded());
+    register_test("P-tB161E",
+        new TestPool_AllocatorOverAligned());
 }